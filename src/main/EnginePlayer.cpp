@@ -42,10 +42,17 @@
 #include "graphics/Image.h"
 #include "graphics/Texture.h"
 #include "graphics/Font.h"
+#include "graphics/FontFontStash.h"
 #include "graphics/TextureOpenGl.h"
 #include "graphics/Fbo.h"
+#include "graphics/FboPool.h"
+#include "graphics/DynamicResolution.h"
+#include "graphics/ClusteredLighting.h"
+#include "graphics/RenderQueue.h"
 #include "graphics/model/TexturedQuad.h"
 #include "graphics/model/Model.h"
+#include "graphics/model/ModelLoader.h"
+#include "graphics/video/VideoDecodeScheduler.h"
 #include "graphics/video/VideoFile.h"
 #include "graphics/Shadow.h"
 
@@ -1699,10 +1706,18 @@ bool EnginePlayer::init() {
     script->load();
     script = scriptMemory.getResource(std::string("_embedded/Fbo.js"), true);
     script->load();
+    script = scriptMemory.getResource(std::string("_embedded/RenderGraph.js"), true);
+    script->load();
+    script = scriptMemory.getResource(std::string("_embedded/RenderQueue.js"), true);
+    script->load();
+    script = scriptMemory.getResource(std::string("_embedded/InstanceBuffer.js"), true);
+    script->load();
     script = scriptMemory.getResource(std::string("_embedded/Model.js"), true);
     script->load();
     script = scriptMemory.getResource(std::string("_embedded/Mesh.js"), true);
     script->load();
+    script = scriptMemory.getResource(std::string("_embedded/ParticleSystem.js"), true);
+    script->load();
     script = scriptMemory.getResource(std::string("_embedded/CatmullRomSpline.js"), true);
     script->load();
     script = scriptMemory.getResource(std::string("_embedded/Light.js"), true);
@@ -1823,6 +1838,7 @@ bool EnginePlayer::init() {
 
     MemoryManager<Fbo>& fboMemory = MemoryManager<Fbo>::getInstance();
     mainOutputFbo = fboMemory.getResource(std::string("mainOutputFbo"), true);
+    mainOutputFbo->setDynamicScale(true);
     if (!mainOutputFbo->generate()) {
         loggerFatal("Failed initializing mainOutputFbo");
         return false;
@@ -1874,6 +1890,18 @@ bool EnginePlayer::load() {
     loggerDebug("Loading script '%s'", script->getFilePath().c_str());
     script->load();
 
+    // models are imported in background, keep the progress bar alive until they are uploaded
+    ModelLoader& modelLoader = ModelLoader::getInstance();
+    while (modelLoader.isLoading() && !input->isUserExit()) {
+        modelLoader.process();
+        script->evalString("processFutures()");
+        input->pollEvents();
+        // draw the progress bar also when the timer is paused, e.g. reload in editor
+        forceRedraw();
+        mainScreenDraw();
+        SystemTime::sleepInMillis(10);
+    }
+
     if (graphics->handleErrors()) {
         loggerWarning("Graphics handling error occurred in loading phase");
     }
@@ -1997,6 +2025,12 @@ void EnginePlayer::processFrame() {
 
     input->pollEvents();
 
+    ModelLoader::getInstance().process();
+
+    VideoDecodeScheduler::getInstance().process(timer.isPause());
+
+    DynamicResolution::getInstance().process();
+
     if (fileRefreshManager->isModified()) {
         setLoggerPrintState("RELOAD");
 
@@ -2081,6 +2115,11 @@ void EnginePlayer::mainScreenDraw() {
         graphics->clear();
 
 
+        DynamicResolution& dynamicResolution = DynamicResolution::getInstance();
+        dynamicResolution.begin();
+
+        ClusteredLighting::getInstance().beginFrame();
+
         // TODO: A bit of a logic snafu: lights might not be defined in first render pass... need to get state of lights first
         bool shadows = false;
         LightManager& lightManager = LightManager::getInstance();
@@ -2096,6 +2135,7 @@ void EnginePlayer::mainScreenDraw() {
                     setLoggerPrintState("SHADOW RENDER");
                     // TODO: draw function should be limited only to stuff that generates shadows
                     drawFunction();
+                    RenderQueue::getInstance().end();
                     if (graphics->handleErrors()) {
                         loggerWarning("Graphics error occurred in shadow render pass");
                     }
@@ -2115,6 +2155,8 @@ void EnginePlayer::mainScreenDraw() {
         }
 
         drawFunction();
+        // submit draws left queued by an interrupted script
+        RenderQueue::getInstance().end();
 
         if (shadows) {
             shadow->textureUnbind();
@@ -2125,6 +2167,7 @@ void EnginePlayer::mainScreenDraw() {
         }
         setLoggerPrintState("RUN");
         mainOutputFbo->end();
+        dynamicResolution.end();
     if (graphics->handleErrors()) {
         loggerWarning("Graphics error occurred in main screen draw1");
     }
@@ -2135,7 +2178,7 @@ void EnginePlayer::mainScreenDraw() {
     }
     }
 
-    if (graphics->handleErrors()) {
+    if (graphics->handleFrameErrors()) {
         loggerWarning("Graphics error occurred in main screen draw");
     }
 
@@ -2197,20 +2240,32 @@ bool EnginePlayer::exit() {
 
     networkManager->exit();
 
+    ModelLoader::getInstance().clear();
+
     MemoryManager<Script>::getInstance().clear();
 
     ScriptEngine::getInstance().exit();
 
     MemoryManager<Fbo>::getInstance().clear();
 
+    FboPool::getInstance().clear();
+
+    DynamicResolution::getInstance().clear();
+
+    ClusteredLighting::getInstance().clear();
+
     MemoryManager<Image>::getInstance().clear();
 
     MemoryManager<VideoFile>::getInstance().clear();
 
+    VideoDecodeScheduler::getInstance().clear();
+
     MemoryManager<Model>::getInstance().clear();
 
     MemoryManager<Font>::getInstance().clear();
 
+    FontAtlasPool::getInstance().clear();
+
     if (shadow) {
         delete shadow;
     }
@@ -294,6 +294,10 @@ static void to_json(nlohmann::json& j, const ModelSettings& model) {
     j["fixInvalidData"] = model.fixInvalidData;
     j["optimizeMeshes"] = model.optimizeMeshes;
     j["optimizeGraph"] = model.optimizeGraph;
+    j["cache"] = model.cache;
+    j["cacheDirectory"] = model.cacheDirectory;
+    j["uploadTimeBudget"] = model.uploadTimeBudget;
+    j["importWorkers"] = model.importWorkers;
 }
 
 static void from_json(const nlohmann::json& j, ModelSettings& model) {
@@ -305,12 +309,64 @@ static void from_json(const nlohmann::json& j, ModelSettings& model) {
     JSON_UNMARSHAL_VAR(model, bool, fixInvalidData);
     JSON_UNMARSHAL_VAR(model, bool, optimizeMeshes);
     JSON_UNMARSHAL_VAR(model, bool, optimizeGraph);
+    JSON_UNMARSHAL_VAR(model, bool, cache);
+    JSON_UNMARSHAL_VAR(model, std::string, cacheDirectory);
+    JSON_UNMARSHAL_VAR(model, int, uploadTimeBudget);
+    JSON_UNMARSHAL_VAR(model, unsigned int, importWorkers);
+}
+
+static void to_json(nlohmann::json& j, const VideoSettings& video) {
+    j = nlohmann::json::object();
+    j["decodeAheadFrames"] = video.decodeAheadFrames;
+    j["frameCacheSize"] = video.frameCacheSize;
+    j["decodeWorkers"] = video.decodeWorkers;
+}
+
+static void from_json(const nlohmann::json& j, VideoSettings& video) {
+    JSON_UNMARSHAL_VAR(video, unsigned int, decodeAheadFrames);
+    JSON_UNMARSHAL_VAR(video, unsigned int, frameCacheSize);
+    JSON_UNMARSHAL_VAR(video, unsigned int, decodeWorkers);
+}
+
+static void to_json(nlohmann::json& j, const DynamicResolutionSettings& dynamicResolution) {
+    j = nlohmann::json::object();
+    j["enable"] = dynamicResolution.enable;
+    j["minScale"] = dynamicResolution.minScale;
+    j["maxScale"] = dynamicResolution.maxScale;
+    j["targetFrameTime"] = dynamicResolution.targetFrameTime;
+}
+
+static void from_json(const nlohmann::json& j, DynamicResolutionSettings& dynamicResolution) {
+    JSON_UNMARSHAL_VAR(dynamicResolution, bool, enable);
+    JSON_UNMARSHAL_VAR(dynamicResolution, double, minScale);
+    JSON_UNMARSHAL_VAR(dynamicResolution, double, maxScale);
+    JSON_UNMARSHAL_VAR(dynamicResolution, double, targetFrameTime);
+}
+
+static void to_json(nlohmann::json& j, const ClusteredLightingSettings& clusteredLighting) {
+    j = nlohmann::json::object();
+    j["tilesX"] = clusteredLighting.tilesX;
+    j["tilesY"] = clusteredLighting.tilesY;
+    j["depthSlices"] = clusteredLighting.depthSlices;
+    j["maxLightsPerCluster"] = clusteredLighting.maxLightsPerCluster;
+    j["defaultShader"] = clusteredLighting.defaultShader;
+}
+
+static void from_json(const nlohmann::json& j, ClusteredLightingSettings& clusteredLighting) {
+    JSON_UNMARSHAL_VAR(clusteredLighting, unsigned int, tilesX);
+    JSON_UNMARSHAL_VAR(clusteredLighting, unsigned int, tilesY);
+    JSON_UNMARSHAL_VAR(clusteredLighting, unsigned int, depthSlices);
+    JSON_UNMARSHAL_VAR(clusteredLighting, unsigned int, maxLightsPerCluster);
+    JSON_UNMARSHAL_VAR(clusteredLighting, bool, defaultShader);
 }
 
 static void to_json(nlohmann::json& j, const GraphicsSettings& graphics) {
     j = nlohmann::json::object();
     j["displayModes"] = graphics.displayModes;
     j["model"] = graphics.model;
+    j["video"] = graphics.video;
+    j["dynamicResolution"] = graphics.dynamicResolution;
+    j["clusteredLighting"] = graphics.clusteredLighting;
     j["clearColor"] = graphics.clearColor;
     j["canvasHeight"] = graphics.canvasHeight;
     j["canvasWidth"] = graphics.canvasWidth;
@@ -322,9 +378,14 @@ static void to_json(nlohmann::json& j, const GraphicsSettings& graphics) {
     j["defaultTextureFilter"] = graphics.defaultTextureFilter;
     j["defaultTextureWrap"] = graphics.defaultTextureWrap;
     j["defaultTextureFormat"] = graphics.defaultTextureFormat;
+    j["defaultTextureMipmap"] = graphics.defaultTextureMipmap;
+    j["srgbImages"] = graphics.srgbImages;
 
     j["defaultFboTextureFilter"] = graphics.defaultFboTextureFilter;
     j["defaultFboTextureWrap"] = graphics.defaultFboTextureWrap;
+    j["defaultFboTextureMipmap"] = graphics.defaultFboTextureMipmap;
+
+    j["renderPassCulling"] = graphics.renderPassCulling;
 
     j["shaderProgramDefault"] = graphics.shaderProgramDefault;
     j["shaderProgramDefaultShadow"] = graphics.shaderProgramDefaultShadow;
@@ -341,6 +402,9 @@ static void from_json(const nlohmann::json& j, GraphicsSettings& graphics) {
     JSON_UNMARSHAL_VAR(graphics, std::vector<DisplayMode>, displayModes);
 
     JSON_UNMARSHAL_VAR(graphics, ModelSettings, model);
+    JSON_UNMARSHAL_VAR(graphics, VideoSettings, video);
+    JSON_UNMARSHAL_VAR(graphics, DynamicResolutionSettings, dynamicResolution);
+    JSON_UNMARSHAL_VAR(graphics, ClusteredLightingSettings, clusteredLighting);
 
     JSON_UNMARSHAL_VAR(graphics, Color, clearColor);
     Graphics::getInstance().setClearColor(graphics.clearColor);
@@ -354,9 +418,14 @@ static void from_json(const nlohmann::json& j, GraphicsSettings& graphics) {
     JSON_UNMARSHAL_ENUM(graphics, TextureFilter, defaultTextureFilter);
     JSON_UNMARSHAL_ENUM(graphics, TextureWrap, defaultTextureWrap);
     JSON_UNMARSHAL_ENUM(graphics, TextureFormat, defaultTextureFormat);
+    JSON_UNMARSHAL_ENUM(graphics, TextureMipmap, defaultTextureMipmap);
+    JSON_UNMARSHAL_VAR(graphics, bool, srgbImages);
 
     JSON_UNMARSHAL_ENUM(graphics, TextureFilter, defaultFboTextureFilter);
     JSON_UNMARSHAL_ENUM(graphics, TextureWrap, defaultFboTextureWrap);
+    JSON_UNMARSHAL_ENUM(graphics, TextureMipmap, defaultFboTextureMipmap);
+
+    JSON_UNMARSHAL_VAR(graphics, bool, renderPassCulling);
 
     JSON_UNMARSHAL_VAR(graphics, std::string, shaderProgramDefault);
     JSON_UNMARSHAL_VAR(graphics, std::string, shaderProgramDefaultShadow);
@@ -562,6 +631,43 @@ ModelSettings::ModelSettings() {
     fixInvalidData = true;
     optimizeMeshes = false;
     optimizeGraph = false;
+    // post-processed models are cached in binary form, keyed by file hash and import flags.
+    // opt-in as it writes files, relative directory is under the project path
+    cache = false;
+    cacheDirectory = ".cache/";
+    // milliseconds per frame used for uploading asynchronously loaded models to GPU
+    uploadTimeBudget = 4;
+    // amount of threads importing models simultaneously
+    importWorkers = 2;
+}
+
+VideoSettings::VideoSettings() {
+    // amount of decoded frames buffered ahead of the playback position
+    decodeAheadFrames = 8;
+    // megabytes of decoded frames cached per video for looping and scrubbing, 0 disables caching
+    frameCacheSize = 0;
+    // amount of videos decoded simultaneously, 0 uses one less than the amount of CPU cores
+    decodeWorkers = 2;
+}
+
+DynamicResolutionSettings::DynamicResolutionSettings() {
+    enable = false;
+    // render scale bounds in relation to the screen size
+    minScale = 0.5;
+    maxScale = 1.0;
+    // GPU frame time in milliseconds that the render scale is adjusted towards
+    targetFrameTime = 16.0;
+}
+
+ClusteredLightingSettings::ClusteredLightingSettings() {
+    // screen-space tiles and exponential depth slices of the view frustum
+    tilesX = 16;
+    tilesY = 9;
+    depthSlices = 24;
+    // lights exceeding the limit are dropped from the cluster, lowest light indices are kept
+    maxLightsPerCluster = 64;
+    // lighting of the built-in default shader is opt-in, so existing unlit scenes look the same
+    defaultShader = false;
 }
 
 GraphicsSettings::GraphicsSettings() : clearColor(0, 0, 0, 0) {
@@ -581,9 +687,17 @@ GraphicsSettings::GraphicsSettings() : clearColor(0, 0, 0, 0) {
     defaultTextureFilter = TextureFilter::MIPMAP;
     defaultTextureWrap = TextureWrap::CLAMP_TO_EDGE;
     defaultTextureFormat = TextureFormat::RGBA;
+    defaultTextureMipmap = TextureMipmap::GENERATE;
+    // images are sampled as linear data unless the rendering pipeline is sRGB aware
+    srgbImages = false;
 
     defaultFboTextureFilter = TextureFilter::MIPMAP;
     defaultFboTextureWrap = TextureWrap::CLAMP_TO_EDGE;
+    // FBO contents change every frame, FBOs opt in to mipmap generation with the "mipmap" property
+    defaultFboTextureMipmap = TextureMipmap::NONE;
+
+    // FBOs named anywhere in the animation definitions are treated as read, only FBOs read from JavaScript code need "cull": false
+    renderPassCulling = true;
 
     shaderProgramDefault = "Default";
     shaderProgramDefaultShadow = "DefaultPlain";
@@ -95,6 +95,34 @@ struct ModelSettings {
     bool fixInvalidData;
     bool optimizeMeshes;
     bool optimizeGraph;
+    bool cache;
+    std::string cacheDirectory;
+    int uploadTimeBudget;
+    unsigned int importWorkers;
+};
+
+struct VideoSettings {
+    VideoSettings();
+    unsigned int decodeAheadFrames;
+    unsigned int frameCacheSize;
+    unsigned int decodeWorkers;
+};
+
+struct DynamicResolutionSettings {
+    DynamicResolutionSettings();
+    bool enable;
+    double minScale;
+    double maxScale;
+    double targetFrameTime;
+};
+
+struct ClusteredLightingSettings {
+    ClusteredLightingSettings();
+    unsigned int tilesX;
+    unsigned int tilesY;
+    unsigned int depthSlices;
+    unsigned int maxLightsPerCluster;
+    bool defaultShader;
 };
 
 struct GraphicsSettings {
@@ -104,6 +132,9 @@ struct GraphicsSettings {
     std::string shaderProgramDefaultShadow;
 
     ModelSettings model;
+    VideoSettings video;
+    DynamicResolutionSettings dynamicResolution;
+    ClusteredLightingSettings clusteredLighting;
 
     std::vector<DisplayMode> displayModes;
 
@@ -115,9 +146,14 @@ struct GraphicsSettings {
     TextureFilter defaultTextureFilter;
     TextureWrap defaultTextureWrap;
     TextureFormat defaultTextureFormat;
+    TextureMipmap defaultTextureMipmap;
+    bool srgbImages;
 
     TextureFilter defaultFboTextureFilter;
     TextureWrap defaultFboTextureWrap;
+    TextureMipmap defaultFboTextureMipmap;
+
+    bool renderPassCulling;
 
     float canvasHeight;
     float canvasWidth;
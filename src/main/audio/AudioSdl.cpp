@@ -199,6 +199,7 @@ void fftTextureInit() {
         fftTexture->setFormat(TextureFormat::RED);
         fftTexture->setDataType(TextureDataType::FLOAT);
         fftTexture->setTargetType(TextureTargetType::TEXTURE_2D);
+        fftTexture->setMipmap(TextureMipmap::NONE);
         if (fftTexture->create(Settings::demo.fft.size, Settings::demo.fft.history)) {
             loggerDebug("FFT texture created");
         }
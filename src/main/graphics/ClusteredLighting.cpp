@@ -0,0 +1,364 @@
+#include "ClusteredLighting.h"
+
+#include "Settings.h"
+#include "graphics/Light.h"
+#include "graphics/LightManager.h"
+#include "math/TransformationMatrix.h"
+#include "logger/logger.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/type_ptr.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string.h>
+#include <type_traits>
+
+// exponential depth slicing needs a positive near plane, also used for orthographic projections
+#define CLUSTERED_LIGHTING_MIN_DEPTH 0.01f
+
+struct ClusterBounds {
+    unsigned int lightIndex;
+    unsigned int minX, maxX;
+    unsigned int minY, maxY;
+    unsigned int minZ, maxZ;
+};
+
+static unsigned int getTile(float ndc, unsigned int tiles) {
+    float tile = (ndc * 0.5f + 0.5f) * static_cast<float>(tiles);
+    if (tile <= 0.0f) {
+        return 0;
+    }
+
+    return std::min(static_cast<unsigned int>(tile), tiles - 1);
+}
+
+ClusteredLighting& ClusteredLighting::getInstance() {
+    static ClusteredLighting clusteredLighting;
+    return clusteredLighting;
+}
+
+ClusteredLighting::ClusteredLighting() {
+    lightBuffer = {0, 0};
+    gridBuffer = {0, 0};
+    indexBuffer = {0, 0};
+    initialized = false;
+    assigned = false;
+    frameChanged = true;
+
+    memset(projection, 0, sizeof(projection));
+    memset(view, 0, sizeof(view));
+    tilesX = 1;
+    tilesY = 1;
+    depthSlices = 1;
+    maxLightsPerCluster = 0;
+    depthNear = CLUSTERED_LIGHTING_MIN_DEPTH;
+    depthFar = 1.0f;
+}
+
+bool ClusteredLighting::createBufferTexture(BufferTexture& bufferTexture, GLenum format) {
+    glGenBuffers(1, &bufferTexture.buffer);
+    glGenTextures(1, &bufferTexture.texture);
+    if (bufferTexture.buffer == 0 || bufferTexture.texture == 0) {
+        deleteBufferTexture(bufferTexture);
+        return false;
+    }
+
+    uploadBufferTexture(bufferTexture, NULL, 0);
+
+    glBindTexture(GL_TEXTURE_BUFFER, bufferTexture.texture);
+    glTexBuffer(GL_TEXTURE_BUFFER, format, bufferTexture.buffer);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+
+    return true;
+}
+
+void ClusteredLighting::deleteBufferTexture(BufferTexture& bufferTexture) {
+    if (bufferTexture.texture != 0) {
+        glDeleteTextures(1, &bufferTexture.texture);
+    }
+
+    if (bufferTexture.buffer != 0) {
+        glDeleteBuffers(1, &bufferTexture.buffer);
+    }
+
+    bufferTexture = {0, 0};
+}
+
+void ClusteredLighting::uploadBufferTexture(BufferTexture& bufferTexture, const void* data, size_t size) {
+    glBindBuffer(GL_TEXTURE_BUFFER, bufferTexture.buffer);
+    // buffer textures without data store are incomplete, so keep at least one texel allocated
+    if (size > 0) {
+        glBufferData(GL_TEXTURE_BUFFER, size, data, GL_DYNAMIC_DRAW);
+    } else {
+        glBufferData(GL_TEXTURE_BUFFER, 4 * sizeof(GLfloat), NULL, GL_DYNAMIC_DRAW);
+    }
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+bool ClusteredLighting::init() {
+    if (initialized) {
+        return true;
+    }
+
+    if (!createBufferTexture(lightBuffer, GL_RGBA32F)
+        || !createBufferTexture(gridBuffer, GL_RG32UI)
+        || !createBufferTexture(indexBuffer, GL_R32UI)) {
+        loggerError("Could not create clustered lighting buffer textures");
+        clear();
+        return false;
+    }
+
+    initialized = true;
+    return true;
+}
+
+void ClusteredLighting::clear() {
+    deleteBufferTexture(lightBuffer);
+    deleteBufferTexture(gridBuffer);
+    deleteBufferTexture(indexBuffer);
+
+    lightData.clear();
+    packedLightData.clear();
+    grid.clear();
+    lightIndices.clear();
+
+    initialized = false;
+    assigned = false;
+    frameChanged = true;
+}
+
+void ClusteredLighting::beginFrame() {
+    frameChanged = true;
+}
+
+unsigned int ClusteredLighting::getDepthSlice(float depth) {
+    if (depth <= depthNear) {
+        return 0;
+    }
+
+    float slice = std::log(depth / depthNear) / std::log(depthFar / depthNear) * static_cast<float>(depthSlices);
+    return std::min(static_cast<unsigned int>(slice), depthSlices - 1);
+}
+
+std::array<float, 4> ClusteredLighting::getDepthParameters() {
+    if (init()) {
+        update();
+    }
+
+    // GLSL: slice = int(log(viewDepth) * x + y)
+    float logDepthRange = std::log(depthFar / depthNear);
+    float scale = static_cast<float>(depthSlices) / logDepthRange;
+    float bias = -static_cast<float>(depthSlices) * std::log(depthNear) / logDepthRange;
+
+    return std::array<float, 4>{scale, bias, depthNear, depthFar};
+}
+
+void ClusteredLighting::update() {
+    const ClusteredLightingSettings& settings = Settings::demo.graphics.clusteredLighting;
+    TransformationMatrix& transformationMatrix = TransformationMatrix::getInstance();
+    const float* currentProjection = transformationMatrix.getProjectionMatrix();
+    const float* currentView = transformationMatrix.getViewMatrix();
+
+    // called from uniform binding of every draw, so unchanged camera within a frame returns early
+    bool cameraChanged = memcmp(projection, currentProjection, sizeof(projection)) != 0
+        || memcmp(view, currentView, sizeof(view)) != 0
+        || tilesX != std::max(settings.tilesX, 1u)
+        || tilesY != std::max(settings.tilesY, 1u)
+        || depthSlices != std::max(settings.depthSlices, 1u)
+        || maxLightsPerCluster != settings.maxLightsPerCluster;
+    if (assigned && !frameChanged && !cameraChanged) {
+        return;
+    }
+    frameChanged = false;
+
+    LightManager& lightManager = LightManager::getInstance();
+    unsigned int lightCount = lightManager.getActiveLightCount();
+    packedLightData.resize(lightCount * CLUSTERED_LIGHTING_LIGHT_FLOATS);
+    for (unsigned int i = 0; i < lightCount; i++) {
+        const Light& light = lightManager.getLight(i);
+        const Vector3& position = light.getPosition();
+        const Vector3& direction = light.getDirection();
+        const Color& ambient = light.getAmbient();
+        const Color& diffuse = light.getDiffuse();
+        const Color& specular = light.getSpecular();
+
+        float* texel = &packedLightData[i * CLUSTERED_LIGHTING_LIGHT_FLOATS];
+        texel[0] = static_cast<float>(position.x);
+        texel[1] = static_cast<float>(position.y);
+        texel[2] = static_cast<float>(position.z);
+        texel[3] = static_cast<float>(static_cast<std::underlying_type<LightType>::type>(light.getType()));
+        texel[4] = static_cast<float>(direction.x);
+        texel[5] = static_cast<float>(direction.y);
+        texel[6] = static_cast<float>(direction.z);
+        texel[7] = static_cast<float>(light.getRange());
+        texel[8] = static_cast<float>(ambient.r);
+        texel[9] = static_cast<float>(ambient.g);
+        texel[10] = static_cast<float>(ambient.b);
+        texel[11] = static_cast<float>(ambient.a);
+        texel[12] = static_cast<float>(diffuse.r);
+        texel[13] = static_cast<float>(diffuse.g);
+        texel[14] = static_cast<float>(diffuse.b);
+        texel[15] = static_cast<float>(diffuse.a);
+        texel[16] = static_cast<float>(specular.r);
+        texel[17] = static_cast<float>(specular.g);
+        texel[18] = static_cast<float>(specular.b);
+        texel[19] = static_cast<float>(specular.a);
+    }
+
+    bool lightsChanged = !assigned || packedLightData != lightData;
+    if (!lightsChanged && !cameraChanged) {
+        return;
+    }
+
+    PROFILER_BLOCK("ClusteredLighting::update");
+
+    memcpy(projection, currentProjection, sizeof(projection));
+    memcpy(view, currentView, sizeof(view));
+    tilesX = std::max(settings.tilesX, 1u);
+    tilesY = std::max(settings.tilesY, 1u);
+    depthSlices = std::max(settings.depthSlices, 1u);
+    maxLightsPerCluster = settings.maxLightsPerCluster;
+
+    if (lightsChanged) {
+        lightData.swap(packedLightData);
+        uploadBufferTexture(lightBuffer, lightData.data(), lightData.size() * sizeof(float));
+    }
+
+    assignLights();
+
+    uploadBufferTexture(gridBuffer, grid.data(), grid.size() * sizeof(GLuint));
+    uploadBufferTexture(indexBuffer, lightIndices.data(), lightIndices.size() * sizeof(GLuint));
+
+    assigned = true;
+}
+
+void ClusteredLighting::assignLights() {
+    glm::mat4 projectionMatrix = glm::make_mat4(projection);
+    glm::mat4 viewMatrix = glm::make_mat4(view);
+
+    // clip planes are solved from the projection matrix, so script defined projections are supported
+    bool perspective = projectionMatrix[2][3] != 0.0f;
+    float clipNear;
+    float clipFar;
+    if (perspective) {
+        clipNear = projectionMatrix[3][2] / (projectionMatrix[2][2] - 1.0f);
+        clipFar = projectionMatrix[3][2] / (projectionMatrix[2][2] + 1.0f);
+    } else {
+        clipNear = (projectionMatrix[3][2] + 1.0f) / projectionMatrix[2][2];
+        clipFar = (projectionMatrix[3][2] - 1.0f) / projectionMatrix[2][2];
+    }
+
+    depthNear = std::max(clipNear, CLUSTERED_LIGHTING_MIN_DEPTH);
+    depthFar = std::max(clipFar, depthNear * 2.0f);
+
+    unsigned int lightCount = static_cast<unsigned int>(lightData.size() / CLUSTERED_LIGHTING_LIGHT_FLOATS);
+    std::vector<ClusterBounds> lightBounds;
+    lightBounds.reserve(lightCount);
+    for (unsigned int i = 0; i < lightCount; i++) {
+        const float* texel = &lightData[i * CLUSTERED_LIGHTING_LIGHT_FLOATS];
+        LightType type = static_cast<LightType>(static_cast<int>(texel[3]));
+        float range = texel[7];
+
+        ClusterBounds bounds = {i, 0, tilesX - 1, 0, tilesY - 1, 0, depthSlices - 1};
+
+        // directional lights and lights without range affect every cluster.
+        // spot lights are bounded by their range sphere, cone is not taken into account.
+        if (type != LightType::DIRECTIONAL && range > 0.0f) {
+            glm::vec4 center = viewMatrix * glm::vec4(texel[0], texel[1], texel[2], 1.0f);
+            float depth = -center.z;
+            if (depth + range < clipNear || depth - range > clipFar) {
+                continue;
+            }
+
+            bounds.minZ = getDepthSlice(depth - range);
+            bounds.maxZ = getDepthSlice(depth + range);
+
+            // sphere crossing the near plane can't be projected reliably, so it covers whole screen
+            if (!perspective || depth - range > depthNear) {
+                float minX = std::numeric_limits<float>::max();
+                float minY = std::numeric_limits<float>::max();
+                float maxX = -std::numeric_limits<float>::max();
+                float maxY = -std::numeric_limits<float>::max();
+                for (unsigned int corner = 0; corner < 8; corner++) {
+                    glm::vec4 offset(
+                        (corner & 1) ? range : -range,
+                        (corner & 2) ? range : -range,
+                        (corner & 4) ? range : -range,
+                        0.0f);
+                    glm::vec4 clip = projectionMatrix * (center + offset);
+                    float x = clip.x / clip.w;
+                    float y = clip.y / clip.w;
+                    minX = std::min(minX, x);
+                    minY = std::min(minY, y);
+                    maxX = std::max(maxX, x);
+                    maxY = std::max(maxY, y);
+                }
+
+                if (maxX < -1.0f || minX > 1.0f || maxY < -1.0f || minY > 1.0f) {
+                    continue;
+                }
+
+                bounds.minX = getTile(minX, tilesX);
+                bounds.maxX = getTile(maxX, tilesX);
+                bounds.minY = getTile(minY, tilesY);
+                bounds.maxY = getTile(maxY, tilesY);
+            }
+        }
+
+        lightBounds.push_back(bounds);
+    }
+
+    // grid texel per cluster: (light index list offset, light count)
+    unsigned int clusterCount = tilesX * tilesY * depthSlices;
+    grid.assign(clusterCount * 2, 0);
+
+    for (int pass = 0; pass < 2; pass++) {
+        for (const ClusterBounds& bounds : lightBounds) {
+            for (unsigned int z = bounds.minZ; z <= bounds.maxZ; z++) {
+                for (unsigned int y = bounds.minY; y <= bounds.maxY; y++) {
+                    for (unsigned int x = bounds.minX; x <= bounds.maxX; x++) {
+                        unsigned int cluster = x + y * tilesX + z * tilesX * tilesY;
+                        GLuint& count = grid[cluster * 2 + 1];
+                        if (count >= maxLightsPerCluster) {
+                            continue;
+                        }
+
+                        if (pass == 1) {
+                            lightIndices[grid[cluster * 2] + count] = bounds.lightIndex;
+                        }
+                        count++;
+                    }
+                }
+            }
+        }
+
+        if (pass == 0) {
+            GLuint offset = 0;
+            for (unsigned int cluster = 0; cluster < clusterCount; cluster++) {
+                grid[cluster * 2] = offset;
+                offset += grid[cluster * 2 + 1];
+                grid[cluster * 2 + 1] = 0;
+            }
+
+            lightIndices.assign(offset, 0);
+        }
+    }
+}
+
+void ClusteredLighting::bind() {
+    if (!init()) {
+        return;
+    }
+
+    update();
+
+    glActiveTexture(GL_TEXTURE0 + CLUSTERED_LIGHTING_TEXTURE_UNIT_LIGHTS);
+    glBindTexture(GL_TEXTURE_BUFFER, lightBuffer.texture);
+    glActiveTexture(GL_TEXTURE0 + CLUSTERED_LIGHTING_TEXTURE_UNIT_GRID);
+    glBindTexture(GL_TEXTURE_BUFFER, gridBuffer.texture);
+    glActiveTexture(GL_TEXTURE0 + CLUSTERED_LIGHTING_TEXTURE_UNIT_INDICES);
+    glBindTexture(GL_TEXTURE_BUFFER, indexBuffer.texture);
+    glActiveTexture(GL_TEXTURE0);
+}
@@ -0,0 +1,70 @@
+#ifndef ENGINE_GRAPHICS_CLUSTEREDLIGHTING_H_
+#define ENGINE_GRAPHICS_CLUSTEREDLIGHTING_H_
+
+#include "GL/gl3w.h"
+
+#include <array>
+#include <vector>
+
+// RGBA32F texels per light: position & type, direction & range, ambient, diffuse, specular
+#define CLUSTERED_LIGHTING_LIGHT_TEXELS 5
+#define CLUSTERED_LIGHTING_LIGHT_FLOATS (CLUSTERED_LIGHTING_LIGHT_TEXELS * 4)
+
+// buffer textures are bound after the units used by regular textures and shadow maps
+#define CLUSTERED_LIGHTING_TEXTURE_UNIT_LIGHTS 13
+#define CLUSTERED_LIGHTING_TEXTURE_UNIT_GRID 14
+#define CLUSTERED_LIGHTING_TEXTURE_UNIT_INDICES 15
+
+/**
+ * Clustered forward lighting.
+ * The view frustum is split to screen-space tiles and exponential depth slices. Active lights are assigned
+ * to the clusters on CPU and uploaded to buffer textures, so shaders only iterate the lights of their cluster.
+ * Light data is read once per frame or when the camera changes, assignment is redone only when the
+ * camera matrices or the light data change.
+ */
+class ClusteredLighting {
+public:
+    static ClusteredLighting& getInstance();
+    ClusteredLighting();
+    void beginFrame();
+    void bind();
+    void clear();
+    std::array<float, 4> getDepthParameters();
+private:
+    bool init();
+    void update();
+    void assignLights();
+    unsigned int getDepthSlice(float depth);
+
+    struct BufferTexture {
+        GLuint buffer;
+        GLuint texture;
+    };
+
+    bool createBufferTexture(BufferTexture& bufferTexture, GLenum format);
+    void deleteBufferTexture(BufferTexture& bufferTexture);
+    void uploadBufferTexture(BufferTexture& bufferTexture, const void* data, size_t size);
+
+    BufferTexture lightBuffer;
+    BufferTexture gridBuffer;
+    BufferTexture indexBuffer;
+    bool initialized;
+    bool assigned;
+    bool frameChanged;
+
+    float projection[16];
+    float view[16];
+    unsigned int tilesX;
+    unsigned int tilesY;
+    unsigned int depthSlices;
+    unsigned int maxLightsPerCluster;
+    float depthNear;
+    float depthFar;
+
+    std::vector<float> lightData;
+    std::vector<float> packedLightData;
+    std::vector<GLuint> grid;
+    std::vector<GLuint> lightIndices;
+};
+
+#endif /*ENGINE_GRAPHICS_CLUSTEREDLIGHTING_H_*/
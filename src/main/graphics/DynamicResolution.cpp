@@ -0,0 +1,188 @@
+#include "DynamicResolution.h"
+
+#include "Fbo.h"
+#include "Settings.h"
+#include "io/MemoryManager.h"
+#include "logger/logger.h"
+
+#include <algorithm>
+#include <cmath>
+
+// scale changes are done in steps, as every change reallocates the render targets
+#define DYNAMIC_RESOLUTION_SCALE_STEP 0.05
+// amount of measured frames before the scale can be changed again
+#define DYNAMIC_RESOLUTION_SAMPLE_FRAMES 30
+// scale is raised only when the GPU frame time is below this share of the target
+#define DYNAMIC_RESOLUTION_HEADROOM 0.8
+#define DYNAMIC_RESOLUTION_SMOOTHING 0.1
+
+DynamicResolution& DynamicResolution::getInstance() {
+    static DynamicResolution dynamicResolution;
+    return dynamicResolution;
+}
+
+DynamicResolution::DynamicResolution() {
+    for (unsigned int i = 0; i < DYNAMIC_RESOLUTION_QUERIES; i++) {
+        queries[i] = 0;
+        queryPending[i] = false;
+    }
+
+    queryIndex = 0;
+    queryActive = false;
+    initialized = false;
+    scale = 1.0;
+    gpuFrameTime = 0.0;
+    sampleCount = 0;
+}
+
+bool DynamicResolution::init() {
+    if (initialized) {
+        return true;
+    }
+
+    glGenQueries(DYNAMIC_RESOLUTION_QUERIES, queries);
+    if (queries[0] == 0) {
+        loggerError("Could not create GPU timer queries, dynamic resolution disabled");
+        Settings::demo.graphics.dynamicResolution.enable = false;
+        return false;
+    }
+
+    initialized = true;
+    return true;
+}
+
+void DynamicResolution::begin() {
+    if (!Settings::demo.graphics.dynamicResolution.enable || !init()) {
+        return;
+    }
+
+    // all queries still in flight, skip measuring this frame
+    if (queryPending[queryIndex]) {
+        return;
+    }
+
+    glBeginQuery(GL_TIME_ELAPSED, queries[queryIndex]);
+    queryActive = true;
+}
+
+void DynamicResolution::end() {
+    if (!queryActive) {
+        return;
+    }
+
+    glEndQuery(GL_TIME_ELAPSED);
+    queryActive = false;
+    queryPending[queryIndex] = true;
+    queryIndex = (queryIndex + 1) % DYNAMIC_RESOLUTION_QUERIES;
+}
+
+void DynamicResolution::readQueries() {
+    for (unsigned int i = 0; i < DYNAMIC_RESOLUTION_QUERIES; i++) {
+        unsigned int index = (queryIndex + i) % DYNAMIC_RESOLUTION_QUERIES;
+        if (!queryPending[index]) {
+            continue;
+        }
+
+        GLint available = 0;
+        glGetQueryObjectiv(queries[index], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            // queries finish in order
+            break;
+        }
+
+        GLuint64 elapsed = 0;
+        glGetQueryObjectui64v(queries[index], GL_QUERY_RESULT, &elapsed);
+        queryPending[index] = false;
+
+        double frameTime = static_cast<double>(elapsed) / 1000000.0;
+        if (sampleCount == 0) {
+            gpuFrameTime = frameTime;
+        } else {
+            gpuFrameTime += (frameTime - gpuFrameTime) * DYNAMIC_RESOLUTION_SMOOTHING;
+        }
+        sampleCount++;
+    }
+}
+
+void DynamicResolution::process() {
+    PROFILER_BLOCK("DynamicResolution::process");
+
+    const DynamicResolutionSettings& settings = Settings::demo.graphics.dynamicResolution;
+    if (!initialized) {
+        return;
+    }
+
+    readQueries();
+
+    if (!settings.enable) {
+        if (scale != 1.0) {
+            setScale(1.0);
+        }
+        return;
+    }
+
+    if (sampleCount < DYNAMIC_RESOLUTION_SAMPLE_FRAMES || gpuFrameTime <= 0.0) {
+        return;
+    }
+
+    // rendering cost follows the pixel count, which is square of the scale
+    double newScale = scale;
+    double targetFrameTime = settings.targetFrameTime;
+    if (gpuFrameTime > targetFrameTime) {
+        newScale = scale * std::sqrt(targetFrameTime / gpuFrameTime);
+    } else if (gpuFrameTime < targetFrameTime * DYNAMIC_RESOLUTION_HEADROOM) {
+        newScale = std::min(scale + DYNAMIC_RESOLUTION_SCALE_STEP * 2, scale * std::sqrt(targetFrameTime * DYNAMIC_RESOLUTION_HEADROOM / gpuFrameTime));
+    }
+
+    newScale = std::round(newScale / DYNAMIC_RESOLUTION_SCALE_STEP) * DYNAMIC_RESOLUTION_SCALE_STEP;
+    newScale = std::max(settings.minScale, std::min(settings.maxScale, newScale));
+
+    if (std::fabs(newScale - scale) >= DYNAMIC_RESOLUTION_SCALE_STEP / 2) {
+        loggerDebug("Changing render scale. scale:%.2f, newScale:%.2f, gpuFrameTime:%.2f ms, targetFrameTime:%.2f ms",
+            scale, newScale, gpuFrameTime, targetFrameTime);
+        setScale(newScale);
+    }
+}
+
+void DynamicResolution::setScale(double scale) {
+    PROFILER_BLOCK("DynamicResolution::setScale");
+
+    this->scale = scale;
+
+    for (auto it : MemoryManager<Fbo>::getInstance().getResources()) {
+        Fbo *fbo = it.second;
+        if (fbo != NULL && fbo->getColorTexture() != NULL && !fbo->resize()) {
+            loggerError("Could not resize FBO. name:'%s', scale:%.2f", fbo->getName().c_str(), scale);
+        }
+    }
+
+    // measurements of the previous scale are not valid anymore
+    gpuFrameTime = 0.0;
+    sampleCount = 0;
+}
+
+void DynamicResolution::clear() {
+    if (initialized) {
+        glDeleteQueries(DYNAMIC_RESOLUTION_QUERIES, queries);
+    }
+
+    for (unsigned int i = 0; i < DYNAMIC_RESOLUTION_QUERIES; i++) {
+        queries[i] = 0;
+        queryPending[i] = false;
+    }
+
+    queryIndex = 0;
+    queryActive = false;
+    initialized = false;
+    scale = 1.0;
+    gpuFrameTime = 0.0;
+    sampleCount = 0;
+}
+
+double DynamicResolution::getScale() {
+    return scale;
+}
+
+double DynamicResolution::getGpuFrameTime() {
+    return gpuFrameTime;
+}
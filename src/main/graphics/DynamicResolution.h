@@ -0,0 +1,39 @@
+#ifndef ENGINE_GRAPHICS_DYNAMICRESOLUTION_H_
+#define ENGINE_GRAPHICS_DYNAMICRESOLUTION_H_
+
+#include "GL/gl3w.h"
+
+#define DYNAMIC_RESOLUTION_QUERIES 4
+
+/**
+ * Adjusts the render scale of the main output and script FBOs based on the measured GPU frame time.
+ * GPU time is measured with timer queries that are read frames later, so the CPU never waits for the GPU.
+ */
+class DynamicResolution {
+public:
+    static DynamicResolution& getInstance();
+    DynamicResolution();
+    void begin();
+    void end();
+    void process();
+    void clear();
+    double getScale();
+    double getGpuFrameTime();
+private:
+    bool init();
+    void readQueries();
+    void setScale(double scale);
+
+    GLuint queries[DYNAMIC_RESOLUTION_QUERIES];
+    bool queryPending[DYNAMIC_RESOLUTION_QUERIES];
+    unsigned int queryIndex;
+    bool queryActive;
+    bool initialized;
+
+    double scale;
+    // smoothed GPU frame time in milliseconds
+    double gpuFrameTime;
+    unsigned int sampleCount;
+};
+
+#endif /*ENGINE_GRAPHICS_DYNAMICRESOLUTION_H_*/
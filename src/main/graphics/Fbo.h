@@ -2,12 +2,16 @@
 #define ENGINE_GRAPHICS_FBO_H_
 
 #include "io/ManagedMemoryObject.h"
+#include "datatypes.h"
 #include <string>
 
 class Texture;
 
 /**
  * Frame Buffer Object (FBO) information
+ * Transient FBOs do not own render target memory. They acquire a pooled target when bound
+ * and give it back on release, so FBOs with non-overlapping scopes can share memory.
+ * FBO contents can be kept over several frames, see setUpdateInterval().
  */
 class Fbo : public ManagedMemoryObject {
 public:
@@ -17,12 +21,33 @@ public:
     virtual bool generate() = 0;
     virtual void free() = 0;
     virtual void bind() = 0;
-    virtual void unbind() = 0;
+    /**
+     * Without bindParent the parent framebuffer is not rebound, the caller binds another FBO right after
+     */
+    virtual void unbind(bool bindParent = true) = 0;
     virtual void start() = 0;
     virtual void end() = 0;
     virtual void setDimensions(unsigned int width, unsigned int height) = 0;
     virtual unsigned int getWidth() = 0;
     virtual unsigned int getHeight() = 0;
+    virtual void setColorFormat(TextureFormat colorFormat) = 0;
+    virtual void setStoreColor(bool storeColor) = 0;
+    virtual void setStoreDepth(bool storeDepth) = 0;
+    virtual void setTransient(bool transient) = 0;
+    virtual bool isTransient() = 0;
+    virtual void release() = 0;
+    virtual void setScale(double scale) = 0;
+    virtual double getScale() = 0;
+    virtual void setUpdateInterval(double updateInterval) = 0;
+    virtual bool isUpdateNeeded(double time) = 0;
+    virtual void setUpdated(double time) = 0;
+    virtual void invalidate() = 0;
+    virtual void setDynamicScale(bool dynamicScale) = 0;
+    /**
+     * Generate mipmaps of the FBO textures after each update. Must be set before generate().
+     */
+    virtual void setMipmap(bool mipmap) = 0;
+    virtual bool resize() = 0;
     virtual void textureBind() = 0;
     virtual void textureUnbind() = 0;
 
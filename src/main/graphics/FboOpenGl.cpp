@@ -1,9 +1,14 @@
 #include "FboOpenGl.h"
+#include "FboPool.h"
+#include "DynamicResolution.h"
+#include "RenderQueue.h"
 #include "Graphics.h"
 #include "TextureOpenGl.h"
 #include "Settings.h"
 #include "logger/logger.h"
 
+#include <algorithm>
+
 std::vector<FboOpenGl*> FboOpenGl::bindStack = {};
 
 Fbo* Fbo::newInstance(std::string name) {
@@ -35,6 +40,18 @@ FboOpenGl::FboOpenGl(std::string name) : Fbo(name) {
     depthBuffer = 0;
     colorTextureUnit = 0;
     depthTextureUnit = 1;
+    colorFormat = Settings::demo.graphics.defaultTextureFormat;
+    width = 0;
+    height = 0;
+    transient = false;
+    target = NULL;
+    scale = 1.0;
+    screenRelative = false;
+    dynamicScale = false;
+    mipmap = false;
+    updateInterval = 0.0;
+    updateTime = 0.0;
+    valid = false;
 }
 
 FboOpenGl::~FboOpenGl() {
@@ -42,10 +59,18 @@ FboOpenGl::~FboOpenGl() {
 }
 
 GLuint FboOpenGl::getId() {
+    if (target != NULL) {
+        return target->getId();
+    }
+
     return id;
 }
 
 GLuint FboOpenGl::getDepthBufferId() {
+    if (target != NULL) {
+        return target->getDepthBufferId();
+    }
+
     return depthBuffer;
 }
 
@@ -93,16 +118,47 @@ GLenum FboOpenGl::checkFramebufferStatus() {
     return e;
 }
 
+bool FboOpenGl::generateTransient() {
+    // only texture handles are created, GL memory comes from the pool when the FBO is bound
+    if (storeColor && color == NULL) {
+        color = Texture::newInstance();
+    }
+
+    if (storeDepth && depth == NULL) {
+        depth = Texture::newInstance();
+        depth->setFormat(TextureFormat::DEPTH_COMPONENT);
+    }
+
+    loggerInfo("Created transient FBO. name:'%s' dimensions:%ux%u, colorTexture:0x%p, depthTexture:0x%p",
+        getName().c_str(), getWidth(), getHeight(), color, depth);
+
+    return true;
+}
+
 bool FboOpenGl::generate() {
     PROFILER_BLOCK("FboOpenGl::generate");
 
-    setDimensions(Settings::window.screenAreaWidth, Settings::window.screenAreaHeight);
+    if (getWidth() == 0 || getHeight() == 0) {
+        screenRelative = true;
+    }
+
+    if (screenRelative) {
+        updateScreenDimensions();
+    }
+
+    invalidate();
+
+    if (transient) {
+        return generateTransient();
+    }
 
     if (storeColor) {
         if (color == NULL) {
             color = Texture::newInstance();
             color->setFilter(Settings::demo.graphics.defaultFboTextureFilter);
             color->setWrap(Settings::demo.graphics.defaultFboTextureWrap);
+            color->setMipmap(mipmap ? TextureMipmap::GENERATE : Settings::demo.graphics.defaultFboTextureMipmap);
+            color->setFormat(colorFormat);
 
             if (color->create(getWidth(), getHeight()) == false) {
                 loggerError("Could not create FBO color texture. name:'%s'", getName().c_str());
@@ -116,6 +172,7 @@ bool FboOpenGl::generate() {
             depth = Texture::newInstance();
             depth->setFilter(Settings::demo.graphics.defaultFboTextureFilter);
             depth->setWrap(Settings::demo.graphics.defaultFboTextureWrap);
+            depth->setMipmap(mipmap ? TextureMipmap::GENERATE : Settings::demo.graphics.defaultFboTextureMipmap);
             depth->setFormat(TextureFormat::DEPTH_COMPONENT);
 
             if (depth->create(getWidth(), getHeight()) == false) {
@@ -179,6 +236,8 @@ bool FboOpenGl::generate() {
 void FboOpenGl::free() {
     PROFILER_BLOCK("FboOpenGl::free");
 
+    release();
+
     if (color != NULL) {
         color->free();
         delete color;
@@ -212,16 +271,29 @@ void FboOpenGl::free() {
 void FboOpenGl::bind() {
     PROFILER_BLOCK("FboOpenGl::bind");
 
+    // queued draws belong to the previous render target
+    RenderQueue::getInstance().flush();
+
+    if (transient) {
+        acquire();
+    }
+
     bindStack.push_back(this);
 
-    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, id);
-    glBindFramebuffer(GL_READ_FRAMEBUFFER, id);
-    glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, getId());
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, getId());
+    glBindRenderbuffer(GL_RENDERBUFFER, getDepthBufferId());
+
+    if (isResized()) {
+        Graphics::getInstance().setViewport(0, 0, getWidth(), getHeight());
+    }
 }
 
-void FboOpenGl::unbind() {
+void FboOpenGl::unbind(bool bindParent) {
     PROFILER_BLOCK("FboOpenGl::unbind");
 
+    RenderQueue::getInstance().flush();
+
     if (bindStack.empty()) {
         loggerDebug("Can't unbind FBO, stack empty. name:'%s' id:%u, depthBuffer:%u, dimensions:%ux%u, colorTexture:0x%p, depthTexture:0x%p",
             getName().c_str(), id, depthBuffer, getWidth(), getHeight(), color, depth);
@@ -246,9 +318,23 @@ void FboOpenGl::unbind() {
         parentDepthBufferId = bindStack.back()->getDepthBufferId();
     }
 
-    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, parentId);
-    glBindFramebuffer(GL_READ_FRAMEBUFFER, parentId);
-    glBindRenderbuffer(GL_RENDERBUFFER, parentDepthBufferId);
+    // framebuffer switch to the parent is skipped when the next pass binds its own FBO, viewport is still restored
+    if (bindParent) {
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, parentId);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, parentId);
+        glBindRenderbuffer(GL_RENDERBUFFER, parentDepthBufferId);
+    }
+
+    if (isResized()) {
+        Graphics& graphics = Graphics::getInstance();
+        if (!bindStack.empty()) {
+            FboOpenGl *parent = bindStack.back();
+            graphics.setViewport(0, 0, parent->getWidth(), parent->getHeight());
+        } else {
+            // canvas viewport only applies to the default framebuffer
+            graphics.setViewport();
+        }
+    }
 }
 
 void FboOpenGl::setDimensions(unsigned int width, unsigned int height) {
@@ -264,6 +350,198 @@ unsigned int FboOpenGl::getHeight() {
     return height;
 }
 
+void FboOpenGl::updateScreenDimensions() {
+    double renderScale = scale;
+    if (dynamicScale) {
+        renderScale *= DynamicResolution::getInstance().getScale();
+    }
+
+    setDimensions(
+        std::max(1u, static_cast<unsigned int>(Settings::window.screenAreaWidth * renderScale)),
+        std::max(1u, static_cast<unsigned int>(Settings::window.screenAreaHeight * renderScale)));
+}
+
+void FboOpenGl::setDynamicScale(bool dynamicScale) {
+    this->dynamicScale = dynamicScale;
+}
+
+void FboOpenGl::setMipmap(bool mipmap) {
+    this->mipmap = mipmap;
+}
+
+bool FboOpenGl::resize() {
+    PROFILER_BLOCK("FboOpenGl::resize");
+
+    if (!screenRelative) {
+        return true;
+    }
+
+    unsigned int previousWidth = getWidth();
+    unsigned int previousHeight = getHeight();
+    updateScreenDimensions();
+    if (getWidth() == previousWidth && getHeight() == previousHeight) {
+        return true;
+    }
+
+    invalidate();
+
+    if (transient) {
+        // next acquire gets a pooled target with the new dimensions
+        release();
+        return true;
+    }
+
+    // texture objects are kept, so that references to them stay valid
+    if (color && !color->create(getWidth(), getHeight())) {
+        loggerError("Could not resize FBO color texture. name:'%s'", getName().c_str());
+        return false;
+    }
+
+    if (depth && !depth->create(getWidth(), getHeight())) {
+        loggerError("Could not resize FBO depth texture. name:'%s'", getName().c_str());
+        return false;
+    }
+
+    bind();
+
+    if (depthBuffer != 0) {
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT, getWidth(), getHeight());
+    }
+
+    if (color) {
+        glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, dynamic_cast<TextureOpenGl*>(color)->getId(), 0);
+    }
+
+    if (depth) {
+        glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, dynamic_cast<TextureOpenGl*>(depth)->getId(), 0);
+    }
+
+    GLenum e = checkFramebufferStatus();
+
+    unbind();
+
+    if (e != GL_FRAMEBUFFER_COMPLETE) {
+        return false;
+    }
+
+    loggerDebug("Resized FBO. name:'%s' id:%u dimensions:%ux%u", getName().c_str(), id, getWidth(), getHeight());
+
+    return true;
+}
+
+bool FboOpenGl::isResized() {
+    return getWidth() != Settings::window.screenAreaWidth || getHeight() != Settings::window.screenAreaHeight;
+}
+
+void FboOpenGl::setScale(double scale) {
+    if (scale <= 0.0 || scale > 1.0) {
+        loggerWarning("Invalid FBO scale, using 1.0. name:'%s', scale:%.2f", getName().c_str(), scale);
+        scale = 1.0;
+    }
+
+    this->scale = scale;
+}
+
+double FboOpenGl::getScale() {
+    return scale;
+}
+
+void FboOpenGl::setUpdateInterval(double updateInterval) {
+    this->updateInterval = updateInterval;
+}
+
+bool FboOpenGl::isUpdateNeeded(double time) {
+    // contents of transient FBOs do not survive the release
+    if (!valid || transient || updateInterval == 0.0) {
+        return true;
+    }
+
+    if (updateInterval < 0.0) {
+        return false;
+    }
+
+    // time can also go backwards when seeking
+    return time < updateTime || time - updateTime >= updateInterval;
+}
+
+void FboOpenGl::setUpdated(double time) {
+    valid = true;
+    updateTime = time;
+}
+
+void FboOpenGl::invalidate() {
+    valid = false;
+}
+
+void FboOpenGl::setColorFormat(TextureFormat colorFormat) {
+    this->colorFormat = colorFormat;
+}
+
+void FboOpenGl::setStoreColor(bool storeColor) {
+    this->storeColor = storeColor;
+}
+
+void FboOpenGl::setStoreDepth(bool storeDepth) {
+    this->storeDepth = storeDepth;
+}
+
+void FboOpenGl::setTransient(bool transient) {
+    if (color != NULL || depth != NULL || id != 0) {
+        if (this->transient != transient) {
+            loggerWarning("FBO already generated, transient state can't be changed. name:'%s', transient:%d", getName().c_str(), this->transient);
+        }
+        return;
+    }
+
+    this->transient = transient;
+}
+
+bool FboOpenGl::isTransient() {
+    return transient;
+}
+
+void FboOpenGl::acquire() {
+    if (!transient || target != NULL) {
+        return;
+    }
+
+    target = dynamic_cast<FboOpenGl*>(FboPool::getInstance().acquire(getWidth(), getHeight(), colorFormat, storeColor, storeDepth));
+    if (target == NULL) {
+        loggerError("Could not acquire transient FBO render target. name:'%s'", getName().c_str());
+        return;
+    }
+
+    if (color) {
+        dynamic_cast<TextureOpenGl*>(color)->setAlias(dynamic_cast<TextureOpenGl*>(target->getColorTexture()));
+    }
+    if (depth) {
+        dynamic_cast<TextureOpenGl*>(depth)->setAlias(dynamic_cast<TextureOpenGl*>(target->getDepthTexture()));
+    }
+}
+
+void FboOpenGl::release() {
+    if (target == NULL) {
+        return;
+    }
+
+    for (FboOpenGl *fbo : bindStack) {
+        if (fbo == this) {
+            loggerWarning("Can't release bound transient FBO. name:'%s'", getName().c_str());
+            return;
+        }
+    }
+
+    if (color) {
+        dynamic_cast<TextureOpenGl*>(color)->setAlias(NULL);
+    }
+    if (depth) {
+        dynamic_cast<TextureOpenGl*>(depth)->setAlias(NULL);
+    }
+
+    FboPool::getInstance().release(target);
+    target = NULL;
+}
+
 void FboOpenGl::start() {
     PROFILER_BLOCK("FboOpenGl::start");
 
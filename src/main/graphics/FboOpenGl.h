@@ -18,12 +18,28 @@ public:
     bool generate();
     void free();
     void bind();
-    void unbind();
+    void unbind(bool bindParent = true);
     void start();
     void end();
     void setDimensions(unsigned int width, unsigned int height);
     unsigned int getWidth();
     unsigned int getHeight();
+    void setColorFormat(TextureFormat colorFormat);
+    void setStoreColor(bool storeColor);
+    void setStoreDepth(bool storeDepth);
+    void setTransient(bool transient);
+    bool isTransient();
+    void acquire();
+    void release();
+    void setScale(double scale);
+    double getScale();
+    void setUpdateInterval(double updateInterval);
+    bool isUpdateNeeded(double time);
+    void setUpdated(double time);
+    void invalidate();
+    void setDynamicScale(bool dynamicScale);
+    void setMipmap(bool mipmap);
+    bool resize();
     void textureBind();
     void textureUnbind();
 
@@ -31,6 +47,9 @@ public:
     Texture *getDepthTexture();
 private:
     GLenum checkFramebufferStatus();
+    bool generateTransient();
+    bool isResized();
+    void updateScreenDimensions();
 
     GLuint id;
     Texture *color;
@@ -44,6 +63,22 @@ private:
     unsigned int height;
     unsigned int depthTextureUnit;
     unsigned int colorTextureUnit;
+    TextureFormat colorFormat;
+
+    bool transient;
+    // pooled render target of a transient FBO, NULL when released
+    FboOpenGl *target;
+
+    // resolution in relation to the screen size
+    double scale;
+    // dimensions follow the screen size, scale and dynamic resolution
+    bool screenRelative;
+    bool dynamicScale;
+    bool mipmap;
+    // seconds between content updates, 0 updates every frame and negative keeps contents until invalidated
+    double updateInterval;
+    double updateTime;
+    bool valid;
 
     static std::vector<FboOpenGl*> bindStack;
 };
@@ -0,0 +1,104 @@
+#include "FboPool.h"
+
+#include "Fbo.h"
+#include "logger/logger.h"
+
+#include <string>
+
+FboPool& FboPool::getInstance() {
+    static FboPool fboPool;
+    return fboPool;
+}
+
+FboPool::FboPool() {
+    acquireCount = 0;
+    reuseCount = 0;
+}
+
+Fbo* FboPool::acquire(unsigned int width, unsigned int height, TextureFormat colorFormat, bool storeColor, bool storeDepth) {
+    PROFILER_BLOCK("FboPool::acquire");
+
+    acquireCount++;
+
+    for (Target &target : targets) {
+        if (!target.acquired && target.width == width && target.height == height
+            && target.colorFormat == colorFormat && target.storeColor == storeColor && target.storeDepth == storeDepth) {
+            target.acquired = true;
+            reuseCount++;
+            return target.fbo;
+        }
+    }
+
+    Fbo *fbo = Fbo::newInstance(std::string("_transient_") + std::to_string(targets.size()));
+    fbo->setDimensions(width, height);
+    fbo->setColorFormat(colorFormat);
+    fbo->setStoreColor(storeColor);
+    fbo->setStoreDepth(storeDepth);
+    if (!fbo->generate()) {
+        loggerError("Could not create transient FBO. dimensions:%ux%u", width, height);
+        delete fbo;
+        return NULL;
+    }
+
+    Target target;
+    target.fbo = fbo;
+    target.width = width;
+    target.height = height;
+    target.colorFormat = colorFormat;
+    target.storeColor = storeColor;
+    target.storeDepth = storeDepth;
+    target.acquired = true;
+    targets.push_back(target);
+
+    loggerDebug("Added transient FBO to pool. name:'%s', dimensions:%ux%u, targets:%u",
+        fbo->getName().c_str(), width, height, getTargetCount());
+
+    return fbo;
+}
+
+void FboPool::release(Fbo *fbo) {
+    for (Target &target : targets) {
+        if (target.fbo == fbo) {
+            if (!target.acquired) {
+                loggerWarning("Transient FBO released twice. name:'%s'", fbo->getName().c_str());
+            }
+
+            target.acquired = false;
+            return;
+        }
+    }
+}
+
+unsigned int FboPool::getTargetCount() {
+    return static_cast<unsigned int>(targets.size());
+}
+
+unsigned int FboPool::getAcquiredCount() {
+    unsigned int count = 0;
+    for (Target &target : targets) {
+        if (target.acquired) {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+void FboPool::logStats() {
+    loggerInfo("FBO pool stats. targets:%u, acquired:%u, acquires:%u, reuses:%u",
+        getTargetCount(), getAcquiredCount(), acquireCount, reuseCount);
+}
+
+void FboPool::clear() {
+    if (!targets.empty()) {
+        logStats();
+    }
+
+    for (Target &target : targets) {
+        delete target.fbo;
+    }
+
+    targets.clear();
+    acquireCount = 0;
+    reuseCount = 0;
+}
@@ -0,0 +1,42 @@
+#ifndef ENGINE_GRAPHICS_FBOPOOL_H_
+#define ENGINE_GRAPHICS_FBOPOOL_H_
+
+#include "datatypes.h"
+
+#include <vector>
+
+class Fbo;
+
+/**
+ * Pool of transient render targets.
+ * Targets are keyed by dimensions, color format and attachments. Effects acquire a target
+ * for a scope and release it afterwards, so that targets with non-overlapping scopes share memory.
+ */
+class FboPool {
+public:
+    static FboPool& getInstance();
+    FboPool();
+    Fbo* acquire(unsigned int width, unsigned int height, TextureFormat colorFormat = TextureFormat::RGBA, bool storeColor = true, bool storeDepth = true);
+    void release(Fbo *fbo);
+    void logStats();
+    void clear();
+
+    unsigned int getTargetCount();
+    unsigned int getAcquiredCount();
+private:
+    struct Target {
+        Fbo *fbo;
+        unsigned int width;
+        unsigned int height;
+        TextureFormat colorFormat;
+        bool storeColor;
+        bool storeDepth;
+        bool acquired;
+    };
+
+    std::vector<Target> targets;
+    unsigned int acquireCount;
+    unsigned int reuseCount;
+};
+
+#endif /*ENGINE_GRAPHICS_FBOPOOL_H_*/
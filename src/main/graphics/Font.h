@@ -2,15 +2,29 @@
 #define ENGINE_GRAPHICS_FONT_H_
 
 #include "io/File.h"
+#include "datatypes.h"
 
 #include <string>
 
+/**
+ * Effects of signed distance field text.
+ * Widths are distances outwards from the glyph edge in range 0.0 - 0.5.
+ */
+struct FontSdfEffect {
+    FontSdfEffect() : outlineWidth(0.0), outlineColor(0.0, 0.0, 0.0, 1.0), glowWidth(0.0), glowColor(1.0, 1.0, 1.0, 1.0) {}
+    double outlineWidth;
+    Color outlineColor;
+    double glowWidth;
+    Color glowColor;
+};
+
 class Font : public File {
 public:
     virtual ~Font() {}
     virtual bool load(bool rollback=false) = 0;
     virtual bool isSupported() = 0;
     virtual void drawText(double x, double y, double z, double fontSize, std::string& text) = 0;
+    virtual void drawTextSdf(double x, double y, double z, double fontSize, std::string& text, const FontSdfEffect& effect) = 0;
 
     static Font* newInstance(std::string filePath);
 protected:
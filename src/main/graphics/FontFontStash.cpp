@@ -3,18 +3,32 @@
 #include "logger/logger.h"
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <algorithm>
+#include <iterator>
+#include <vector>
 
 #include "GL/gl3w.h"
 
 
 #define FONS_VERTEX_COUNT 2048
+// signed distance field generation needs more scratch memory than bitmap glyphs
+#define FONS_SCRATCH_BUF_SIZE 256000
 #define FONTS_STATIC
 #define FONTSTASH_IMPLEMENTATION
 #include "fontstash.h"
 
+// maximum atlas size, atlas starts from FONT_ATLAS_INITIAL_SIZE and grows on demand
 #define GLFONS_TEXTURE_SIZE 4096
+#define FONT_ATLAS_INITIAL_SIZE 512
+// amount of laid out texts kept in vertex buffers per font
+#define FONT_TEXT_LAYOUT_CACHE_SIZE 64
+// signed distance field glyphs are rasterized once in this pixel height and scaled for all text sizes
+#define FONT_SDF_SIZE 64
+#define FONT_SDF_PADDING 8
+#define FONT_SDF_ON_EDGE 128
+#define FONT_SDF_ATLAS_SIZE 1024
 #define GLFONS_VERTEX_ATTRIB 0
 #define GLFONS_TCOORD_ATTRIB 1
 #define GLFONS_COLOR_ATTRIB 3
@@ -23,6 +37,9 @@
 
 #include "graphics/ShaderProgram.h"
 #include "graphics/ShaderProgramOpenGl.h"
+#include "graphics/Shader.h"
+#include "graphics/TextureOpenGl.h"
+#include "io/MemoryManager.h"
 
 Font* Font::newInstance(std::string filePath) {
     Font *font = new FontFontStash(filePath);
@@ -34,15 +51,12 @@ Font* Font::newInstance(std::string filePath) {
 }
 
 FontFontStash::FontFontStash(std::string filePath) : Font(filePath) {
-    fs = NULL;
     fontId = FONS_INVALID;
 }
 
 FontFontStash::~FontFontStash() {
-    if (fs != NULL) {
-        loggerDebug("Deleting font. file:'%s', font:0x%p", getFilePath().c_str(), fs);
-        glfonsDelete(fs);
-    }
+    // font data is owned by the shared atlas context, it is released when the atlas pool is cleared
+    clearTextLayouts();
 }
 
 bool FontFontStash::isSupported() {
@@ -65,33 +79,392 @@ bool FontFontStash::isError(int fontStashId) {
     }
 }
 
-static void fontStashHandleError(void* uptr, int error, int val) {
-    const char *fontPath = "";
-    FontFontStash* fontPtr = static_cast<FontFontStash*>(uptr);
-    if (fontPtr != NULL) {
-        fontPath = fontPtr->getFilePath().c_str();
+FontAtlasPool& FontAtlasPool::getInstance() {
+    static FontAtlasPool fontAtlasPool;
+    return fontAtlasPool;
+}
+
+FontAtlasPool::FontAtlasPool() {
+    fs = NULL;
+    width = height = 0;
+    fontCount = 0;
+    expandCount = 0;
+    evictCount = 0;
+    generation = 0;
+    sdfTexture = NULL;
+    sdfScratch = NULL;
+    sdfCursorX = sdfCursorY = sdfRowHeight = 0;
+    sdfEvictCount = 0;
+    sdfShaderProgram = NULL;
+}
+
+FontAtlasPool::~FontAtlasPool() {
+    // GL context is not available anymore, clear() must be called on exit
+}
+
+static void fontStashHandleError(void* uptr, int error, int val);
+
+bool FontAtlasPool::create() {
+    width = height = FONT_ATLAS_INITIAL_SIZE;
+    fs = glfonsCreate(width, height, FONS_ZERO_BOTTOMLEFT);
+    if (fs == NULL) {
+        loggerError("Could not initialize FontStash atlas");
+        return false;
+    }
+
+    fs->handleError = fontStashHandleError;
+    fs->errorUptr = static_cast<void*>(this);
+
+    loggerDebug("Created font atlas. dimensions:%dx%d", width, height);
+    return true;
+}
+
+int FontAtlasPool::addFont(const std::string& name, const unsigned char *data, size_t length) {
+    if (fs == NULL && !create()) {
+        return FONS_INVALID;
+    }
+
+    // fonts can't be removed from fontstash, reloaded font files reuse the slot of the same name
+    int fontId = fonsGetFontByName(fs, name.c_str());
+    if (fontId != FONS_INVALID) {
+        FONSfont *font = fs->fonts[fontId];
+        if (font->dataSize == static_cast<int>(length) && memcmp(font->data, data, length) == 0) {
+            return fontId;
+        }
+
+        return replaceFont(fontId, data, length) ? fontId : FONS_INVALID;
+    }
+
+    // context owns a copy of the data that outlives the font file
+    unsigned char *fontData = static_cast<unsigned char*>(malloc(length));
+    if (fontData == NULL) {
+        loggerFatal("Could not allocate memory for font. file:'%s'", name.c_str());
+        return FONS_INVALID;
+    }
+    memcpy(fontData, data, length);
+
+    fontId = fonsAddFontMem(fs, name.c_str(), fontData, static_cast<int>(length), 1);
+    if (fontId != FONS_INVALID) {
+        fontCount++;
+    }
+
+    return fontId;
+}
+
+bool FontAtlasPool::replaceFont(int fontId, const unsigned char *data, size_t length) {
+    FONSfont *font = fs->fonts[fontId];
+
+    unsigned char *fontData = static_cast<unsigned char*>(malloc(length));
+    if (fontData == NULL) {
+        loggerFatal("Could not allocate memory for font. file:'%s'", font->name);
+        return false;
+    }
+    memcpy(fontData, data, length);
+
+    // old data is kept in the slot if the new data is not a valid font
+    stbtt_fontinfo fontInfo = font->font.font;
+    if (!stbtt_InitFont(&fontInfo, fontData, 0)) {
+        loggerError("Could not replace font data. file:'%s', fontId:%d", font->name, fontId);
+        free(fontData);
+        return false;
+    }
+
+    if (font->freeData && font->data != NULL) {
+        free(font->data);
+    }
+    font->font.font = fontInfo;
+    font->data = fontData;
+    font->dataSize = static_cast<int>(length);
+    font->freeData = 1;
+
+    int ascent = 0, descent = 0, lineGap = 0;
+    stbtt_GetFontVMetrics(&fontInfo, &ascent, &descent, &lineGap);
+    int fontHeight = ascent - descent;
+    font->ascender = static_cast<float>(ascent) / fontHeight;
+    font->descender = static_cast<float>(descent) / fontHeight;
+    font->lineh = static_cast<float>(fontHeight + lineGap) / fontHeight;
+
+    // rasterized glyphs of the old data are invalid
+    font->nglyphs = 0;
+    for (int i = 0; i < FONS_HASH_LUT_SIZE; i++) {
+        font->lut[i] = -1;
+    }
+    fonsResetAtlas(fs, width, height);
+    evictCount++;
+
+    for (auto it = sdfGlyphs.begin(); it != sdfGlyphs.end();) {
+        if (static_cast<int>(it->first >> 32) == fontId) {
+            it = sdfGlyphs.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    generation++;
+
+    loggerDebug("Replaced font data. file:'%s', fontId:%d", font->name, fontId);
+    return true;
+}
+
+FONScontext* FontAtlasPool::getContext() {
+    return fs;
+}
+
+GLuint FontAtlasPool::getTexture() {
+    if (fs == NULL) {
+        return 0;
+    }
+
+    GLFONScontext* gl = static_cast<GLFONScontext*>(fs->params.userPtr);
+    return gl->tex;
+}
+
+unsigned int FontAtlasPool::getGeneration() {
+    return generation;
+}
+
+bool FontAtlasPool::createSdfTexture() {
+    sdfTexture = Texture::newInstance();
+    sdfTexture->setFormat(TextureFormat::RED);
+    sdfTexture->setDataType(TextureDataType::UNSIGNED_BYTE);
+    sdfTexture->setWrap(TextureWrap::CLAMP_TO_EDGE);
+    sdfTexture->setFilter(TextureFilter::LINEAR);
+    sdfTexture->setMipmap(TextureMipmap::NONE);
+    if (!sdfTexture->create(FONT_SDF_ATLAS_SIZE, FONT_SDF_ATLAS_SIZE)) {
+        loggerError("Could not create SDF font atlas texture");
+        delete sdfTexture;
+        sdfTexture = NULL;
+        return false;
+    }
+
+    // stb_truetype allocates SDF bitmaps from fontstash scratch memory, a separate context keeps the shared context untouched
+    sdfScratch = static_cast<FONScontext*>(calloc(1, sizeof(FONScontext)));
+    if (sdfScratch != NULL) {
+        sdfScratch->scratch = static_cast<unsigned char*>(malloc(FONS_SCRATCH_BUF_SIZE));
+    }
+    if (sdfScratch == NULL || sdfScratch->scratch == NULL) {
+        loggerFatal("Could not allocate memory for SDF font scratch");
+        return false;
+    }
+    sdfScratch->handleError = fontStashHandleError;
+    sdfScratch->errorUptr = static_cast<void*>(this);
+
+    loggerDebug("Created SDF font atlas. dimensions:%dx%d", FONT_SDF_ATLAS_SIZE, FONT_SDF_ATLAS_SIZE);
+    return true;
+}
+
+void FontAtlasPool::evictSdfGlyphs() {
+    sdfGlyphs.clear();
+    sdfCursorX = sdfCursorY = sdfRowHeight = 0;
+    sdfEvictCount++;
+    generation++;
+    loggerInfo("SDF font atlas full, evicted all glyphs. dimensions:%dx%d, evicts:%u", FONT_SDF_ATLAS_SIZE, FONT_SDF_ATLAS_SIZE, sdfEvictCount);
+}
+
+const FontAtlasPool::SdfGlyph* FontAtlasPool::getSdfGlyph(int fontId, int glyphIndex) {
+    uint64_t key = (static_cast<uint64_t>(fontId) << 32) | static_cast<uint32_t>(glyphIndex);
+    auto it = sdfGlyphs.find(key);
+    if (it != sdfGlyphs.end()) {
+        return &it->second;
+    }
+
+    if (fs == NULL || fontId < 0 || fontId >= fs->nfonts) {
+        return NULL;
+    }
+
+    if (sdfTexture == NULL && !createSdfTexture()) {
+        return NULL;
+    }
+
+    stbtt_fontinfo fontInfo = fs->fonts[fontId]->font.font;
+    fontInfo.userdata = sdfScratch;
+    float scale = stbtt_ScaleForPixelHeight(&fontInfo, FONT_SDF_SIZE);
+
+    SdfGlyph glyph;
+    glyph.x = glyph.y = 0;
+    glyph.width = glyph.height = 0;
+    glyph.xOffset = glyph.yOffset = 0;
+
+    sdfScratch->nscratch = 0;
+    unsigned char *sdf = stbtt_GetGlyphSDF(&fontInfo, scale, glyphIndex, FONT_SDF_PADDING, FONT_SDF_ON_EDGE,
+        static_cast<float>(FONT_SDF_ON_EDGE) / FONT_SDF_PADDING, &glyph.width, &glyph.height, &glyph.xOffset, &glyph.yOffset);
+
+    if (sdf != NULL) {
+        if (sdfCursorX + glyph.width > FONT_SDF_ATLAS_SIZE) {
+            sdfCursorX = 0;
+            sdfCursorY += sdfRowHeight;
+            sdfRowHeight = 0;
+        }
+
+        if (sdfCursorY + glyph.height > FONT_SDF_ATLAS_SIZE) {
+            evictSdfGlyphs();
+        }
+
+        glyph.x = sdfCursorX;
+        glyph.y = sdfCursorY;
+        sdfCursorX += glyph.width + 1;
+        sdfRowHeight = std::max(sdfRowHeight, glyph.height + 1);
+
+        sdfTexture->updateRegion(glyph.x, glyph.y, glyph.width, glyph.height, sdf);
+
+        stbtt_FreeSDF(sdf, fontInfo.userdata);
+    } else {
+        // empty glyph, e.g. space
+        glyph.width = glyph.height = 0;
+    }
+
+    return &(sdfGlyphs[key] = glyph);
+}
+
+GLuint FontAtlasPool::getSdfTexture() {
+    if (sdfTexture == NULL) {
+        return 0;
     }
 
+    return dynamic_cast<TextureOpenGl*>(sdfTexture)->getId();
+}
+
+bool FontAtlasPool::initSdfShaderProgram() {
+    if (sdfShaderProgram != NULL) {
+        return true;
+    }
+
+    MemoryManager<Shader>& shaderMemory = MemoryManager<Shader>::getInstance();
+    Shader *vertexShader = shaderMemory.getResource(std::string("_embedded/textSdf.vs"), true);
+    Shader *fragmentShader = shaderMemory.getResource(std::string("_embedded/textSdf.fs"), true);
+    if (!vertexShader->load() || !fragmentShader->load()) {
+        loggerError("Could not compile SDF text shaders");
+        return false;
+    }
+
+    MemoryManager<ShaderProgram>& shaderProgramMemory = MemoryManager<ShaderProgram>::getInstance();
+    ShaderProgram *program = shaderProgramMemory.getResource(std::string("DefaultTextSdf"), true);
+    program->addShader(vertexShader);
+    program->addShader(fragmentShader);
+    if (!program->link()) {
+        loggerError("Could not link SDF text shader program");
+        return false;
+    }
+
+    sdfShaderProgram = program;
+    return true;
+}
+
+ShaderProgram* FontAtlasPool::getSdfShaderProgram() {
+    if (!initSdfShaderProgram()) {
+        return NULL;
+    }
+
+    return sdfShaderProgram;
+}
+
+void FontAtlasPool::handleAtlasFull() {
+    if (width < GLFONS_TEXTURE_SIZE || height < GLFONS_TEXTURE_SIZE) {
+        if (width <= height) {
+            width *= 2;
+        } else {
+            height *= 2;
+        }
+
+        if (fonsExpandAtlas(fs, width, height)) {
+            expandCount++;
+            generation++;
+            loggerDebug("Expanded font atlas. dimensions:%dx%d, expands:%u", width, height, expandCount);
+            return;
+        }
+
+        loggerWarning("Could not expand font atlas. dimensions:%dx%d", width, height);
+        fonsGetAtlasSize(fs, &width, &height);
+    }
+
+    // atlas can't grow anymore, glyphs are rasterized again when they're needed
+    if (fonsResetAtlas(fs, width, height)) {
+        evictCount++;
+        generation++;
+        loggerInfo("Font atlas full, evicted all glyphs. dimensions:%dx%d, fonts:%u, evicts:%u", width, height, fontCount, evictCount);
+    }
+}
+
+void FontAtlasPool::logStats() {
+    loggerInfo("Font atlas stats. dimensions:%dx%d, fonts:%u, expands:%u, evicts:%u, sdfGlyphs:%u, sdfEvicts:%u",
+        width, height, fontCount, expandCount, evictCount, static_cast<unsigned int>(sdfGlyphs.size()), sdfEvictCount);
+}
+
+void FontAtlasPool::clear() {
+    if (fs != NULL) {
+        logStats();
+        glfonsDelete(fs);
+    }
+
+    if (sdfTexture != NULL) {
+        delete sdfTexture;
+    }
+
+    if (sdfScratch != NULL) {
+        free(sdfScratch->scratch);
+        free(sdfScratch);
+    }
+
+    sdfTexture = NULL;
+    sdfScratch = NULL;
+    sdfGlyphs.clear();
+    sdfCursorX = sdfCursorY = sdfRowHeight = 0;
+    sdfEvictCount = 0;
+    // shader programs are released by the memory manager
+    sdfShaderProgram = NULL;
+
+    fs = NULL;
+    width = height = 0;
+    fontCount = 0;
+    expandCount = 0;
+    evictCount = 0;
+    generation++;
+}
+
+int FontAtlasPool::getWidth() {
+    return width;
+}
+
+int FontAtlasPool::getHeight() {
+    return height;
+}
+
+unsigned int FontAtlasPool::getFontCount() {
+    return fontCount;
+}
+
+unsigned int FontAtlasPool::getExpandCount() {
+    return expandCount;
+}
+
+unsigned int FontAtlasPool::getEvictCount() {
+    return evictCount;
+}
+
+static void fontStashHandleError(void* uptr, int error, int val) {
+    FontAtlasPool* atlasPool = static_cast<FontAtlasPool*>(uptr);
+
     switch(error) {
         case FONS_ATLAS_FULL:
-            // Font atlas is full.
-            loggerWarning("Font atlas full. error:FONS_ATLAS_FULL(%d), value:%d, path:'%s'", error, val, fontPath);
+            // Font atlas is full, fontstash retries adding the glyph after this.
+            if (atlasPool != NULL) {
+                atlasPool->handleAtlasFull();
+            }
             break;
         case FONS_SCRATCH_FULL:
             // Scratch memory used to render glyphs is full, requested size reported in 'val', you may need to bump up FONS_SCRATCH_BUF_SIZE.
-            loggerWarning("Font scratch full. error:FONS_SCRATCH_FULL(%d), value:%d, path:'%s'", error, val, fontPath);
+            loggerWarning("Font scratch full. error:FONS_SCRATCH_FULL(%d), value:%d", error, val);
             break;
         case FONS_STATES_OVERFLOW:
             // Calls to fonsPushState has created too large stack, if you need deep state stack bump up FONS_MAX_STATES.
-            loggerWarning("Font states overflow. error:FONS_STATES_OVERFLOW(%d), value:%d, path:'%s'", error, val, fontPath);
+            loggerWarning("Font states overflow. error:FONS_STATES_OVERFLOW(%d), value:%d", error, val);
             break;
         case FONS_STATES_UNDERFLOW:
             // Trying to pop too many states fonsPopState().
-            loggerWarning("Font states underflow. error:FONS_STATES_UNDERFLOW(%d), value:%d, path:'%s'", error, val, fontPath);
+            loggerWarning("Font states underflow. error:FONS_STATES_UNDERFLOW(%d), value:%d", error, val);
             break;
         default:
             // Trying to pop too many states fonsPopState().
-            loggerWarning("Unknown font error. error:%d, value:%d, path:'%s'", error, val, fontPath);
+            loggerWarning("Unknown font error. error:%d, value:%d", error, val);
             break;
     }
 }
@@ -114,17 +487,11 @@ bool FontFontStash::load(bool rollback) {
         return false;
     }
 
-    fs = glfonsCreate(GLFONS_TEXTURE_SIZE, GLFONS_TEXTURE_SIZE, FONS_ZERO_BOTTOMLEFT);
-    if (fs == NULL) {
-        loggerError("Could not initialize FontStash font");
-        return false;
-    }
+    clearTextLayouts();
 
-    fs->handleError = fontStashHandleError;
-    fs->errorUptr = static_cast<void*>(this);
-
-    fontId = fonsAddFontMem(fs, getFilePath().c_str(), getData(), static_cast<int>(length()), 0);
+    fontId = FontAtlasPool::getInstance().addFont(getFilePath(), getData(), length());
     if (isError(fontId)) {
+        loggerError("Could not add font to FontStash. file:'%s'", getFilePath().c_str());
         return false;
     }
 
@@ -141,22 +508,277 @@ bool FontFontStash::isLoaded() {
 }
 
 
+void FontFontStash::applyTextState(FONScontext* fs, double fontSize) {
+    fonsClearState(fs);
+    fonsSetFont(fs, fontId);
+    fonsSetSize(fs, fontSize);
+    fonsSetColor(fs, glfonsRGBA(255,255,255,255));
+    fonsSetAlign(fs, FONS_ALIGN_CENTER | FONS_ALIGN_MIDDLE);
+    fonsSetBlur(fs, 2.0f);
+}
+
+void FontFontStash::appendGlyphQuads(FONScontext* fs, TextLayout &layout, std::vector<GLfloat> &vertices) {
+    applyTextState(fs, layout.fontSize);
+
+    FONStextIter iter;
+    FONSquad q;
+    fonsTextIterInit(fs, &iter, layout.x, layout.y, layout.text.c_str(), NULL, FONS_GLYPH_BITMAP_REQUIRED);
+    while (fonsTextIterNext(fs, &iter, &q)) {
+        const GLfloat quad[] = {
+            q.x0, q.y0, q.s0, q.t0,
+            q.x1, q.y1, q.s1, q.t1,
+            q.x1, q.y0, q.s1, q.t0,
+            q.x0, q.y0, q.s0, q.t0,
+            q.x0, q.y1, q.s0, q.t1,
+            q.x1, q.y1, q.s1, q.t1
+        };
+        vertices.insert(vertices.end(), quad, quad + 24);
+    }
+}
+
+void FontFontStash::appendSdfGlyphQuads(FONScontext* fs, TextLayout &layout, std::vector<GLfloat> &vertices) {
+    FontAtlasPool& atlasPool = FontAtlasPool::getInstance();
+    FONSfont* font = fs->fonts[fontId];
+    stbtt_fontinfo *fontInfo = &font->font.font;
+
+    float fontSize = static_cast<float>(layout.fontSize);
+    float scale = stbtt_ScaleForPixelHeight(fontInfo, fontSize);
+    // glyphs are rasterized in FONT_SDF_SIZE
+    float glyphScale = fontSize / FONT_SDF_SIZE;
+
+    std::vector<int> glyphIndices;
+    unsigned int utf8state = 0;
+    unsigned int codepoint = 0;
+    for (const char *str = layout.text.c_str(); *str; ++str) {
+        if (fons__decutf8(&utf8state, &codepoint, *(const unsigned char*)str)) {
+            continue;
+        }
+
+        glyphIndices.push_back(stbtt_FindGlyphIndex(fontInfo, codepoint));
+    }
+
+    // same alignment as FONS_ALIGN_CENTER | FONS_ALIGN_MIDDLE in fontstash with FONS_ZERO_BOTTOMLEFT
+    float textWidth = 0.0f;
+    for (size_t i = 0; i < glyphIndices.size(); i++) {
+        int advance, leftSideBearing;
+        stbtt_GetGlyphHMetrics(fontInfo, glyphIndices[i], &advance, &leftSideBearing);
+        textWidth += advance * scale;
+        if (i > 0) {
+            textWidth += stbtt_GetGlyphKernAdvance(fontInfo, glyphIndices[i-1], glyphIndices[i]) * scale;
+        }
+    }
+
+    float penX = static_cast<float>(layout.x) - textWidth * 0.5f;
+    float penY = static_cast<float>(layout.y) - (font->ascender + font->descender) / 2.0f * fontSize;
+    const float atlasScale = 1.0f / FONT_SDF_ATLAS_SIZE;
+
+    for (size_t i = 0; i < glyphIndices.size(); i++) {
+        if (i > 0) {
+            penX += stbtt_GetGlyphKernAdvance(fontInfo, glyphIndices[i-1], glyphIndices[i]) * scale;
+        }
+
+        const FontAtlasPool::SdfGlyph* glyph = atlasPool.getSdfGlyph(fontId, glyphIndices[i]);
+        if (glyph != NULL && glyph->width > 0 && glyph->height > 0) {
+            // stb_truetype offsets are from the baseline with y growing downwards
+            float x0 = penX + glyph->xOffset * glyphScale;
+            float x1 = x0 + glyph->width * glyphScale;
+            float y0 = penY - glyph->yOffset * glyphScale;
+            float y1 = y0 - glyph->height * glyphScale;
+            float s0 = glyph->x * atlasScale;
+            float s1 = (glyph->x + glyph->width) * atlasScale;
+            float t0 = glyph->y * atlasScale;
+            float t1 = (glyph->y + glyph->height) * atlasScale;
+
+            const GLfloat quad[] = {
+                x0, y0, s0, t0,
+                x1, y1, s1, t1,
+                x1, y0, s1, t0,
+                x0, y0, s0, t0,
+                x0, y1, s0, t1,
+                x1, y1, s1, t1
+            };
+            vertices.insert(vertices.end(), quad, quad + 24);
+        }
+
+        int advance, leftSideBearing;
+        stbtt_GetGlyphHMetrics(fontInfo, glyphIndices[i], &advance, &leftSideBearing);
+        penX += advance * scale;
+    }
+}
+
+bool FontFontStash::layoutText(FONScontext* fs, TextLayout &layout) {
+    PROFILER_BLOCK("FontFontStash::layoutText");
+
+    FontAtlasPool& atlasPool = FontAtlasPool::getInstance();
+
+    // two triangles per glyph, position and texture coordinate per vertex
+    std::vector<GLfloat> vertices;
+    vertices.reserve(layout.text.size() * 6 * 4);
+
+    // if atlas changes during layout, quads created before the change have invalid texture coordinates
+    for (int attempt = 0; attempt < 2; attempt++) {
+        unsigned int generation = atlasPool.getGeneration();
+        vertices.clear();
+
+        if (layout.sdf) {
+            appendSdfGlyphQuads(fs, layout, vertices);
+        } else {
+            appendGlyphQuads(fs, layout, vertices);
+        }
+
+        if (generation == atlasPool.getGeneration()) {
+            break;
+        }
+    }
+
+    // upload newly rasterized glyphs to the atlas texture
+    fons__flush(fs);
+
+    if (layout.vertexArray == 0) {
+        glGenVertexArrays(1, &layout.vertexArray);
+        glGenBuffers(1, &layout.vertexBuffer);
+
+        glBindVertexArray(layout.vertexArray);
+        glBindBuffer(GL_ARRAY_BUFFER, layout.vertexBuffer);
+        glEnableVertexAttribArray(GLFONS_VERTEX_ATTRIB);
+        glVertexAttribPointer(GLFONS_VERTEX_ATTRIB, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), (const GLvoid*)0);
+        glEnableVertexAttribArray(GLFONS_TCOORD_ATTRIB);
+        glVertexAttribPointer(GLFONS_TCOORD_ATTRIB, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), (const GLvoid*)(2 * sizeof(GLfloat)));
+        glBindVertexArray(0);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, layout.vertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(GLfloat), vertices.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    layout.vertexCount = static_cast<GLsizei>(vertices.size() / 4);
+    layout.atlasGeneration = atlasPool.getGeneration();
+
+    return true;
+}
+
+FontFontStash::TextLayout* FontFontStash::getTextLayout(FONScontext* fs, double x, double y, double fontSize, std::string& text, bool sdf) {
+    auto it = std::find_if(textLayouts.begin(), textLayouts.end(), [&](const TextLayout& layout) {
+        return layout.sdf == sdf && layout.fontSize == fontSize && layout.x == x && layout.y == y && layout.text == text;
+    });
+
+    if (it != textLayouts.end()) {
+        textLayouts.splice(textLayouts.begin(), textLayouts, it);
+    } else {
+        if (textLayouts.size() >= FONT_TEXT_LAYOUT_CACHE_SIZE) {
+            // reuse buffers of the least recently used layout
+            textLayouts.splice(textLayouts.begin(), textLayouts, std::prev(textLayouts.end()));
+        } else {
+            textLayouts.push_front(TextLayout());
+            textLayouts.front().vertexArray = 0;
+            textLayouts.front().vertexBuffer = 0;
+        }
+
+        TextLayout& layout = textLayouts.front();
+        layout.text = text;
+        layout.fontSize = fontSize;
+        layout.x = x;
+        layout.y = y;
+        layout.sdf = sdf;
+        if (!layoutText(fs, layout)) {
+            return NULL;
+        }
+    }
+
+    TextLayout& layout = textLayouts.front();
+    if (layout.atlasGeneration != FontAtlasPool::getInstance().getGeneration()) {
+        if (!layoutText(fs, layout)) {
+            return NULL;
+        }
+    }
+
+    return &layout;
+}
+
+void FontFontStash::clearTextLayouts() {
+    for (TextLayout& layout : textLayouts) {
+        if (layout.vertexArray != 0) {
+            glDeleteVertexArrays(1, &layout.vertexArray);
+            glDeleteBuffers(1, &layout.vertexBuffer);
+        }
+    }
+
+    textLayouts.clear();
+}
+
+void FontFontStash::drawTextLayout(TextLayout* layout, GLuint texture) {
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, texture);
+
+    glBindVertexArray(layout->vertexArray);
+    glVertexAttrib4f(GLFONS_COLOR_ATTRIB, 1.0f, 1.0f, 1.0f, 1.0f);
+    glDrawArrays(GL_TRIANGLES, 0, layout->vertexCount);
+    glBindVertexArray(0);
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
 void FontFontStash::drawText(double x, double y, double z, double fontSize, std::string& text) {
+    FONScontext* fs = FontAtlasPool::getInstance().getContext();
     if (fontId == FONS_INVALID || fs == NULL) {
         loggerWarning("Font has not been initialized! font:0x%p, fontInternalId:%d", fs, fontId);
         return;
     }
 
+    // unchanged texts are drawn from cached vertex buffers with a single draw call
+    TextLayout* layout = getTextLayout(fs, x, y, fontSize, text, false);
+    if (layout == NULL || layout->vertexCount == 0) {
+        return;
+    }
+
     ShaderProgram::useCurrentBind();
 /*
         glEnable(GL_BLEND);
         glBlendFunc(GL_SRC_ALPHA,GL_ONE_MINUS_SRC_ALPHA);
 */
-    fonsClearState(fs);
-    fonsSetFont(fs, fontId);
-    fonsSetSize(fs, fontSize);
-    fonsSetColor(fs, glfonsRGBA(255,255,255,255));
-    fonsSetAlign(fs, FONS_ALIGN_CENTER | FONS_ALIGN_MIDDLE);
-    fonsSetBlur(fs, 2.0f);
-    fonsDrawText(fs, x, y, text.c_str(), NULL);
+    drawTextLayout(layout, FontAtlasPool::getInstance().getTexture());
+}
+
+void FontFontStash::drawTextSdf(double x, double y, double z, double fontSize, std::string& text, const FontSdfEffect& effect) {
+    FONScontext* fs = FontAtlasPool::getInstance().getContext();
+    if (fontId == FONS_INVALID || fs == NULL) {
+        loggerWarning("Font has not been initialized! font:0x%p, fontInternalId:%d", fs, fontId);
+        return;
+    }
+
+    ShaderProgram* sdfShaderProgram = FontAtlasPool::getInstance().getSdfShaderProgram();
+    if (sdfShaderProgram == NULL) {
+        drawText(x, y, z, fontSize, text);
+        return;
+    }
+
+    // glyphs in the SDF atlas are shared by all font sizes, only the quads depend on the size
+    TextLayout* layout = getTextLayout(fs, x, y, fontSize, text, true);
+    if (layout == NULL || layout->vertexCount == 0) {
+        return;
+    }
+
+    sdfShaderProgram->bind();
+    ShaderProgram::useCurrentBind();
+
+    GLint uniformId = ShaderProgramOpenGl::getUniformLocation("sdfOutlineWidth");
+    if (uniformId != -1) {
+        glUniform1f(uniformId, static_cast<GLfloat>(effect.outlineWidth));
+    }
+    uniformId = ShaderProgramOpenGl::getUniformLocation("sdfOutlineColor");
+    if (uniformId != -1) {
+        glUniform4f(uniformId, effect.outlineColor.r, effect.outlineColor.g, effect.outlineColor.b, effect.outlineColor.a);
+    }
+    uniformId = ShaderProgramOpenGl::getUniformLocation("sdfGlowWidth");
+    if (uniformId != -1) {
+        glUniform1f(uniformId, static_cast<GLfloat>(effect.glowWidth));
+    }
+    uniformId = ShaderProgramOpenGl::getUniformLocation("sdfGlowColor");
+    if (uniformId != -1) {
+        glUniform4f(uniformId, effect.glowColor.r, effect.glowColor.g, effect.glowColor.b, effect.glowColor.a);
+    }
+
+    drawTextLayout(layout, FontAtlasPool::getInstance().getSdfTexture());
+
+    sdfShaderProgram->unbind();
 }
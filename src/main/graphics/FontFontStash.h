@@ -4,6 +4,75 @@
 #include "Font.h"
 #include "fontstash.h"
 
+#include "GL/gl3w.h"
+
+#include <list>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+
+class ShaderProgram;
+class Texture;
+
+/**
+ * Glyph atlas shared by all fonts. Atlas starts small and grows when it gets full.
+ * When the maximum size is reached, all glyphs are evicted and rasterized again on demand.
+ * Signed distance field glyphs are kept in a separate atlas, rasterized once in a fixed size for all text sizes.
+ */
+class FontAtlasPool {
+public:
+    struct SdfGlyph {
+        int x, y;
+        int width, height;
+        int xOffset, yOffset;
+    };
+
+    static FontAtlasPool& getInstance();
+    FontAtlasPool();
+    ~FontAtlasPool();
+    int addFont(const std::string& name, const unsigned char *data, size_t length);
+    FONScontext* getContext();
+    GLuint getTexture();
+    unsigned int getGeneration();
+    const SdfGlyph* getSdfGlyph(int fontId, int glyphIndex);
+    GLuint getSdfTexture();
+    ShaderProgram* getSdfShaderProgram();
+    void handleAtlasFull();
+    void logStats();
+    void clear();
+
+    int getWidth();
+    int getHeight();
+    unsigned int getFontCount();
+    unsigned int getExpandCount();
+    unsigned int getEvictCount();
+private:
+    bool create();
+    bool replaceFont(int fontId, const unsigned char *data, size_t length);
+    bool createSdfTexture();
+    void evictSdfGlyphs();
+    bool initSdfShaderProgram();
+
+    FONScontext* fs;
+    int width;
+    int height;
+    unsigned int fontCount;
+    unsigned int expandCount;
+    unsigned int evictCount;
+    // changes whenever glyph texture coordinates become invalid
+    unsigned int generation;
+
+    std::unordered_map<uint64_t, SdfGlyph> sdfGlyphs;
+    Texture *sdfTexture;
+    // scratch memory for SDF rasterization, only the allocator fields are used
+    FONScontext *sdfScratch;
+    int sdfCursorX;
+    int sdfCursorY;
+    int sdfRowHeight;
+    unsigned int sdfEvictCount;
+    ShaderProgram *sdfShaderProgram;
+};
+
 class FontFontStash : public Font {
 public:
     explicit FontFontStash(std::string filePath);
@@ -13,11 +82,31 @@ public:
     bool isLoaded();
     bool isSupported();
     void drawText(double x, double y, double z, double fontSize, std::string& text);
+    void drawTextSdf(double x, double y, double z, double fontSize, std::string& text, const FontSdfEffect& effect);
 private:
+    struct TextLayout {
+        std::string text;
+        double fontSize;
+        double x, y;
+        bool sdf;
+        unsigned int atlasGeneration;
+        GLuint vertexArray;
+        GLuint vertexBuffer;
+        GLsizei vertexCount;
+    };
+
     bool isError(int fontStashId);
+    void applyTextState(FONScontext* fs, double fontSize);
+    TextLayout* getTextLayout(FONScontext* fs, double x, double y, double fontSize, std::string& text, bool sdf);
+    bool layoutText(FONScontext* fs, TextLayout &layout);
+    void appendGlyphQuads(FONScontext* fs, TextLayout &layout, std::vector<GLfloat> &vertices);
+    void appendSdfGlyphQuads(FONScontext* fs, TextLayout &layout, std::vector<GLfloat> &vertices);
+    void drawTextLayout(TextLayout* layout, GLuint texture);
+    void clearTextLayouts();
 
-    FONScontext* fs;
     int fontId;
+    // laid out glyph quads of recently drawn texts, most recently used first
+    std::list<TextLayout> textLayouts;
 };
 
 #endif /*ENGINE_GRAPHICS_FONTFONTSTASH_H_*/
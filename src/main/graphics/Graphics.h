@@ -13,11 +13,16 @@ public:
     virtual bool exit() = 0;
     virtual void setViewport() = 0;
     virtual void setViewport(unsigned int x, unsigned int y, unsigned int width, unsigned int height) = 0;
+    virtual const unsigned int* getViewport() = 0;
     virtual void setClearColor(Color color) = 0;
     virtual void setColor(Color color) = 0;
     virtual Color& getColor() = 0;
     virtual void clear() = 0;
     virtual bool handleErrors() = 0;
+    /**
+     * Called once per frame, also reports errors that are not checked per call in release builds
+     */
+    virtual bool handleFrameErrors() = 0;
     virtual bool takeScreenshot(Window &window) = 0;
     virtual void setDepthTest(bool enable) = 0;
     virtual void pushState() = 0;
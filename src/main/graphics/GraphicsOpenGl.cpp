@@ -3,6 +3,10 @@
 #include <stdio.h>
 
 #include <string>
+#include <set>
+#include <atomic>
+#include <mutex>
+#include <vector>
 
 #include "GL/gl3w.h"
 #include "glm/glm.hpp"
@@ -14,6 +18,7 @@
 #include "time/SystemTime.h"
 
 #include "Settings.h"
+#include "graphics/RenderQueue.h"
 
 OpenGlState::OpenGlState() {
     saved = false;
@@ -123,7 +128,11 @@ void GraphicsOpenGl::popState() {
         return;
     }
 
-    stateStack.back().load();
+    OpenGlState& state = stateStack.back();
+    state.load();
+    for (int i = 0; i < 4; i++) {
+        viewport[i] = static_cast<unsigned int>(state.viewport[i]);
+    }
     stateStack.pop_back();
 }
 
@@ -136,6 +145,9 @@ Graphics& Graphics::getInstance() {
 GraphicsOpenGl::GraphicsOpenGl() {
     libraryLoaded = false;
     initialized = false;
+    debugOutput = false;
+    debugOutputSynchronous = true;
+    viewport[0] = viewport[1] = viewport[2] = viewport[3] = 0;
 }
 
 GraphicsOpenGl::~GraphicsOpenGl() {
@@ -203,7 +215,62 @@ static const char* getOpenGlSeverity(GLenum severity) {
     }
 }
 
+#ifdef ENGINE_GL_DEBUG_OUTPUT
+// maximum error messages kept between handleErrors() calls
+#define DEBUG_OUTPUT_ERROR_QUEUE_SIZE 32
+
+// set by the debug output callback, asynchronous output may call it from a driver thread.
+// callback only queues the messages, they are logged by handleErrors() in the main thread.
+static std::atomic<bool> debugOutputError(false);
+static std::mutex debugOutputErrorMutex;
+static std::vector<std::string> debugOutputErrors;
+static unsigned int debugOutputErrorsDropped = 0;
+
+static bool isExtensionSupported(const std::string& extension) {
+    static std::set<std::string> extensions;
+    if (extensions.empty()) {
+        GLint extensionCount = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+        for (GLint i = 0; i < extensionCount; i++) {
+            extensions.insert(std::string(reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)))));
+        }
+    }
+
+    return extensions.find(extension) != extensions.end();
+}
+
+static bool isDebugOutputSupported() {
+    return glDebugMessageCallback != NULL && (gl3wIsSupported(4, 3) || isExtensionSupported("GL_KHR_debug"));
+}
+#endif
+
+static void logVersionInfo() {
+    static bool showVersionInfo = true;
+    if (showVersionInfo) {
+        loggerError("OpenGL: %s, GLSL: %s, Renderer: %s, Vendor: %s",
+            glGetString(GL_VERSION),
+            glGetString(GL_SHADING_LANGUAGE_VERSION),
+            glGetString(GL_RENDERER),
+            glGetString(GL_VENDOR));
+
+        showVersionInfo = false;
+    }
+}
+
 static void openGlDebugLogProcess(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar* message, const void* userParam) {
+#ifdef ENGINE_GL_DEBUG_OUTPUT
+    if (type == GL_DEBUG_TYPE_ERROR) {
+        std::lock_guard<std::mutex> lock(debugOutputErrorMutex);
+        if (debugOutputErrors.size() < DEBUG_OUTPUT_ERROR_QUEUE_SIZE) {
+            debugOutputErrors.push_back(std::string(message));
+        } else {
+            debugOutputErrorsDropped++;
+        }
+        debugOutputError = true;
+        return;
+    }
+#endif
+
     loggerDebug("OpenGL LOG %s/%s/%s (%u): %s", getOpenGlSource(source), getOpenGlType(type), getOpenGlSeverity(severity), id, message);
 }
 
@@ -225,14 +292,39 @@ bool GraphicsOpenGl::init() {
             glGetString(GL_RENDERER),
             glGetString(GL_VENDOR));
 
-        if (Settings::logger.logLevel <= LEVEL_TRACE) {
+        bool traceOutput = Settings::logger.logLevel <= LEVEL_TRACE;
+#ifdef ENGINE_GL_DEBUG_OUTPUT
+        debugOutput = isDebugOutputSupported();
+        if (!debugOutput) {
+#ifdef NDEBUG
+            loggerWarning("KHR_debug not supported, OpenGL errors are checked with glGetError once per frame");
+#else
+            loggerWarning("KHR_debug not supported, OpenGL errors are checked with glGetError");
+#endif
+        }
+#endif
+
+        if (debugOutput || (traceOutput && glDebugMessageCallback != NULL)) {
             // in theory this is supported only in OpenGL 4.3 and upwards
             glEnable(GL_DEBUG_OUTPUT);
-            glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS); 
+#ifdef NDEBUG
+            // synchronous output stalls the driver like glGetError, release builds use it only when tracing
+            debugOutputSynchronous = traceOutput;
+#else
+            debugOutputSynchronous = true;
+#endif
+            if (debugOutputSynchronous) {
+                glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+            }
             glDebugMessageCallback(openGlDebugLogProcess, NULL);
 
-            //full-blown debug in OpenGL
-            glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 0, NULL, GL_TRUE);
+            if (traceOutput) {
+                //full-blown debug in OpenGL
+                glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 0, NULL, GL_TRUE);
+            } else {
+                glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 0, NULL, GL_FALSE);
+                glDebugMessageControl(GL_DONT_CARE, GL_DEBUG_TYPE_ERROR, GL_DONT_CARE, 0, NULL, GL_TRUE);
+            }
         }
 
         GLint glMaxTextureSize = 0;
@@ -291,6 +383,15 @@ void GraphicsOpenGl::setViewport(unsigned int x, unsigned int y, unsigned int wi
     glViewport(x, y, width, height);
 
     glScissor(x, y, width, height);
+
+    viewport[0] = x;
+    viewport[1] = y;
+    viewport[2] = width;
+    viewport[3] = height;
+}
+
+const unsigned int* GraphicsOpenGl::getViewport() {
+    return viewport;
 }
 
 void GraphicsOpenGl::setClearColor(Color color) {
@@ -308,14 +409,60 @@ Color& GraphicsOpenGl::getColor() {
 }
 
 void GraphicsOpenGl::clear() {
+    RenderQueue::getInstance().flush();
     glClear(GL_COLOR_BUFFER_BIT|GL_DEPTH_BUFFER_BIT);
 }
 
 bool GraphicsOpenGl::handleErrors() {
     bool errorOccurred = false;
-    if (checkError()) {
+
+#ifdef ENGINE_GL_DEBUG_OUTPUT
+    if (debugOutputError.exchange(false)) {
+        std::vector<std::string> errors;
+        unsigned int dropped = 0;
+        {
+            std::lock_guard<std::mutex> lock(debugOutputErrorMutex);
+            errors.swap(debugOutputErrors);
+            dropped = debugOutputErrorsDropped;
+            debugOutputErrorsDropped = 0;
+        }
+
+        for (const std::string& error : errors) {
+            if (debugOutputSynchronous) {
+                loggerError("OpenGL Error: %s", error.c_str());
+            } else {
+                // asynchronous output is not tied to the failing call, it may come from any call since the previous check
+                loggerError("OpenGL Error (asynchronous, origin may precede this check): %s", error.c_str());
+            }
+        }
+        if (dropped > 0) {
+            loggerError("OpenGL Error: %u more errors not logged", dropped);
+        }
+
+        logVersionInfo();
         errorOccurred = true;
     }
+#endif
+
+#if !defined(ENGINE_GL_DEBUG_OUTPUT) || !defined(NDEBUG)
+    // glGetError forces driver synchronization, it is only polled when errors are not reported by the callback
+    if (!debugOutput && checkError()) {
+        errorOccurred = true;
+    }
+#endif
+
+    return errorOccurred;
+}
+
+bool GraphicsOpenGl::handleFrameErrors() {
+    bool errorOccurred = handleErrors();
+
+#if defined(ENGINE_GL_DEBUG_OUTPUT) && defined(NDEBUG)
+    // without the callback errors are still polled at the end of the frame, origin is anywhere in the frame
+    if (!debugOutput && checkError()) {
+        errorOccurred = true;
+    }
+#endif
 
     return errorOccurred;
 }
@@ -361,16 +508,7 @@ bool GraphicsOpenGl::checkError() {
         }
 
         loggerError("OpenGL Error: %s", errorString.c_str());
-        static bool showVersionInfo = true;
-        if (showVersionInfo) {
-            loggerError("OpenGL: %s, GLSL: %s, Renderer: %s, Vendor: %s",
-                glGetString(GL_VERSION),
-                glGetString(GL_SHADING_LANGUAGE_VERSION),
-                glGetString(GL_RENDERER),
-                glGetString(GL_VENDOR));
-
-            showVersionInfo = false;
-        }
+        logVersionInfo();
 
         return true;
     }
@@ -44,11 +44,13 @@ public:
     bool exit();
     void setViewport();
     void setViewport(unsigned int x, unsigned int y, unsigned int width, unsigned int height);
+    const unsigned int* getViewport();
     void setClearColor(Color color);
     void setColor(Color color);
     Color& getColor();
     void clear();
     bool handleErrors();
+    bool handleFrameErrors();
     bool takeScreenshot(Window &window);
     void setDepthTest(bool enable);
 protected:
@@ -58,8 +60,14 @@ private:
     static void setCapability(GLenum capability, bool enable);
     static std::vector<OpenGlState> stateStack;
     Color color;
+    // x, y, width, height of the last setViewport(), avoids querying GL state per draw
+    unsigned int viewport[4];
     bool libraryLoaded;
     bool initialized;
+    // errors are reported by the KHR_debug callback instead of glGetError
+    bool debugOutput;
+    // asynchronous errors are reported after the call that caused them
+    bool debugOutputSynchronous;
 };
 
 
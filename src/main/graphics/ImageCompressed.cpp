@@ -0,0 +1,346 @@
+#include "ImageCompressed.h"
+
+#include "logger/logger.h"
+
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+
+static std::string getLowerCaseExtension(const std::string& filePath) {
+    size_t dot = filePath.find_last_of('.');
+    if (dot == std::string::npos) {
+        return std::string("");
+    }
+
+    std::string fileExtension = filePath.substr(dot + 1);
+    std::transform(fileExtension.begin(), fileExtension.end(), fileExtension.begin(), ::tolower);
+    return fileExtension;
+}
+
+static uint32_t readUint32(const unsigned char *data) {
+    uint32_t value = 0;
+    memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+static size_t getBlockSize(TextureCompression compression) {
+    switch(compression) {
+        case TextureCompression::BC1:
+        case TextureCompression::BC1_ALPHA:
+        case TextureCompression::BC1_SRGB:
+        case TextureCompression::BC1_ALPHA_SRGB:
+        case TextureCompression::BC4:
+        case TextureCompression::BC4_SIGNED:
+            return 8;
+        default:
+            return 16;
+    }
+}
+
+static size_t getLevelSize(TextureCompression compression, int width, int height) {
+    size_t blocksX = static_cast<size_t>(std::max(1, (width + 3) / 4));
+    size_t blocksY = static_cast<size_t>(std::max(1, (height + 3) / 4));
+    return blocksX * blocksY * getBlockSize(compression);
+}
+
+// OpenGL internal format enumerations used in KTX files
+static TextureCompression getKtxCompression(uint32_t glInternalFormat) {
+    switch(glInternalFormat) {
+        case 0x83F0: return TextureCompression::BC1;
+        case 0x83F1: return TextureCompression::BC1_ALPHA;
+        case 0x8C4C: return TextureCompression::BC1_SRGB;
+        case 0x8C4D: return TextureCompression::BC1_ALPHA_SRGB;
+        case 0x83F2: return TextureCompression::BC2;
+        case 0x8C4E: return TextureCompression::BC2_SRGB;
+        case 0x83F3: return TextureCompression::BC3;
+        case 0x8C4F: return TextureCompression::BC3_SRGB;
+        case 0x8DBB: return TextureCompression::BC4;
+        case 0x8DBC: return TextureCompression::BC4_SIGNED;
+        case 0x8DBD: return TextureCompression::BC5;
+        case 0x8DBE: return TextureCompression::BC5_SIGNED;
+        case 0x8E8F: return TextureCompression::BC6H;
+        case 0x8E8E: return TextureCompression::BC6H_SIGNED;
+        case 0x8E8C: return TextureCompression::BC7;
+        case 0x8E8D: return TextureCompression::BC7_SRGB;
+        default: return TextureCompression::NONE;
+    }
+}
+
+// DXGI_FORMAT values used in DDS DX10 extension header
+static TextureCompression getDxgiCompression(uint32_t dxgiFormat) {
+    switch(dxgiFormat) {
+        case 71: return TextureCompression::BC1_ALPHA;
+        case 72: return TextureCompression::BC1_ALPHA_SRGB;
+        case 74: return TextureCompression::BC2;
+        case 75: return TextureCompression::BC2_SRGB;
+        case 77: return TextureCompression::BC3;
+        case 78: return TextureCompression::BC3_SRGB;
+        case 80: return TextureCompression::BC4;
+        case 81: return TextureCompression::BC4_SIGNED;
+        case 83: return TextureCompression::BC5;
+        case 84: return TextureCompression::BC5_SIGNED;
+        case 95: return TextureCompression::BC6H;
+        case 96: return TextureCompression::BC6H_SIGNED;
+        case 98: return TextureCompression::BC7;
+        case 99: return TextureCompression::BC7_SRGB;
+        default: return TextureCompression::NONE;
+    }
+}
+
+static uint32_t fourCc(const char *code) {
+    return readUint32(reinterpret_cast<const unsigned char*>(code));
+}
+
+static TextureCompression getFourCcCompression(uint32_t code) {
+    if (code == fourCc("DXT1")) {
+        return TextureCompression::BC1_ALPHA;
+    } else if (code == fourCc("DXT2") || code == fourCc("DXT3")) {
+        return TextureCompression::BC2;
+    } else if (code == fourCc("DXT4") || code == fourCc("DXT5")) {
+        return TextureCompression::BC3;
+    } else if (code == fourCc("ATI1") || code == fourCc("BC4U")) {
+        return TextureCompression::BC4;
+    } else if (code == fourCc("BC4S")) {
+        return TextureCompression::BC4_SIGNED;
+    } else if (code == fourCc("ATI2") || code == fourCc("BC5U")) {
+        return TextureCompression::BC5;
+    } else if (code == fourCc("BC5S")) {
+        return TextureCompression::BC5_SIGNED;
+    }
+
+    return TextureCompression::NONE;
+}
+
+bool ImageCompressed::isCompressedFile(const std::string& filePath) {
+    std::string fileExtension = getLowerCaseExtension(filePath);
+    if (fileExtension == "ktx" || fileExtension == "dds") {
+        return true;
+    }
+
+    return false;
+}
+
+ImageCompressed::ImageCompressed(std::string filePath) : Image(filePath) {
+}
+
+ImageCompressed::~ImageCompressed() {
+    if (texture != NULL) {
+        loggerTrace("Deconstructing image and texture. file:'%s', texture:0x%p", getFilePath().c_str(), texture);
+        delete texture;
+    }
+}
+
+bool ImageCompressed::isSupported() {
+    return isCompressedFile(getFilePath());
+}
+
+bool ImageCompressed::parseKtx(TextureCompression& compression, std::vector<CompressedTextureLevel>& levels) {
+    static const unsigned char KTX_IDENTIFIER[12] = {
+        0xAB, 0x4B, 0x54, 0x58, 0x20, 0x31, 0x31, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A
+    };
+    const size_t KTX_HEADER_SIZE = 64;
+    const uint32_t KTX_ENDIANNESS = 0x04030201;
+
+    const unsigned char *data = getData();
+    size_t dataLength = length();
+
+    if (dataLength < KTX_HEADER_SIZE || memcmp(data, KTX_IDENTIFIER, sizeof(KTX_IDENTIFIER)) != 0) {
+        loggerError("Not a KTX file. file:'%s'", getFilePath().c_str());
+        return false;
+    }
+
+    if (readUint32(data + 12) != KTX_ENDIANNESS) {
+        loggerError("KTX file endianness not supported. file:'%s'", getFilePath().c_str());
+        return false;
+    }
+
+    uint32_t glType = readUint32(data + 16);
+    uint32_t glInternalFormat = readUint32(data + 28);
+    int width = static_cast<int>(readUint32(data + 36));
+    int height = static_cast<int>(readUint32(data + 40));
+    uint32_t depth = readUint32(data + 44);
+    uint32_t arrayElements = readUint32(data + 48);
+    uint32_t faces = readUint32(data + 52);
+    uint32_t mipmapLevels = std::max(readUint32(data + 56), 1u);
+    uint32_t keyValueDataSize = readUint32(data + 60);
+
+    compression = getKtxCompression(glInternalFormat);
+    if (glType != 0 || compression == TextureCompression::NONE) {
+        loggerError("KTX texture format not supported, only BC1-BC7 compressed formats are supported. file:'%s', glType:0x%X, glInternalFormat:0x%X",
+            getFilePath().c_str(), glType, glInternalFormat);
+        return false;
+    }
+
+    if (depth > 1 || arrayElements > 0 || faces != 1) {
+        loggerError("Only 2D KTX textures are supported. file:'%s', depth:%u, arrayElements:%u, faces:%u",
+            getFilePath().c_str(), depth, arrayElements, faces);
+        return false;
+    }
+
+    size_t position = KTX_HEADER_SIZE + keyValueDataSize;
+    for (uint32_t level = 0; level < mipmapLevels; level++) {
+        if (position + sizeof(uint32_t) > dataLength) {
+            loggerError("KTX file is truncated. file:'%s', level:%u", getFilePath().c_str(), level);
+            return false;
+        }
+
+        size_t imageSize = static_cast<size_t>(readUint32(data + position));
+        position += sizeof(uint32_t);
+
+        CompressedTextureLevel textureLevel;
+        textureLevel.width = std::max(1, width >> level);
+        textureLevel.height = std::max(1, height >> level);
+        textureLevel.size = imageSize;
+        textureLevel.data = data + position;
+
+        if (imageSize < getLevelSize(compression, textureLevel.width, textureLevel.height) || position + imageSize > dataLength) {
+            loggerError("KTX file is truncated. file:'%s', level:%u", getFilePath().c_str(), level);
+            return false;
+        }
+
+        levels.push_back(textureLevel);
+
+        // mip padding
+        position += (imageSize + 3) & ~static_cast<size_t>(3);
+    }
+
+    return true;
+}
+
+bool ImageCompressed::parseDds(TextureCompression& compression, std::vector<CompressedTextureLevel>& levels) {
+    const size_t DDS_HEADER_SIZE = 4 + 124;
+    const size_t DDS_HEADER_DX10_SIZE = 20;
+    const uint32_t DDSD_MIPMAPCOUNT = 0x20000;
+    const uint32_t DDPF_FOURCC = 0x4;
+    const uint32_t DDSCAPS2_CUBEMAP = 0x200;
+    const uint32_t DDSCAPS2_VOLUME = 0x200000;
+
+    const unsigned char *data = getData();
+    size_t dataLength = length();
+
+    if (dataLength < DDS_HEADER_SIZE || readUint32(data) != fourCc("DDS ")) {
+        loggerError("Not a DDS file. file:'%s'", getFilePath().c_str());
+        return false;
+    }
+
+    uint32_t flags = readUint32(data + 8);
+    int height = static_cast<int>(readUint32(data + 12));
+    int width = static_cast<int>(readUint32(data + 16));
+    uint32_t mipmapLevels = 1;
+    if (flags & DDSD_MIPMAPCOUNT) {
+        mipmapLevels = std::max(readUint32(data + 28), 1u);
+    }
+    uint32_t pixelFormatFlags = readUint32(data + 80);
+    uint32_t pixelFormatFourCc = readUint32(data + 84);
+    uint32_t caps2 = readUint32(data + 112);
+
+    if (caps2 & (DDSCAPS2_CUBEMAP | DDSCAPS2_VOLUME)) {
+        loggerError("Only 2D DDS textures are supported. file:'%s'", getFilePath().c_str());
+        return false;
+    }
+
+    if (!(pixelFormatFlags & DDPF_FOURCC)) {
+        loggerError("Uncompressed DDS textures are not supported. file:'%s'", getFilePath().c_str());
+        return false;
+    }
+
+    size_t position = DDS_HEADER_SIZE;
+    if (pixelFormatFourCc == fourCc("DX10")) {
+        if (dataLength < DDS_HEADER_SIZE + DDS_HEADER_DX10_SIZE) {
+            loggerError("DDS file is truncated. file:'%s'", getFilePath().c_str());
+            return false;
+        }
+
+        uint32_t dxgiFormat = readUint32(data + position);
+        uint32_t arraySize = readUint32(data + position + 12);
+        if (arraySize > 1) {
+            loggerError("DDS texture arrays are not supported. file:'%s', arraySize:%u", getFilePath().c_str(), arraySize);
+            return false;
+        }
+
+        compression = getDxgiCompression(dxgiFormat);
+        position += DDS_HEADER_DX10_SIZE;
+    } else {
+        compression = getFourCcCompression(pixelFormatFourCc);
+    }
+
+    if (compression == TextureCompression::NONE) {
+        loggerError("DDS texture format not supported, only BC1-BC7 compressed formats are supported. file:'%s'", getFilePath().c_str());
+        return false;
+    }
+
+    for (uint32_t level = 0; level < mipmapLevels; level++) {
+        CompressedTextureLevel textureLevel;
+        textureLevel.width = std::max(1, width >> level);
+        textureLevel.height = std::max(1, height >> level);
+        textureLevel.size = getLevelSize(compression, textureLevel.width, textureLevel.height);
+        textureLevel.data = data + position;
+
+        if (position + textureLevel.size > dataLength) {
+            loggerError("DDS file is truncated. file:'%s', level:%u", getFilePath().c_str(), level);
+            return false;
+        }
+
+        levels.push_back(textureLevel);
+        position += textureLevel.size;
+    }
+
+    return true;
+}
+
+bool ImageCompressed::load(bool rollback) {
+    loadLastModified = lastModified();
+
+    if (!isFile()) {
+        loggerError("Not a file. file:'%s'", getFilePath().c_str());
+        return false;
+    }
+
+    if (!isSupported()) {
+        loggerError("File type not supported. file:'%s'", getFilePath().c_str());
+        return false;
+    }
+
+    if (!loadRaw()) {
+        loggerError("Could not load file. file:'%s'", getFilePath().c_str());
+        return false;
+    }
+
+    TextureCompression compression = TextureCompression::NONE;
+    std::vector<CompressedTextureLevel> levels;
+
+    bool parsed = false;
+    if (getLowerCaseExtension(getFilePath()) == "ktx") {
+        parsed = parseKtx(compression, levels);
+    } else {
+        parsed = parseDds(compression, levels);
+    }
+
+    if (!parsed) {
+        return false;
+    }
+
+    // NOTE: Compressed blocks are not flipped, textures need to be stored with bottom-left origin
+    setWidth(levels[0].width);
+    setHeight(levels[0].height);
+
+    if (texture == NULL) {
+        texture = Texture::newInstance();
+    }
+
+    if (texture->createCompressed(compression, levels) == false) {
+        loggerError("Could not load image, error creating texture. file:'%s' width:%d, height:%d, texture:0x%p",
+            getFilePath().c_str(), width, height, texture);
+        return false;
+    }
+
+    if (getFileScope() == FileScope::CONSTANT) {
+        loggerDebug("Loaded compressed image. file:'%s' width:%d, height:%d, levels:%u, texture:0x%p",
+            getFilePath().c_str(), width, height, levels.size(), texture);
+    } else {
+        loggerInfo("Loaded compressed image. file:'%s' width:%d, height:%d, levels:%u, texture:0x%p",
+            getFilePath().c_str(), width, height, levels.size(), texture);
+    }
+
+    return true;
+}
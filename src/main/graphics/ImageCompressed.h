@@ -0,0 +1,25 @@
+#ifndef ENGINE_GRAPHICS_IMAGECOMPRESSED_H_
+#define ENGINE_GRAPHICS_IMAGECOMPRESSED_H_
+
+#include "Image.h"
+#include "Texture.h"
+
+#include <vector>
+
+/**
+ * Pre-compressed GPU texture in KTX (version 1) or DDS container.
+ * Stored mip chain is uploaded as-is, no decoding or mipmap generation is done at runtime.
+ */
+class ImageCompressed : public Image {
+public:
+    explicit ImageCompressed(std::string filePath);
+    ~ImageCompressed();
+    bool load(bool rollback=false);
+    bool isSupported();
+    static bool isCompressedFile(const std::string& filePath);
+private:
+    bool parseKtx(TextureCompression& compression, std::vector<CompressedTextureLevel>& levels);
+    bool parseDds(TextureCompression& compression, std::vector<CompressedTextureLevel>& levels);
+};
+
+#endif /*ENGINE_GRAPHICS_IMAGECOMPRESSED_H_*/
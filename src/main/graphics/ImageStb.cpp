@@ -1,7 +1,9 @@
 #include "ImageStb.h"
+#include "ImageCompressed.h"
 
 #include "graphics/Texture.h"
 #include "logger/logger.h"
+#include "Settings.h"
 
 #define STBI_ONLY_PNG
 #define STB_IMAGE_IMPLEMENTATION
@@ -13,7 +15,12 @@
 #include <algorithm>
 
 Image* Image::newInstance(std::string filePath) {
-    Image *image = new ImageStb(filePath);
+    Image *image = NULL;
+    if (ImageCompressed::isCompressedFile(filePath)) {
+        image = new ImageCompressed(filePath);
+    } else {
+        image = new ImageStb(filePath);
+    }
     if (image == NULL) {
         loggerFatal("Could not allocate memory for image file:'%s'", filePath.c_str());
         return NULL;
@@ -120,8 +127,20 @@ bool ImageStb::load(bool rollback) {
     int width = 0;
     int height = 0;
     int channels = 0;
-    const int FORCE_RGBA = 4;
-    unsigned char *data = stbi_load_from_memory(getData(), static_cast<int>(length()), &width, &height, &channels, FORCE_RGBA);
+    stbi_info_from_memory(getData(), static_cast<int>(length()), &width, &height, &channels);
+
+    // gray scale images are stored with one or two channels, everything else is RGBA
+    int requestedChannels = 4;
+    TextureFormat format = TextureFormat::RGBA;
+    if (channels == 1) {
+        requestedChannels = 1;
+        format = TextureFormat::LUMINANCE;
+    } else if (channels == 2) {
+        requestedChannels = 2;
+        format = TextureFormat::LUMINANCE_ALPHA;
+    }
+
+    unsigned char *data = stbi_load_from_memory(getData(), static_cast<int>(length()), &width, &height, &channels, requestedChannels);
     setWidth(width);
     setHeight(height);
 
@@ -129,6 +148,9 @@ bool ImageStb::load(bool rollback) {
         texture = Texture::newInstance();
     }
 
+    texture->setFormat(format);
+    texture->setSrgb(Settings::demo.graphics.srgbImages);
+
     if (texture->create(width, height, data) == false) {
         loggerError("Could not load image, error creating texture. file:'%s' width:%d, height:%d, texture:0x%p",
             getFilePath().c_str(), width, height, texture);
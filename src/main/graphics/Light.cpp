@@ -7,6 +7,7 @@
 Light::Light() {
     setType(LightType::DIRECTIONAL);
     generateShadowMap = false;
+    range = 0.0;
 }
 
 std::string Light::toString() const {
@@ -28,6 +29,7 @@ std::string Light::toString() const {
             break;
     }
     ss << ", shadows: " << generateShadowMap;
+    ss << ", range: " << range;
     ss << ", position: x:" << position.x << ", y:" << position.y << ", z:" << position.z;
     ss << ", direction: x:" << direction.x << ", y:" << direction.y << ", z:" << direction.z;
     ss << ", ambient: r:" << ambient.r << ", g:" << ambient.g << ", b:" << ambient.b << ", a:" << ambient.a;
@@ -105,6 +107,18 @@ const Color& Light::getSpecular() const {
     return specular;
 }
 
+void Light::setRange(double range) {
+    if (range < 0.0) {
+        loggerWarning("Light range can't be negative. range:%.2f", range);
+        return;
+    }
+    this->range = range;
+}
+
+double Light::getRange() const {
+    return range;
+}
+
 void Light::setGenerateShadowMap(bool generateShadowMap) {
     if (generateShadowMap && type != LightType::SPOT) {
         loggerWarning("Shadow maps can't be generated from this type of light! %s", toString().c_str());
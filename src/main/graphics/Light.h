@@ -38,6 +38,9 @@ public:
     void setSpecular(double r, double g, double b, double a);
     const Color& getSpecular() const;
 
+    void setRange(double range);
+    double getRange() const;
+
     void setGenerateShadowMap(bool generateShadowMap);
     bool getGenerateShadowMap() const;
 private:
@@ -46,6 +49,8 @@ private:
     LightType type;
 
     bool generateShadowMap;
+    // distance of the light's influence, 0 is unlimited
+    double range;
 
     Vector3 direction;
     Vector3 position;
@@ -0,0 +1,350 @@
+#include "ParticleSystem.h"
+
+#include <vector>
+#include <cmath>
+
+#include "graphics/Graphics.h"
+#include "graphics/Shader.h"
+#include "graphics/ShaderProgram.h"
+#include "graphics/ShaderProgramOpenGl.h"
+#include "graphics/Texture.h"
+#include "io/MemoryManager.h"
+#include "logger/logger.h"
+
+// NOTE: Hard-coded values in GLSL
+#define PARTICLE_POSITION_ATTRIB 0
+#define PARTICLE_VELOCITY_ATTRIB 1
+// position + age, velocity + life time
+#define PARTICLE_FLOAT_COUNT 8
+
+// Longer frame gaps (seeking, hitches) are clamped so that particles do not jump
+#define MAX_DELTA_TIME 0.1
+
+static void setUniform1f(const char *name, double value) {
+    GLint location = ShaderProgramOpenGl::getUniformLocation(name);
+    if (location != -1) {
+        glUniform1f(location, static_cast<float>(value));
+    }
+}
+
+static void setUniform1i(const char *name, int value) {
+    GLint location = ShaderProgramOpenGl::getUniformLocation(name);
+    if (location != -1) {
+        glUniform1i(location, value);
+    }
+}
+
+static void setUniform3f(const char *name, const Vector3& value) {
+    GLint location = ShaderProgramOpenGl::getUniformLocation(name);
+    if (location != -1) {
+        glUniform3f(location, static_cast<float>(value.x), static_cast<float>(value.y), static_cast<float>(value.z));
+    }
+}
+
+static void setUniform4f(const char *name, const Color& value) {
+    GLint location = ShaderProgramOpenGl::getUniformLocation(name);
+    if (location != -1) {
+        glUniform4f(location, static_cast<float>(value.r), static_cast<float>(value.g), static_cast<float>(value.b), static_cast<float>(value.a));
+    }
+}
+
+ParticleSystem::ParticleSystem(unsigned int particleCount) {
+    this->particleCount = particleCount;
+    buffers[0] = buffers[1] = 0;
+    vertexArrays[0] = vertexArrays[1] = 0;
+    current = 0;
+    updateShaderProgram = NULL;
+    drawShaderProgram = NULL;
+
+    lastTime = 0.0;
+    timeSet = false;
+    emitAccumulator = 0.0;
+    emitCursor = 0;
+
+    emitRate = 100.0;
+    lifeTime = 1.0;
+    lifeTimeRandomness = 0.0;
+    position = Vector3(0.0, 0.0, 0.0);
+    positionRandomness = Vector3(0.0, 0.0, 0.0);
+    velocity = Vector3(0.0, 1.0, 0.0);
+    velocityRandomness = Vector3(0.0, 0.0, 0.0);
+    gravity = Vector3(0.0, 0.0, 0.0);
+    drag = 0.0;
+    startColor = Color(1.0, 1.0, 1.0, 1.0);
+    endColor = Color(1.0, 1.0, 1.0, 0.0);
+    startSize = 0.1;
+    endSize = 0.1;
+    texture = NULL;
+}
+
+ParticleSystem::~ParticleSystem() {
+    free();
+}
+
+ShaderProgram* ParticleSystem::getShaderProgram(const char *name, const char *vertexShaderPath, const char *fragmentShaderPath, bool transformFeedback) {
+    MemoryManager<ShaderProgram>& shaderProgramMemory = MemoryManager<ShaderProgram>::getInstance();
+    ShaderProgram *program = shaderProgramMemory.getResource(std::string(name), true);
+    if (program->isLinked()) {
+        return program;
+    }
+
+    MemoryManager<Shader>& shaderMemory = MemoryManager<Shader>::getInstance();
+    Shader *vertexShader = shaderMemory.getResource(std::string(vertexShaderPath), true);
+    if (!vertexShader->load()) {
+        loggerError("Could not compile particle shader. shader:'%s'", vertexShaderPath);
+        return NULL;
+    }
+    program->addShader(vertexShader);
+
+    if (fragmentShaderPath) {
+        Shader *fragmentShader = shaderMemory.getResource(std::string(fragmentShaderPath), true);
+        if (!fragmentShader->load()) {
+            loggerError("Could not compile particle shader. shader:'%s'", fragmentShaderPath);
+            return NULL;
+        }
+        program->addShader(fragmentShader);
+    }
+
+    if (transformFeedback) {
+        dynamic_cast<ShaderProgramOpenGl*>(program)->setTransformFeedbackVaryings({"feedbackPosition", "feedbackVelocity"});
+    }
+
+    if (!program->link()) {
+        loggerError("Could not link particle shader program. program:'%s'", name);
+        return NULL;
+    }
+
+    return program;
+}
+
+bool ParticleSystem::generate() {
+    PROFILER_BLOCK("ParticleSystem::generate");
+
+    free();
+
+    if (particleCount == 0) {
+        loggerWarning("Particle system has no particles, can't generate. ptr:0x%p", this);
+        return false;
+    }
+
+    updateShaderProgram = getShaderProgram("DefaultParticleUpdate", "_embedded/particleUpdate.vs", NULL, true);
+    drawShaderProgram = getShaderProgram("DefaultParticle", "_embedded/particle.vs", "_embedded/particle.fs", false);
+    if (updateShaderProgram == NULL || drawShaderProgram == NULL) {
+        return false;
+    }
+
+    glGenBuffers(2, buffers);
+    glGenVertexArrays(2, vertexArrays);
+    if (buffers[0] == 0 || buffers[1] == 0 || vertexArrays[0] == 0 || vertexArrays[1] == 0) {
+        loggerWarning("Could not generate buffers for particle system. particles:%u", particleCount);
+        return false;
+    }
+
+    // all particles start dead (age >= life time)
+    std::vector<float> particles(particleCount * PARTICLE_FLOAT_COUNT, 0.0f);
+
+    const GLsizei stride = PARTICLE_FLOAT_COUNT * sizeof(float);
+    for (unsigned int i = 0; i < 2; i++) {
+        glBindVertexArray(vertexArrays[i]);
+        glBindBuffer(GL_ARRAY_BUFFER, buffers[i]);
+        glBufferData(GL_ARRAY_BUFFER, particles.size() * sizeof(float), &particles[0], GL_DYNAMIC_COPY);
+
+        glEnableVertexAttribArray(PARTICLE_POSITION_ATTRIB);
+        glVertexAttribPointer(PARTICLE_POSITION_ATTRIB, 4, GL_FLOAT, GL_FALSE, stride, NULL);
+        glEnableVertexAttribArray(PARTICLE_VELOCITY_ATTRIB);
+        glVertexAttribPointer(PARTICLE_VELOCITY_ATTRIB, 4, GL_FLOAT, GL_FALSE, stride, (const GLvoid*)(4 * sizeof(float)));
+    }
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    current = 0;
+    timeSet = false;
+    emitAccumulator = 0.0;
+    emitCursor = 0;
+
+    Graphics &graphics = Graphics::getInstance();
+    if (graphics.handleErrors()) {
+        loggerError("Could not generate particle system. particles:%u", particleCount);
+        return false;
+    }
+
+    loggerTrace("Particle system generated. ptr:0x%p, particles:%u", this, particleCount);
+
+    return true;
+}
+
+void ParticleSystem::free() {
+    if (vertexArrays[0] != 0) {
+        glBindVertexArray(0);
+        glDeleteVertexArrays(2, vertexArrays);
+        vertexArrays[0] = vertexArrays[1] = 0;
+    }
+
+    if (buffers[0] != 0) {
+        glDeleteBuffers(2, buffers);
+        buffers[0] = buffers[1] = 0;
+    }
+}
+
+bool ParticleSystem::isGenerated() {
+    return vertexArrays[0] != 0;
+}
+
+void ParticleSystem::reset() {
+    if (!isGenerated()) {
+        return;
+    }
+
+    generate();
+}
+
+void ParticleSystem::update(double time) {
+    PROFILER_BLOCK("ParticleSystem::update");
+
+    if (!isGenerated() && !generate()) {
+        return;
+    }
+
+    if (timeSet && time < lastTime) {
+        // time went backwards (seek / loop), start the simulation from scratch
+        reset();
+    }
+
+    double deltaTime = timeSet ? time - lastTime : 0.0;
+    if (deltaTime > MAX_DELTA_TIME) {
+        deltaTime = MAX_DELTA_TIME;
+    }
+    lastTime = time;
+    timeSet = true;
+
+    emitAccumulator += emitRate * deltaTime;
+    unsigned int emitCount = 0;
+    if (emitAccumulator >= 1.0) {
+        double emitParticles = std::floor(emitAccumulator);
+        emitAccumulator -= emitParticles;
+        emitCount = emitParticles >= particleCount ? particleCount : static_cast<unsigned int>(emitParticles);
+    }
+
+    if (deltaTime <= 0.0 && emitCount == 0) {
+        return;
+    }
+
+    updateShaderProgram->bind();
+    setUniform1f("deltaTime", deltaTime);
+    setUniform1f("seed", std::fmod(time, 1000.0));
+    setUniform1i("particleCount", particleCount);
+    setUniform1i("emitBegin", emitCursor);
+    setUniform1i("emitCount", emitCount);
+    setUniform3f("emitterPosition", position);
+    setUniform3f("emitterPositionRandomness", positionRandomness);
+    setUniform3f("emitterVelocity", velocity);
+    setUniform3f("emitterVelocityRandomness", velocityRandomness);
+    setUniform1f("lifeTime", lifeTime);
+    setUniform1f("lifeTimeRandomness", lifeTimeRandomness);
+    setUniform3f("gravity", gravity);
+    setUniform1f("drag", drag);
+
+    unsigned int next = 1 - current;
+
+    glEnable(GL_RASTERIZER_DISCARD);
+    glBindVertexArray(vertexArrays[current]);
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, buffers[next]);
+    glBeginTransformFeedback(GL_POINTS);
+    glDrawArrays(GL_POINTS, 0, particleCount);
+    glEndTransformFeedback();
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+    glBindVertexArray(0);
+    glDisable(GL_RASTERIZER_DISCARD);
+
+    updateShaderProgram->unbind();
+
+    current = next;
+    emitCursor = (emitCursor + emitCount) % particleCount;
+}
+
+void ParticleSystem::draw() {
+    PROFILER_BLOCK("ParticleSystem::draw");
+
+    if (!isGenerated()) {
+        return;
+    }
+
+    GLint viewport[4] = {0, 0, 0, 0};
+    glGetIntegerv(GL_VIEWPORT, viewport);
+
+    drawShaderProgram->bind();
+    setUniform4f("startColor", startColor);
+    setUniform4f("endColor", endColor);
+    setUniform1f("startSize", startSize);
+    setUniform1f("endSize", endSize);
+    setUniform1f("viewportHeight", viewport[3]);
+    setUniform1i("enableTexture", texture ? 1 : 0);
+    if (texture) {
+        texture->bind(0);
+    }
+
+    glEnable(GL_PROGRAM_POINT_SIZE);
+    glBindVertexArray(vertexArrays[current]);
+    glDrawArrays(GL_POINTS, 0, particleCount);
+    glBindVertexArray(0);
+    glDisable(GL_PROGRAM_POINT_SIZE);
+
+    if (texture) {
+        texture->unbind(0);
+    }
+    drawShaderProgram->unbind();
+}
+
+unsigned int ParticleSystem::getParticleCount() {
+    return particleCount;
+}
+
+void ParticleSystem::setEmitRate(double particlesPerSecond) {
+    emitRate = particlesPerSecond > 0.0 ? particlesPerSecond : 0.0;
+}
+
+void ParticleSystem::setLifeTime(double seconds, double randomness) {
+    lifeTime = seconds;
+    lifeTimeRandomness = randomness;
+}
+
+void ParticleSystem::setPosition(double x, double y, double z) {
+    position = Vector3(x, y, z);
+}
+
+void ParticleSystem::setPositionRandomness(double x, double y, double z) {
+    positionRandomness = Vector3(x, y, z);
+}
+
+void ParticleSystem::setVelocity(double x, double y, double z) {
+    velocity = Vector3(x, y, z);
+}
+
+void ParticleSystem::setVelocityRandomness(double x, double y, double z) {
+    velocityRandomness = Vector3(x, y, z);
+}
+
+void ParticleSystem::setGravity(double x, double y, double z) {
+    gravity = Vector3(x, y, z);
+}
+
+void ParticleSystem::setDrag(double drag) {
+    this->drag = drag;
+}
+
+void ParticleSystem::setStartColor(double r, double g, double b, double a) {
+    startColor = Color(r, g, b, a);
+}
+
+void ParticleSystem::setEndColor(double r, double g, double b, double a) {
+    endColor = Color(r, g, b, a);
+}
+
+void ParticleSystem::setSize(double startSize, double endSize) {
+    this->startSize = startSize;
+    this->endSize = endSize;
+}
+
+void ParticleSystem::setTexture(Texture *texture) {
+    this->texture = texture;
+}
@@ -0,0 +1,71 @@
+#ifndef ENGINE_GRAPHICS_PARTICLESYSTEM_H_
+#define ENGINE_GRAPHICS_PARTICLESYSTEM_H_
+
+#include "GL/gl3w.h"
+#include "graphics/datatypes.h"
+
+class Texture;
+class ShaderProgram;
+
+/**
+ * GPU particle emitter. Particle positions and velocities are simulated with transform feedback
+ * between two ping-pong buffers and drawn as point sprites. Emission is a ring over the particle
+ * buffer, so the oldest particles are recycled first.
+ */
+class ParticleSystem {
+public:
+    explicit ParticleSystem(unsigned int particleCount);
+    ~ParticleSystem();
+
+    bool generate();
+    void free();
+    bool isGenerated();
+    void reset();
+    void update(double time);
+    void draw();
+
+    unsigned int getParticleCount();
+    void setEmitRate(double particlesPerSecond);
+    void setLifeTime(double seconds, double randomness = 0.0);
+    void setPosition(double x, double y, double z);
+    void setPositionRandomness(double x, double y, double z);
+    void setVelocity(double x, double y, double z);
+    void setVelocityRandomness(double x, double y, double z);
+    void setGravity(double x, double y, double z);
+    void setDrag(double drag);
+    void setStartColor(double r, double g, double b, double a = 1.0);
+    void setEndColor(double r, double g, double b, double a = 1.0);
+    void setSize(double startSize, double endSize);
+    void setTexture(Texture *texture);
+private:
+    static ShaderProgram* getShaderProgram(const char *name, const char *vertexShaderPath, const char *fragmentShaderPath, bool transformFeedback);
+
+    unsigned int particleCount;
+    GLuint buffers[2];
+    GLuint vertexArrays[2];
+    unsigned int current;
+    ShaderProgram *updateShaderProgram;
+    ShaderProgram *drawShaderProgram;
+
+    double lastTime;
+    bool timeSet;
+    double emitAccumulator;
+    unsigned int emitCursor;
+
+    double emitRate;
+    double lifeTime;
+    double lifeTimeRandomness;
+    Vector3 position;
+    Vector3 positionRandomness;
+    Vector3 velocity;
+    Vector3 velocityRandomness;
+    Vector3 gravity;
+    double drag;
+    Color startColor;
+    Color endColor;
+    double startSize;
+    double endSize;
+    Texture *texture;
+};
+
+#endif /*ENGINE_GRAPHICS_PARTICLESYSTEM_H_*/
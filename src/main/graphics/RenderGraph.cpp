@@ -0,0 +1,100 @@
+#include "RenderGraph.h"
+
+#include "Settings.h"
+#include "logger/logger.h"
+
+#include <set>
+
+RenderGraph& RenderGraph::getInstance() {
+    static RenderGraph renderGraph;
+    return renderGraph;
+}
+
+RenderGraph::RenderGraph() {
+    culledCount = 0;
+}
+
+void RenderGraph::clear() {
+    passes.clear();
+    culledCount = 0;
+}
+
+unsigned int RenderGraph::addPass(const std::string& output, bool cullable) {
+    Pass pass;
+    pass.output = output;
+    pass.cullable = cullable && !output.empty();
+    pass.culled = false;
+    passes.push_back(pass);
+
+    return static_cast<unsigned int>(passes.size() - 1);
+}
+
+void RenderGraph::addInput(unsigned int pass, const std::string& input) {
+    if (pass >= passes.size()) {
+        loggerWarning("Invalid render pass. pass:%u, passes:%u", pass, getPassCount());
+        return;
+    }
+
+    passes[pass].inputs.push_back(input);
+}
+
+void RenderGraph::compile() {
+    PROFILER_BLOCK("RenderGraph::compile");
+
+    culledCount = 0;
+
+    if (!Settings::demo.graphics.renderPassCulling) {
+        for (Pass &pass : passes) {
+            pass.culled = false;
+        }
+
+        return;
+    }
+
+    // targets read by passes that reach the screen, reads from the previous frame are included
+    std::set<std::string> neededTargets;
+    for (Pass &pass : passes) {
+        pass.culled = pass.cullable;
+        if (!pass.culled) {
+            neededTargets.insert(pass.inputs.begin(), pass.inputs.end());
+        }
+    }
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (Pass &pass : passes) {
+            if (pass.culled && neededTargets.count(pass.output) > 0) {
+                pass.culled = false;
+                neededTargets.insert(pass.inputs.begin(), pass.inputs.end());
+                changed = true;
+            }
+        }
+    }
+
+    for (Pass &pass : passes) {
+        if (pass.culled) {
+            culledCount++;
+        }
+    }
+
+    if (culledCount > 0) {
+        loggerTrace("Culled render passes. passes:%u, culled:%u", getPassCount(), culledCount);
+    }
+}
+
+bool RenderGraph::isCulled(unsigned int pass) {
+    if (pass >= passes.size()) {
+        return false;
+    }
+
+    return passes[pass].culled;
+}
+
+unsigned int RenderGraph::getPassCount() {
+    return static_cast<unsigned int>(passes.size());
+}
+
+unsigned int RenderGraph::getCulledCount() {
+    return culledCount;
+}
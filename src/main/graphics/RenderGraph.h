@@ -0,0 +1,35 @@
+#ifndef ENGINE_GRAPHICS_RENDERGRAPH_H_
+#define ENGINE_GRAPHICS_RENDERGRAPH_H_
+
+#include <string>
+#include <vector>
+
+/**
+ * Per frame graph of render passes and the render targets they read and write.
+ * Passes whose output does not reach the screen, directly or through other passes, are culled.
+ * Screen output is marked with an empty target name.
+ */
+class RenderGraph {
+public:
+    static RenderGraph& getInstance();
+    RenderGraph();
+    void clear();
+    unsigned int addPass(const std::string& output, bool cullable = true);
+    void addInput(unsigned int pass, const std::string& input);
+    void compile();
+    bool isCulled(unsigned int pass);
+    unsigned int getPassCount();
+    unsigned int getCulledCount();
+private:
+    struct Pass {
+        std::string output;
+        std::vector<std::string> inputs;
+        bool cullable;
+        bool culled;
+    };
+
+    std::vector<Pass> passes;
+    unsigned int culledCount;
+};
+
+#endif /*ENGINE_GRAPHICS_RENDERGRAPH_H_*/
@@ -0,0 +1,258 @@
+#include "RenderQueue.h"
+
+#include "Graphics.h"
+#include "ShaderProgramOpenGl.h"
+#include "TextureOpenGl.h"
+#include "graphics/model/Mesh.h"
+#include "graphics/model/Material.h"
+#include "math/TransformationMatrix.h"
+#include "logger/logger.h"
+
+#include "GL/gl3w.h"
+
+#include <algorithm>
+#include <functional>
+#include <string.h>
+
+static void setMatrixMode(TransformationMatrix& transformationMatrix, MatrixMode mode) {
+    switch(mode) {
+        case PROJECTION:
+            transformationMatrix.setProjectionMode();
+            break;
+        case VIEW:
+            transformationMatrix.setViewMode();
+            break;
+        case MODEL:
+        default:
+            transformationMatrix.setModelMode();
+            break;
+    }
+}
+
+static void getMatrices(double *projection, double *view, double *model) {
+    TransformationMatrix& transformationMatrix = TransformationMatrix::getInstance();
+    MatrixMode mode = transformationMatrix.getMode();
+
+    transformationMatrix.setProjectionMode();
+    memcpy(projection, transformationMatrix.getMatrix4(), 16 * sizeof(double));
+    transformationMatrix.setViewMode();
+    memcpy(view, transformationMatrix.getMatrix4(), 16 * sizeof(double));
+    transformationMatrix.setModelMode();
+    memcpy(model, transformationMatrix.getMatrix4(), 16 * sizeof(double));
+
+    setMatrixMode(transformationMatrix, mode);
+}
+
+static void setMatrices(const double *projection, const double *view, const double *model, MatrixMode mode) {
+    TransformationMatrix& transformationMatrix = TransformationMatrix::getInstance();
+
+    transformationMatrix.setProjectionMode();
+    transformationMatrix.setMatrix4(projection);
+    transformationMatrix.setViewMode();
+    transformationMatrix.setMatrix4(view);
+    transformationMatrix.setModelMode();
+    transformationMatrix.setMatrix4(model);
+
+    setMatrixMode(transformationMatrix, mode);
+}
+
+RenderQueue& RenderQueue::getInstance() {
+    static RenderQueue renderQueue;
+    return renderQueue;
+}
+
+RenderQueue::RenderQueue() {
+    textureBindStackSize = 0;
+    recording = false;
+    submitting = false;
+    transparent = false;
+}
+
+void RenderQueue::begin() {
+    if (recording) {
+        flush();
+    }
+
+    // textures bound before recording stay bound through the submit
+    textureBindStackSize = TextureOpenGl::getBindStackSize();
+    recording = true;
+    transparent = false;
+}
+
+void RenderQueue::end() {
+    if (!recording) {
+        return;
+    }
+
+    flush();
+    recording = false;
+    transparent = false;
+}
+
+bool RenderQueue::isRecording() {
+    return recording;
+}
+
+void RenderQueue::setTransparent(bool transparent) {
+    this->transparent = transparent;
+}
+
+bool RenderQueue::add(Mesh *mesh, Material *material, bool sharedMeshState, double end, InstanceBuffer *instanceBuffer) {
+    if (!recording || submitting) {
+        return false;
+    }
+
+    // bone palette and instance node transformation are shared by the draws of the mesh and script bound textures are not recorded
+    if (sharedMeshState || TextureOpenGl::getBindStackSize() != textureBindStackSize) {
+        flush();
+        return false;
+    }
+
+    ShaderProgramOpenGl *shaderProgram = ShaderProgramOpenGl::getCurrentBind();
+    if (shaderProgram == NULL) {
+        flush();
+        return false;
+    }
+
+    draws.emplace_back();
+    Draw& draw = draws.back();
+    draw.mesh = mesh;
+    draw.material = material;
+    draw.shaderProgram = shaderProgram;
+    draw.sortProgram = shaderProgram;
+    draw.sortTexture = NULL;
+    if (material) {
+        ShaderProgramOpenGl *materialProgram = dynamic_cast<ShaderProgramOpenGl*>(material->getShaderProgram());
+        if (materialProgram) {
+            draw.sortProgram = materialProgram;
+        }
+        draw.sortTexture = material->getTexture(0);
+    }
+    draw.instanceBuffer = instanceBuffer;
+    draw.end = end;
+    draw.depthTest = glIsEnabled(GL_DEPTH_TEST) == GL_TRUE;
+    draw.color = Graphics::getInstance().getColor();
+
+    getMatrices(draw.projection, draw.view, draw.model);
+
+    // view space depth of the model origin, matrices are in column order
+    double viewZ = 0.0;
+    for (unsigned int i = 0; i < 4; i++) {
+        viewZ += draw.view[i * 4 + 2] * draw.model[12 + i];
+    }
+    draw.depth = -viewZ;
+
+    // draws without depth test or with alpha are order dependent
+    draw.transparent = transparent || !draw.depthTest || draw.color.a < 1.0
+        || (material && material->getDiffuse().a < 1.0);
+
+    return true;
+}
+
+bool RenderQueue::compareDraws(const Draw& a, const Draw& b) {
+    if (a.sortProgram != b.sortProgram) {
+        return std::less<ShaderProgramOpenGl*>()(a.sortProgram, b.sortProgram);
+    }
+    if (a.material != b.material) {
+        return std::less<Material*>()(a.material, b.material);
+    }
+    if (a.sortTexture != b.sortTexture) {
+        return std::less<Texture*>()(a.sortTexture, b.sortTexture);
+    }
+
+    // front-to-back, so that occluded fragments are rejected by the depth test
+    return a.depth < b.depth;
+}
+
+void RenderQueue::bindDrawState(const Draw& draw) {
+    if (draw.material == NULL || draw.material->getShaderProgram() == NULL) {
+        draw.shaderProgram->bind();
+    }
+
+    if (draw.material) {
+        draw.material->bind();
+    }
+}
+
+void RenderQueue::unbindDrawState(const Draw& draw) {
+    if (draw.material) {
+        draw.material->unbind();
+    }
+
+    if (draw.material == NULL || draw.material->getShaderProgram() == NULL) {
+        draw.shaderProgram->unbind();
+    }
+}
+
+void RenderQueue::flush() {
+    if (submitting || draws.empty()) {
+        return;
+    }
+
+    PROFILER_BLOCK("RenderQueue::flush");
+
+    submitting = true;
+
+    Graphics& graphics = Graphics::getInstance();
+    Color color = graphics.getColor();
+    bool depthTest = glIsEnabled(GL_DEPTH_TEST) == GL_TRUE;
+    MatrixMode mode = TransformationMatrix::getInstance().getMode();
+    double projection[16];
+    double view[16];
+    double model[16];
+    getMatrices(projection, view, model);
+
+    submitOrder.clear();
+    for (const Draw& draw : draws) {
+        if (!draw.transparent) {
+            submitOrder.push_back(&draw);
+        }
+    }
+
+    std::stable_sort(submitOrder.begin(), submitOrder.end(), [](const Draw* a, const Draw* b) {
+        return compareDraws(*a, *b);
+    });
+
+    for (const Draw& draw : draws) {
+        if (draw.transparent) {
+            submitOrder.push_back(&draw);
+        }
+    }
+
+    const Draw* boundDraw = NULL;
+    bool currentDepthTest = depthTest;
+    for (const Draw* draw : submitOrder) {
+        // shader program and material are rebound only when they change
+        if (boundDraw == NULL || boundDraw->shaderProgram != draw->shaderProgram || boundDraw->material != draw->material) {
+            if (boundDraw) {
+                unbindDrawState(*boundDraw);
+            }
+            bindDrawState(*draw);
+            boundDraw = draw;
+        }
+
+        if (draw->depthTest != currentDepthTest) {
+            graphics.setDepthTest(draw->depthTest);
+            currentDepthTest = draw->depthTest;
+        }
+
+        graphics.setColor(draw->color);
+        setMatrices(draw->projection, draw->view, draw->model, MODEL);
+        draw->mesh->drawRecorded(draw->end, draw->instanceBuffer);
+    }
+
+    if (boundDraw) {
+        unbindDrawState(*boundDraw);
+    }
+
+    if (currentDepthTest != depthTest) {
+        graphics.setDepthTest(depthTest);
+    }
+    graphics.setColor(color);
+    setMatrices(projection, view, model, mode);
+
+    loggerTrace("Render queue submitted. draws:%u", static_cast<unsigned int>(draws.size()));
+
+    draws.clear();
+    submitting = false;
+}
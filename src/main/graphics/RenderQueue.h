@@ -0,0 +1,66 @@
+#ifndef ENGINE_GRAPHICS_RENDERQUEUE_H_
+#define ENGINE_GRAPHICS_RENDERQUEUE_H_
+
+#include "datatypes.h"
+
+#include <vector>
+
+class Mesh;
+class Material;
+class Texture;
+class InstanceBuffer;
+class ShaderProgramOpenGl;
+
+/**
+ * Opt-in deferred queue of mesh draws.
+ * While recording, mesh draws are stored with their transformation, shader program, material and color.
+ * Opaque draws are submitted sorted by shader program, material, texture and front-to-back depth,
+ * transparent draws are submitted after them in the recorded order.
+ * State that is not recorded (render target, clears, script set uniforms) flushes the queue before it changes.
+ */
+class RenderQueue {
+public:
+    static RenderQueue& getInstance();
+    RenderQueue();
+    void begin();
+    void end();
+    void flush();
+    bool isRecording();
+    void setTransparent(bool transparent);
+    /**
+     * Record mesh draw. Returns false if the draw can't be deferred, queue is flushed and caller should draw immediately.
+     * Draws using per mesh state that changes between the draws of the mesh (bone palette, instance node transformation) can't be deferred.
+     */
+    bool add(Mesh *mesh, Material *material, bool sharedMeshState, double end, InstanceBuffer *instanceBuffer);
+private:
+    struct Draw {
+        Mesh *mesh;
+        Material *material;
+        // program bound when recorded, material may override it
+        ShaderProgramOpenGl *shaderProgram;
+        ShaderProgramOpenGl *sortProgram;
+        Texture *sortTexture;
+        InstanceBuffer *instanceBuffer;
+        double end;
+        double depth;
+        bool depthTest;
+        bool transparent;
+        Color color;
+        double projection[16];
+        double view[16];
+        double model[16];
+    };
+
+    static bool compareDraws(const Draw& a, const Draw& b);
+    void bindDrawState(const Draw& draw);
+    void unbindDrawState(const Draw& draw);
+
+    std::vector<Draw> draws;
+    std::vector<const Draw*> submitOrder;
+    unsigned int textureBindStackSize;
+    bool recording;
+    bool submitting;
+    bool transparent;
+};
+
+#endif /*ENGINE_GRAPHICS_RENDERQUEUE_H_*/
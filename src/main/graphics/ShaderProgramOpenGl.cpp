@@ -14,6 +14,7 @@
 #include "audio/Audio.h"
 #include "sync/Sync.h"
 #include "graphics/LightManager.h"
+#include "graphics/ClusteredLighting.h"
 #include "graphics/Shadow.h"
 #include "graphics/model/Material.h"
 
@@ -22,6 +23,7 @@
 
 #include <string>
 #include <regex>
+#include <algorithm>
 #include <type_traits>
 
 std::vector<ShaderProgramOpenGl*> ShaderProgramOpenGl::bindStack = {};
@@ -47,12 +49,16 @@ void ShaderProgram::useCurrentBind() {
     ShaderProgramOpenGl::useCurrentBind();    
 }
 
-void ShaderProgramOpenGl::useCurrentBind() {
-    ShaderProgramOpenGl *shaderProgram = shaderProgramDefault;
+ShaderProgramOpenGl* ShaderProgramOpenGl::getCurrentBind() {
     if (!bindStack.empty()) {
-        shaderProgram = bindStack.back();
+        return bindStack.back();
     }
 
+    return shaderProgramDefault;
+}
+
+void ShaderProgramOpenGl::useCurrentBind() {
+    ShaderProgramOpenGl *shaderProgram = getCurrentBind();
     if (!shaderProgram) {
         loggerWarning("Shader program is empty");
         return;
@@ -162,7 +168,7 @@ bool ShaderProgramOpenGl::attach() {
         Shader *defaultVs = MemoryManager<Shader>::getInstance().getResource(std::string("_embedded/default.vs"), true);
         addShader(defaultVs);
     }
-    if (! hasFragmentShader) {
+    if (! hasFragmentShader && transformFeedbackVaryings.empty()) {
         Shader *defaultFs = MemoryManager<Shader>::getInstance().getResource(std::string("_embedded/default.fs"), true);
         addShader(defaultFs);
     }
@@ -254,6 +260,15 @@ bool ShaderProgramOpenGl::link() {
         return false;
     }
 
+    if (! transformFeedbackVaryings.empty()) {
+        std::vector<const GLchar*> varyings;
+        for (const std::string& varying : transformFeedbackVaryings) {
+            varyings.push_back(varying.c_str());
+        }
+
+        glTransformFeedbackVaryings(id, varyings.size(), &varyings[0], GL_INTERLEAVED_ATTRIBS);
+    }
+
     glLinkProgram(id);
     linked = checkLinkStatus();
 
@@ -309,6 +324,7 @@ enum class UniformType {
     DOUBLE_MAT4,
     DOUBLE_MAT3,
     TEXTURE,
+    BUFFER_TEXTURE,
     DOUBLE_VEC4,
     DOUBLE_VEC3,
     DOUBLE_VEC2,
@@ -323,6 +339,10 @@ static UniformType getUniformType(GLenum type) {
         case GL_SAMPLER_2D:
         case GL_SAMPLER_3D:
             return UniformType::TEXTURE;
+        case GL_SAMPLER_BUFFER:
+        case GL_INT_SAMPLER_BUFFER:
+        case GL_UNSIGNED_INT_SAMPLER_BUFFER:
+            return UniformType::BUFFER_TEXTURE;
         case GL_FLOAT_MAT4:
         case GL_DOUBLE_MAT4:
             return UniformType::DOUBLE_MAT4;
@@ -538,6 +558,24 @@ void ShaderProgramOpenGl::determineUniforms() {
                         return textureNumber;
                     });
                 }
+            } else if (type == UniformType::BUFFER_TEXTURE) {
+                // Clustered forward lighting buffers, light assignment is updated when the buffers are bound
+                if (name == "clusterLights") {
+                    setUniformFunction1i(name, []() {
+                        ClusteredLighting::getInstance().bind();
+                        return CLUSTERED_LIGHTING_TEXTURE_UNIT_LIGHTS;
+                    });
+                } else if (name == "clusterGrid") {
+                    setUniformFunction1i(name, []() {
+                        ClusteredLighting::getInstance().bind();
+                        return CLUSTERED_LIGHTING_TEXTURE_UNIT_GRID;
+                    });
+                } else if (name == "clusterLightIndices") {
+                    setUniformFunction1i(name, []() {
+                        ClusteredLighting::getInstance().bind();
+                        return CLUSTERED_LIGHTING_TEXTURE_UNIT_INDICES;
+                    });
+                }
             } else if (type == UniformType::DOUBLE_MAT4) {
                 // TODO: Encapsulate OpenGL implementation to a generic form...
                 GLint uniformId = glGetUniformLocation(getId(), name.c_str());
@@ -605,6 +643,24 @@ void ShaderProgramOpenGl::determineUniforms() {
                         return std::array<float, 4>{year, month, day, timeInSeconds};
                     });
                 }
+                // Clustered lighting depth slice scale & bias, near and far depth in .xyzw
+                else if (name == "clusterDepth") {
+                    setUniformFunction4fv(name, []() {
+                        return ClusteredLighting::getInstance().getDepthParameters();
+                    });
+                }
+                // Current viewport x, y, width, height for mapping gl_FragCoord to cluster tiles
+                else if (name == "clusterViewport") {
+                    setUniformFunction4fv(name, []() {
+                        const unsigned int* viewport = Graphics::getInstance().getViewport();
+                        return std::array<float, 4>{
+                            static_cast<float>(viewport[0]),
+                            static_cast<float>(viewport[1]),
+                            static_cast<float>(viewport[2]),
+                            static_cast<float>(viewport[3])
+                        };
+                    });
+                }
                 // TODO: vec4    iMouse    image/buffer    xy = current pixel coords (if LMB is down). zw = click pixel
                 else if (name == "iMouse") {
                     loggerWarning("%s auto-binding not currently supported", name.c_str());
@@ -625,6 +681,17 @@ void ShaderProgramOpenGl::determineUniforms() {
                         return std::array<float, 3>{Settings::demo.graphics.canvasWidth, Settings::demo.graphics.canvasHeight, Settings::demo.graphics.aspectRatio};
                     });
                 }
+                // Clustered lighting grid tiles x, y and depth slices
+                else if (name == "clusterDimensions") {
+                    setUniformFunction3fv(name, []() {
+                        const ClusteredLightingSettings& settings = Settings::demo.graphics.clusteredLighting;
+                        return std::array<float, 3>{
+                            static_cast<float>(std::max(settings.tilesX, 1u)),
+                            static_cast<float>(std::max(settings.tilesY, 1u)),
+                            static_cast<float>(std::max(settings.depthSlices, 1u))
+                        };
+                    });
+                }
             } else if (type == UniformType::DOUBLE) {
                 // Current time in seconds
                 if (name == "time" || name == "iTime") {
@@ -817,6 +884,10 @@ GLuint ShaderProgramOpenGl::getId() {
     return id;
 }
 
+void ShaderProgramOpenGl::setTransformFeedbackVaryings(const std::vector<std::string>& varyings) {
+    transformFeedbackVaryings = varyings;
+}
+
 GLint ShaderProgramOpenGl::getUniformLocation(const char* variable) {
     GLuint currentBindId = getCurrentBindId();
     if (currentBindId == 0) {
@@ -22,9 +22,15 @@ public:
     void bind();
     void unbind();
     GLuint getId();
+    /**
+     * Capture the given vertex shader outputs into transform feedback buffers (interleaved).
+     * Must be set before linking. Programs with feedback varyings are not given a default fragment shader.
+     */
+    void setTransformFeedbackVaryings(const std::vector<std::string>& varyings);
     bool containsUniform(std::string uniformKey);
     static GLint getUniformLocation(const char* variable);
     static void useCurrentBind();
+    static ShaderProgramOpenGl* getCurrentBind();
 protected:
     bool generate();
     bool attach();
@@ -45,6 +51,7 @@ private:
     static GLuint getCurrentBindId();
     static std::vector<ShaderProgramOpenGl*> bindStack;
     std::vector<ShaderOpenGl*> shaders;
+    std::vector<std::string> transformFeedbackVaryings;
     static ShaderProgramOpenGl* shaderProgramDefault;
     static ShaderProgramOpenGl* shaderProgramDefaultShadow;
 };
@@ -18,6 +18,7 @@ Text::Text(std::string text) {
     setColor(1.0, 1.0, 1.0, 1.0);
     setPerspective2d(true);
     setAngle(0.0, 0.0, 0.0);
+    setSdf(false);
 }
 
 void Text::setFont(Font* font) {
@@ -61,6 +62,20 @@ void Text::setText(std::string text) {
     this->text = text;
 }
 
+void Text::setSdf(bool sdf) {
+    this->sdf = sdf;
+}
+
+void Text::setOutline(double width, double r, double g, double b, double a) {
+    sdfEffect.outlineWidth = width;
+    sdfEffect.outlineColor = Color(r, g, b, a);
+}
+
+void Text::setGlow(double width, double r, double g, double b, double a) {
+    sdfEffect.glowWidth = width;
+    sdfEffect.glowColor = Color(r, g, b, a);
+}
+
 void Text::draw() {
     if (font == NULL) {
         loggerWarning("Could not initialize font!");
@@ -84,5 +99,9 @@ void Text::draw() {
 
     ShaderProgram::useCurrentBind();
 
-    font->drawText(0, 0, 0, fontSize, text);
+    if (sdf) {
+        font->drawTextSdf(0, 0, 0, fontSize, text, sdfEffect);
+    } else {
+        font->drawText(0, 0, 0, fontSize, text);
+    }
 }
@@ -4,8 +4,7 @@
 #include <string>
 
 #include "datatypes.h"
-
-class Font;
+#include "Font.h"
 
 class Text {
 public:
@@ -18,6 +17,9 @@ public:
     void setAngle(double x, double y, double z);
     void setColor(double r, double g, double b, double a);
     void setText(std::string text);
+    void setSdf(bool sdf);
+    void setOutline(double width, double r, double g, double b, double a);
+    void setGlow(double width, double r, double g, double b, double a);
     void draw();
 private:
     Font* font;
@@ -28,6 +30,8 @@ private:
     double r, g, b, a;
     double degreesX, degreesY, degreesZ;
     bool perspective2d;
+    bool sdf;
+    FontSdfEffect sdfEffect;
     std::string text;
 };
 
@@ -4,6 +4,14 @@
 #include "datatypes.h"
 
 #include <cstddef>
+#include <vector>
+
+struct CompressedTextureLevel {
+    int width;
+    int height;
+    size_t size;
+    const void *data;
+};
 
 class Texture {
 public:
@@ -16,11 +24,15 @@ public:
     virtual void unbind(unsigned int textureUnit = 0) = 0;
     virtual void setType(TextureType type) = 0;
     virtual void setFormat(TextureFormat format) = 0;
+    virtual void setMipmap(TextureMipmap mipmap) = 0;
+    virtual void setSrgb(bool srgb) = 0;
     virtual void applyWrapProperties() = 0;
     virtual void applyFilterProperties() = 0;
     virtual void processFilterProperties() = 0;
     virtual bool create(int width, int height, const void *data = NULL) = 0;
+    virtual bool createCompressed(TextureCompression compression, const std::vector<CompressedTextureLevel>& levels) = 0;
     virtual bool update(const void *data) = 0;
+    virtual bool updateRegion(int x, int y, int width, int height, const void *data) = 0;
     virtual void setWrap(TextureWrap wrap) = 0;
     virtual void setFilter(TextureFilter filter) = 0;
     virtual void setTargetType(TextureTargetType targetType) = 0;
@@ -3,6 +3,24 @@
 #include "logger/logger.h"
 #include "Settings.h"
 
+#include <set>
+#include <string>
+#include <algorithm>
+
+// S3TC formats are not part of the core profile headers
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#define GL_COMPRESSED_RGBA_S3TC_DXT3_EXT 0x83F2
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+#ifndef GL_COMPRESSED_SRGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_SRGB_S3TC_DXT1_EXT 0x8C4C
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT 0x8C4D
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT 0x8C4E
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT 0x8C4F
+#endif
+
 //TODO: Support for 1D - 3D textures
 
 // possible cave-at: bind/unbind behavior with multiple texture units could be incoherrent, as there is only single stack
@@ -42,6 +60,11 @@ TextureOpenGl::TextureOpenGl() {
     id = 0;
     width = 0;
     height = 0;
+    compression = TextureCompression::NONE;
+    srgb = false;
+    immutable = false;
+    alias = NULL;
+    setMipmap(Settings::demo.graphics.defaultTextureMipmap);
     setDataType(Settings::demo.graphics.defaultTextureDataType);
     setTargetType(Settings::demo.graphics.defaultTextureTargetType);
     setType(Settings::demo.graphics.defaultTextureType);
@@ -81,6 +104,7 @@ void TextureOpenGl::free() {
         }
 
         id = 0;
+        immutable = false;
     }
 }
 
@@ -90,10 +114,14 @@ void TextureOpenGl::bind(unsigned int textureUnit) {
     bindStack.push_back(this);
 
     glActiveTexture(GL_TEXTURE0 + textureUnit);
-    glBindTexture(getTargetTypeOpenGl(), id);
+    glBindTexture(getTargetTypeOpenGl(), getId());
     glActiveTexture(GL_TEXTURE0);
 }
 
+unsigned int TextureOpenGl::getBindStackSize() {
+    return static_cast<unsigned int>(bindStack.size());
+}
+
 void TextureOpenGl::unbind(unsigned int textureUnit) {
     PROFILER_BLOCK("TextureOpenGl::unbind");
 
@@ -151,6 +179,59 @@ GLenum TextureOpenGl::getFormatOpenGl() {
 
         case TextureFormat::DEPTH_COMPONENT:
             return GL_DEPTH_COMPONENT;
+
+        case TextureFormat::RG:
+            return GL_RG;
+
+        case TextureFormat::LUMINANCE:
+            return GL_RED;
+
+        case TextureFormat::LUMINANCE_ALPHA:
+            return GL_RG;
+    }
+}
+
+GLenum TextureOpenGl::getInternalFormatOpenGl() {
+    if (dataType == TextureDataType::FLOAT) {
+        switch(format) {
+            // half floats keep the memory use of float textures moderate
+            case TextureFormat::RGBA:
+                return GL_RGBA16F;
+            case TextureFormat::RGB:
+                return GL_RGB16F;
+            case TextureFormat::RED:
+            case TextureFormat::LUMINANCE:
+                return GL_R16F;
+            case TextureFormat::RG:
+            case TextureFormat::LUMINANCE_ALPHA:
+                return GL_RG16F;
+            case TextureFormat::DEPTH_COMPONENT:
+                return GL_DEPTH_COMPONENT32F;
+            default:
+                break;
+        }
+    }
+
+    switch(format) {
+        default:
+            loggerError("Unknown format property. format:%d, texture:0x%p", format, this);
+
+        case TextureFormat::RGBA:
+            return srgb ? GL_SRGB8_ALPHA8 : GL_RGBA8;
+
+        case TextureFormat::RGB:
+            return srgb ? GL_SRGB8 : GL_RGB8;
+
+        case TextureFormat::RED:
+        case TextureFormat::LUMINANCE:
+            return GL_R8;
+
+        case TextureFormat::RG:
+        case TextureFormat::LUMINANCE_ALPHA:
+            return GL_RG8;
+
+        case TextureFormat::DEPTH_COMPONENT:
+            return GL_DEPTH_COMPONENT24;
     }
 }
 
@@ -164,11 +245,38 @@ const char *TextureOpenGl::getFormatName() {
             return "RGB";
         case TextureFormat::RED:
             return "RED";
+        case TextureFormat::RG:
+            return "RG";
+        case TextureFormat::LUMINANCE:
+            return "LUMINANCE";
+        case TextureFormat::LUMINANCE_ALPHA:
+            return "LUMINANCE_ALPHA";
         default:
             return "Unknown format";
     }
 }
 
+void TextureOpenGl::setMipmap(TextureMipmap mipmap) {
+    this->mipmap = mipmap;
+}
+
+const char *TextureOpenGl::getMipmapName() {
+    switch(mipmap) {
+        case TextureMipmap::NONE:
+            return "NONE";
+        case TextureMipmap::GENERATE:
+            return "GENERATE";
+        case TextureMipmap::PREBUILT:
+            return "PREBUILT";
+        default:
+            return "Unknown mipmap";
+    }
+}
+
+void TextureOpenGl::setSrgb(bool srgb) {
+    this->srgb = srgb;
+}
+
 void TextureOpenGl::setWrap(TextureWrap wrap) {
     this->wrap = wrap;
 }
@@ -190,6 +298,7 @@ const char *TextureOpenGl::getWrapName() {
 
 void TextureOpenGl::setFilter(TextureFilter filter) {
     this->filter = filter;
+    appliedFilter = filter;
 }
 
 const char *TextureOpenGl::getFilterName() {
@@ -250,6 +359,128 @@ GLenum TextureOpenGl::getDataTypeOpenGl() {
     }
 }
 
+GLenum TextureOpenGl::getCompressionOpenGl(TextureCompression compression) {
+    switch(compression) {
+        case TextureCompression::BC1:
+            return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+        case TextureCompression::BC1_ALPHA:
+            return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+        case TextureCompression::BC1_SRGB:
+            return GL_COMPRESSED_SRGB_S3TC_DXT1_EXT;
+        case TextureCompression::BC1_ALPHA_SRGB:
+            return GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT;
+        case TextureCompression::BC2:
+            return GL_COMPRESSED_RGBA_S3TC_DXT3_EXT;
+        case TextureCompression::BC2_SRGB:
+            return GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT;
+        case TextureCompression::BC3:
+            return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        case TextureCompression::BC3_SRGB:
+            return GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT;
+        case TextureCompression::BC4:
+            return GL_COMPRESSED_RED_RGTC1;
+        case TextureCompression::BC4_SIGNED:
+            return GL_COMPRESSED_SIGNED_RED_RGTC1;
+        case TextureCompression::BC5:
+            return GL_COMPRESSED_RG_RGTC2;
+        case TextureCompression::BC5_SIGNED:
+            return GL_COMPRESSED_SIGNED_RG_RGTC2;
+        case TextureCompression::BC6H:
+            return GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT;
+        case TextureCompression::BC6H_SIGNED:
+            return GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT;
+        case TextureCompression::BC7:
+            return GL_COMPRESSED_RGBA_BPTC_UNORM;
+        case TextureCompression::BC7_SRGB:
+            return GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM;
+        default:
+            return 0;
+    }
+}
+
+const char *TextureOpenGl::getCompressionName() {
+    switch(compression) {
+        case TextureCompression::NONE:
+            return "NONE";
+        case TextureCompression::BC1:
+        case TextureCompression::BC1_ALPHA:
+        case TextureCompression::BC1_SRGB:
+        case TextureCompression::BC1_ALPHA_SRGB:
+            return "BC1";
+        case TextureCompression::BC2:
+        case TextureCompression::BC2_SRGB:
+            return "BC2";
+        case TextureCompression::BC3:
+        case TextureCompression::BC3_SRGB:
+            return "BC3";
+        case TextureCompression::BC4:
+        case TextureCompression::BC4_SIGNED:
+            return "BC4";
+        case TextureCompression::BC5:
+        case TextureCompression::BC5_SIGNED:
+            return "BC5";
+        case TextureCompression::BC6H:
+        case TextureCompression::BC6H_SIGNED:
+            return "BC6H";
+        case TextureCompression::BC7:
+        case TextureCompression::BC7_SRGB:
+            return "BC7";
+        default:
+            return "Unknown compression";
+    }
+}
+
+static bool isExtensionSupported(const std::string& extension) {
+    static std::set<std::string> extensions;
+    if (extensions.empty()) {
+        GLint extensionCount = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+        for (GLint i = 0; i < extensionCount; i++) {
+            extensions.insert(std::string(reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)))));
+        }
+    }
+
+    return extensions.find(extension) != extensions.end();
+}
+
+bool TextureOpenGl::isStorageSupported() {
+    static int supported = -1;
+    if (supported == -1) {
+        supported = glTexStorage2D != NULL && (gl3wIsSupported(4, 2) || isExtensionSupported("GL_ARB_texture_storage")) ? 1 : 0;
+    }
+
+    return supported == 1;
+}
+
+bool TextureOpenGl::isCompressionSupported(TextureCompression compression) {
+    switch(compression) {
+        case TextureCompression::BC1:
+        case TextureCompression::BC1_ALPHA:
+        case TextureCompression::BC2:
+        case TextureCompression::BC3:
+            return isExtensionSupported("GL_EXT_texture_compression_s3tc");
+        case TextureCompression::BC1_SRGB:
+        case TextureCompression::BC1_ALPHA_SRGB:
+        case TextureCompression::BC2_SRGB:
+        case TextureCompression::BC3_SRGB:
+            return isExtensionSupported("GL_EXT_texture_compression_s3tc")
+                && (isExtensionSupported("GL_EXT_texture_sRGB") || isExtensionSupported("GL_EXT_texture_compression_s3tc_srgb"));
+        case TextureCompression::BC4:
+        case TextureCompression::BC4_SIGNED:
+        case TextureCompression::BC5:
+        case TextureCompression::BC5_SIGNED:
+            // RGTC is core since OpenGL 3.0
+            return true;
+        case TextureCompression::BC6H:
+        case TextureCompression::BC6H_SIGNED:
+        case TextureCompression::BC7:
+        case TextureCompression::BC7_SRGB:
+            return gl3wIsSupported(4, 2) || isExtensionSupported("GL_ARB_texture_compression_bptc");
+        default:
+            return false;
+    }
+}
+
 void TextureOpenGl::applyWrapProperties() {
     switch(wrap) {
         case TextureWrap::REPEAT:
@@ -275,7 +506,7 @@ void TextureOpenGl::applyWrapProperties() {
 }
 
 void TextureOpenGl::applyFilterProperties() {
-    switch(filter) {
+    switch(appliedFilter) {
         case TextureFilter::NEAREST:
             glTexParameteri(getTargetTypeOpenGl(), GL_TEXTURE_MAG_FILTER, GL_NEAREST);
             glTexParameteri(getTargetTypeOpenGl(), GL_TEXTURE_MIN_FILTER, GL_NEAREST);    
@@ -289,13 +520,44 @@ void TextureOpenGl::applyFilterProperties() {
             glTexParameteri(getTargetTypeOpenGl(), GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
             break;
         default:
-            loggerError("Unknown filter property. filter:%d, texture:0x%p", filter, this);
+            loggerError("Unknown filter property. filter:%d, texture:0x%p", appliedFilter, this);
             break;
     }
 }
 
+void TextureOpenGl::applySwizzleProperties() {
+    // single and dual channel images are expanded to gray scale in sampling
+    if (format == TextureFormat::LUMINANCE) {
+        const GLint swizzle[] = {GL_RED, GL_RED, GL_RED, GL_ONE};
+        glTexParameteriv(getTargetTypeOpenGl(), GL_TEXTURE_SWIZZLE_RGBA, swizzle);
+    } else if (format == TextureFormat::LUMINANCE_ALPHA) {
+        const GLint swizzle[] = {GL_RED, GL_RED, GL_RED, GL_GREEN};
+        glTexParameteriv(getTargetTypeOpenGl(), GL_TEXTURE_SWIZZLE_RGBA, swizzle);
+    }
+}
+
+GLsizei TextureOpenGl::getMipmapLevelCount() {
+    if (appliedFilter != TextureFilter::MIPMAP || mipmap == TextureMipmap::NONE) {
+        return 1;
+    }
+
+    // 1D array texture height is the layer count
+    GLsizei size = width;
+    if (targetType == TextureTargetType::TEXTURE_2D) {
+        size = std::max(width, height);
+    }
+
+    GLsizei levels = 1;
+    while (size > 1) {
+        size >>= 1;
+        levels++;
+    }
+
+    return levels;
+}
+
 void TextureOpenGl::processFilterProperties() {
-    if (filter == TextureFilter::MIPMAP) {
+    if (appliedFilter == TextureFilter::MIPMAP && mipmap == TextureMipmap::GENERATE) {
         glGenerateMipmap(getTargetTypeOpenGl());
     }
 }
@@ -305,6 +567,15 @@ bool TextureOpenGl::create(int width, int height, const void *data) {
 
     this->width = static_cast<GLsizei>(width);
     this->height = static_cast<GLsizei>(height);
+    compression = TextureCompression::NONE;
+
+    // requested filter is kept, so that the next create() follows a changed mipmap policy
+    appliedFilter = filter;
+    if (filter == TextureFilter::MIPMAP && mipmap != TextureMipmap::GENERATE) {
+        // uncompressed textures have no stored mip chain
+        loggerTrace("Texture mipmap generation disabled, using linear filtering. mipmap:%s, texture:0x%p", getMipmapName(), this);
+        appliedFilter = TextureFilter::LINEAR;
+    }
 
     if (generate() == false) {
         return false;
@@ -316,8 +587,25 @@ bool TextureOpenGl::create(int width, int height, const void *data) {
 
     applyFilterProperties();
 
+    applySwizzleProperties();
+
+    GLenum target = getTargetTypeOpenGl();
     GLenum glFormat = getFormatOpenGl();
-    glTexImage2D(getTargetTypeOpenGl(), 0, glFormat, this->width, this->height, 0, glFormat, getDataTypeOpenGl(), data);
+    GLenum glInternalFormat = getInternalFormatOpenGl();
+    GLsizei levels = getMipmapLevelCount();
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    if (isStorageSupported()) {
+        glTexStorage2D(target, levels, glInternalFormat, this->width, this->height);
+        if (data != NULL) {
+            glTexSubImage2D(target, 0, 0, 0, this->width, this->height, glFormat, getDataTypeOpenGl(), data);
+        }
+        immutable = true;
+    } else {
+        glTexImage2D(target, 0, glInternalFormat, this->width, this->height, 0, glFormat, getDataTypeOpenGl(), data);
+        glTexParameteri(target, GL_TEXTURE_MAX_LEVEL, levels - 1);
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
 
     processFilterProperties();
 
@@ -327,8 +615,8 @@ bool TextureOpenGl::create(int width, int height, const void *data) {
         return false;
     }
 
-    loggerDebug("Created texture. id:%u dimensions:%dx%d, type:%s, format:%s, wrap:%s, filter:%s, texture:0x%p",
-        id, width, height, getTypeName(), getFormatName(), getWrapName(), getFilterName(), this);
+    loggerDebug("Created texture. id:%u dimensions:%dx%d, type:%s, format:%s, wrap:%s, filter:%s, mipmap:%s, levels:%d, immutable:%d, texture:0x%p",
+        id, width, height, getTypeName(), getFormatName(), getWrapName(), getFilterName(), getMipmapName(), levels, immutable, this);
 
     unbind();
 
@@ -339,6 +627,83 @@ bool TextureOpenGl::create(int width, int height, const void *data) {
     return true;
 }
 
+bool TextureOpenGl::createCompressed(TextureCompression compression, const std::vector<CompressedTextureLevel>& levels) {
+    PROFILER_BLOCK("TextureOpenGl::createCompressed");
+
+    if (levels.empty()) {
+        loggerError("No texture levels given, can't create compressed texture. texture:0x%p", this);
+        return false;
+    }
+
+    if (getTargetTypeOpenGl() != GL_TEXTURE_2D) {
+        loggerError("Compressed textures are supported only for TEXTURE_2D. targetType:%s, texture:0x%p", getTargetTypeName(), this);
+        return false;
+    }
+
+    this->compression = compression;
+    if (!isCompressionSupported(compression)) {
+        loggerError("Texture compression not supported by the OpenGL implementation. compression:%s, texture:0x%p", getCompressionName(), this);
+        return false;
+    }
+
+    this->width = static_cast<GLsizei>(levels[0].width);
+    this->height = static_cast<GLsizei>(levels[0].height);
+
+    // mipmaps are not generated at runtime for compressed data, stored mip chain is used instead
+    setMipmap(levels.size() > 1 ? TextureMipmap::PREBUILT : TextureMipmap::NONE);
+    appliedFilter = filter;
+    if (filter == TextureFilter::MIPMAP && levels.size() == 1) {
+        loggerDebug("Compressed texture has no stored mipmaps, using linear filtering. texture:0x%p", this);
+        appliedFilter = TextureFilter::LINEAR;
+    }
+
+    if (generate() == false) {
+        return false;
+    }
+
+    bind();
+
+    applyWrapProperties();
+
+    applyFilterProperties();
+
+    GLint maxLevel = appliedFilter == TextureFilter::MIPMAP ? static_cast<GLint>(levels.size()) - 1 : 0;
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, maxLevel);
+
+    GLenum glCompression = getCompressionOpenGl(compression);
+    if (isStorageSupported()) {
+        glTexStorage2D(GL_TEXTURE_2D, maxLevel + 1, glCompression, this->width, this->height);
+        immutable = true;
+    }
+    for (GLint level = 0; level <= maxLevel; level++) {
+        const CompressedTextureLevel& textureLevel = levels[level];
+        if (immutable) {
+            glCompressedTexSubImage2D(GL_TEXTURE_2D, level, 0, 0,
+                static_cast<GLsizei>(textureLevel.width), static_cast<GLsizei>(textureLevel.height), glCompression,
+                static_cast<GLsizei>(textureLevel.size), textureLevel.data);
+        } else {
+            glCompressedTexImage2D(GL_TEXTURE_2D, level, glCompression,
+                static_cast<GLsizei>(textureLevel.width), static_cast<GLsizei>(textureLevel.height), 0,
+                static_cast<GLsizei>(textureLevel.size), textureLevel.data);
+        }
+    }
+
+    Graphics &graphics = Graphics::getInstance();
+    if (graphics.handleErrors()) {
+        loggerError("Could not create compressed texture. texture:0x%p", this);
+        unbind();
+        return false;
+    }
+
+    loggerDebug("Created compressed texture. id:%u dimensions:%dx%d, levels:%d, type:%s, compression:%s, wrap:%s, filter:%s, texture:0x%p",
+        id, width, height, maxLevel + 1, getTypeName(), getCompressionName(), getWrapName(), getFilterName(), this);
+
+    unbind();
+
+    return true;
+}
+
 bool TextureOpenGl::update(const void *data) {
     if (id == 0) {
         loggerError("Texture not generated, cannot update. id:%u dimensions:%dx%d, format:%s, wrap:%s, filter:%s, targetType:%s, texture:0x%p, data:0x%p",
@@ -347,14 +712,51 @@ bool TextureOpenGl::update(const void *data) {
         return false;
     }
 
+    if (compression != TextureCompression::NONE) {
+        loggerError("Compressed texture can't be updated. id:%u, compression:%s, texture:0x%p", id, getCompressionName(), this);
+        return false;
+    }
+
     bind();
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
     glTexSubImage2D(getTargetTypeOpenGl(), 0, 0, 0, this->width, this->height, getFormatOpenGl(), getDataTypeOpenGl(), data);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
     processFilterProperties();
     unbind();
 
     return true;
 }
 
+bool TextureOpenGl::updateRegion(int x, int y, int width, int height, const void *data) {
+    if (id == 0 || compression != TextureCompression::NONE) {
+        loggerError("Texture region can't be updated. id:%u, compression:%s, texture:0x%p", id, getCompressionName(), this);
+        return false;
+    }
+
+    if (x < 0 || y < 0 || x + width > this->width || y + height > this->height) {
+        loggerError("Texture region out of bounds. region:%d,%d %dx%d, dimensions:%dx%d, texture:0x%p", x, y, width, height, this->width, this->height, this);
+        return false;
+    }
+
+    // partial updates don't regenerate mipmaps, used for atlases without mip chain
+    bind();
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexSubImage2D(getTargetTypeOpenGl(), 0, x, y, width, height, getFormatOpenGl(), getDataTypeOpenGl(), data);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    unbind();
+
+    return true;
+}
+
 GLuint TextureOpenGl::getId() {
+    if (alias != NULL) {
+        return alias->getId();
+    }
+
     return id;
 }
+
+void TextureOpenGl::setAlias(TextureOpenGl *texture) {
+    // aliased texture uses the GL texture of another texture, e.g. pooled render target
+    alias = texture;
+}
@@ -18,6 +18,8 @@ public:
     void unbind(unsigned int textureUnit = 0);
     void setType(TextureType type);
     void setFormat(TextureFormat format);
+    void setMipmap(TextureMipmap mipmap);
+    void setSrgb(bool srgb);
     void setWrap(TextureWrap wrap);
     void setFilter(TextureFilter filter);
     void setTargetType(TextureTargetType targetType);
@@ -26,17 +28,29 @@ public:
     void applyFilterProperties();
     void processFilterProperties();
     bool create(int width, int height, const void *data = NULL);
+    bool createCompressed(TextureCompression compression, const std::vector<CompressedTextureLevel>& levels);
     bool update(const void *data);
+    bool updateRegion(int x, int y, int width, int height, const void *data);
     GLuint getId();
+    void setAlias(TextureOpenGl *texture);
     GLenum getTargetTypeOpenGl();
     GLenum getFormatOpenGl();
+    GLenum getInternalFormatOpenGl();
     GLenum getDataTypeOpenGl();
+    static GLenum getCompressionOpenGl(TextureCompression compression);
+    static bool isCompressionSupported(TextureCompression compression);
+    static bool isStorageSupported();
+    static unsigned int getBindStackSize();
 protected:
     const char *getTypeName();
     const char *getFormatName();
     const char *getWrapName();
     const char *getFilterName();
     const char *getTargetTypeName();
+    const char *getCompressionName();
+    const char *getMipmapName();
+    void applySwizzleProperties();
+    GLsizei getMipmapLevelCount();
 
     GLuint id;
     GLsizei width;
@@ -46,7 +60,14 @@ protected:
     TextureFormat format;
     TextureWrap wrap;
     TextureFilter filter;
+    // filter used by the created texture, MIPMAP falls back to LINEAR when there are no mipmaps
+    TextureFilter appliedFilter;
     TextureTargetType targetType;
+    TextureCompression compression;
+    TextureMipmap mipmap;
+    bool srgb;
+    bool immutable;
+    TextureOpenGl *alias;
 
     static std::vector<TextureOpenGl*> bindStack;
 };
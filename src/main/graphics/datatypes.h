@@ -26,7 +26,16 @@ enum class TextureFormat {
     RGBA=0,
     RGB=1,
     DEPTH_COMPONENT=2,
-    RED=3
+    RED=3,
+    RG=4,
+    LUMINANCE=5,
+    LUMINANCE_ALPHA=6
+};
+
+enum class TextureMipmap {
+    NONE=0,
+    GENERATE=1,
+    PREBUILT=2
 };
 
 enum class TextureTargetType {
@@ -39,6 +48,26 @@ enum class TextureDataType {
     FLOAT=1
 };
 
+enum class TextureCompression {
+    NONE=0,
+    BC1=1,
+    BC1_ALPHA=2,
+    BC1_SRGB=3,
+    BC1_ALPHA_SRGB=4,
+    BC2=5,
+    BC2_SRGB=6,
+    BC3=7,
+    BC3_SRGB=8,
+    BC4=9,
+    BC4_SIGNED=10,
+    BC5=11,
+    BC5_SIGNED=12,
+    BC6H=13,
+    BC6H_SIGNED=14,
+    BC7=15,
+    BC7_SRGB=16
+};
+
 
 struct Color {
     Color(double r, double g, double b, double a) {
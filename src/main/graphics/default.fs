@@ -2,6 +2,8 @@
 
 in vec2 texCoord;
 in vec4 vertexFragColor;
+in vec3 viewPosition;
+in vec3 viewNormal;
 
 out vec4 fragColor;
 uniform sampler2D texture0; // diffuse
@@ -10,16 +12,72 @@ uniform sampler2D texture2; // specular
 uniform sampler2D texture3; // normal
 uniform vec4 color = vec4(1.0,1.0,1.0,1.0);
 uniform bool enableVertexColor = false;
+uniform bool enableInstancing = false;
+
+// clustered lighting, see "Clustered lighting" in documentation.md
+uniform bool enableClusteredLighting = false;
+uniform mat4 view;
+uniform samplerBuffer clusterLights;
+uniform usamplerBuffer clusterGrid;
+uniform usamplerBuffer clusterLightIndices;
+uniform vec3 clusterDimensions;
+uniform vec4 clusterDepth;
+uniform vec4 clusterViewport;
+
+int cluster(float viewDepth) {
+    vec2 tile = (gl_FragCoord.xy - clusterViewport.xy) / clusterViewport.zw * clusterDimensions.xy;
+    int slice = int(log(max(viewDepth, clusterDepth.z)) * clusterDepth.x + clusterDepth.y);
+    ivec3 dimensions = ivec3(clusterDimensions);
+    ivec3 index = clamp(ivec3(tile, slice), ivec3(0), dimensions - 1);
+    return index.x + index.y * dimensions.x + index.z * dimensions.x * dimensions.y;
+}
+
+// ambient and diffuse light of the fragment's cluster, spot lights are lit as point lights
+vec3 clusteredLighting() {
+    vec3 normal = normalize(viewNormal);
+    vec3 lighting = vec3(0.0);
+
+    uvec2 lights = texelFetch(clusterGrid, cluster(-viewPosition.z)).xy;
+    for (uint i = 0u; i < lights.y; i++) {
+        int light = int(texelFetch(clusterLightIndices, int(lights.x + i)).x) * 5;
+        vec4 positionType = texelFetch(clusterLights, light);
+        vec4 directionRange = texelFetch(clusterLights, light + 1);
+        vec4 ambient = texelFetch(clusterLights, light + 2);
+        vec4 diffuse = texelFetch(clusterLights, light + 3);
+
+        vec3 lightDirection;
+        float attenuation = 1.0;
+        if (int(positionType.w) == 1) {
+            // directional
+            lightDirection = -normalize(mat3(view) * directionRange.xyz);
+        } else {
+            vec3 toLight = (view * vec4(positionType.xyz, 1.0)).xyz - viewPosition;
+            float distance = length(toLight);
+            lightDirection = toLight / max(distance, 0.0001);
+            if (directionRange.w > 0.0) {
+                attenuation = clamp(1.0 - distance / directionRange.w, 0.0, 1.0);
+            }
+        }
+
+        lighting += (ambient.rgb + diffuse.rgb * max(dot(normal, lightDirection), 0.0)) * attenuation;
+    }
+
+    return lighting;
+}
 
 void main(void)
 {
     fragColor = color;
 
-    if (enableVertexColor) {
+    if (enableVertexColor || enableInstancing) {
         fragColor *= vertexFragColor;
     }
 
     fragColor *= texture(texture0, texCoord);
 
+    if (enableClusteredLighting) {
+        fragColor.rgb *= clusteredLighting();
+    }
+
     fragColor = clamp(fragColor, vec4(0.0,0.0,0.0,0.0), vec4(1.0,1.0,1.0,1.0));
 } 
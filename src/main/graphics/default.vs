@@ -4,15 +4,47 @@ layout(location = 0) in vec3 vertexPosition;
 layout(location = 1) in vec2 vertexTexCoord;
 layout(location = 2) in vec3 vertexNormal;
 layout(location = 3) in vec4 vertexColor;
+layout(location = 4) in ivec4 vertexBoneIndex;
+layout(location = 5) in vec4 vertexBoneWeight;
+layout(location = 6) in mat4 instanceTransformation;
+layout(location = 10) in vec4 instanceColor;
 
 out vec2 texCoord;
 out vec4 vertexFragColor;
+out vec3 viewPosition;
+out vec3 viewNormal;
 uniform mat4 mvp;
+uniform mat4 model;
+uniform mat4 view;
+uniform mat3 normalMatrix;
+uniform mat4 bones[60];
+uniform bool enableSkinning = false;
+uniform bool enableInstancing = false;
+uniform mat4 instanceNode = mat4(1.0);
+uniform bool enableVertexColor = false;
 
 void main(void)
 {
     vec4 position = vec4(vertexPosition, 1.0);
+    vec4 normal = vec4(vertexNormal, 0.0);
+    if (enableSkinning) {
+        mat4 skin = bones[vertexBoneIndex.x] * vertexBoneWeight.x
+                  + bones[vertexBoneIndex.y] * vertexBoneWeight.y
+                  + bones[vertexBoneIndex.z] * vertexBoneWeight.z
+                  + bones[vertexBoneIndex.w] * vertexBoneWeight.w;
+        position = skin * position;
+        normal = skin * normal;
+    }
+    vertexFragColor = vertexColor;
+    if (enableInstancing) {
+        // model node hierarchy is applied before the instance, mvp has only the model transformation
+        position = instanceTransformation * instanceNode * position;
+        normal = instanceTransformation * instanceNode * normal;
+        vertexFragColor = (enableVertexColor ? vertexColor : vec4(1.0)) * instanceColor;
+    }
     gl_Position = mvp * position;
     texCoord = vertexTexCoord;
-    vertexFragColor = vertexColor;
+    // view space inputs of clustered lighting
+    viewPosition = (view * model * position).xyz;
+    viewNormal = normalMatrix * normal.xyz;
 } 
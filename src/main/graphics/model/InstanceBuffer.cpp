@@ -0,0 +1,119 @@
+#include "InstanceBuffer.h"
+
+#include "graphics/Graphics.h"
+#include "graphics/RenderQueue.h"
+#include "logger/logger.h"
+
+// NOTE: Hard-coded values in GLSL, mat4 attribute uses four consecutive locations
+#define INSTANCE_TRANSFORMATION_ATTRIB 6
+#define INSTANCE_COLOR_ATTRIB 10
+
+InstanceBuffer::InstanceBuffer() {
+    buffer = 0;
+    instanceCount = 0;
+    capacity = 0;
+}
+
+InstanceBuffer::~InstanceBuffer() {
+    free();
+}
+
+bool InstanceBuffer::setData(const float *data, unsigned int instanceCount) {
+    PROFILER_BLOCK("InstanceBuffer::setData");
+
+    // queued draws read the buffer and instance count when they are submitted
+    RenderQueue::getInstance().flush();
+
+    if (buffer == 0) {
+        glGenBuffers(1, &buffer);
+        if (buffer == 0) {
+            loggerWarning("Could not generate instance buffer. instances:%u", instanceCount);
+            return false;
+        }
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    if (instanceCount > capacity) {
+        glBufferData(GL_ARRAY_BUFFER, instanceCount * INSTANCE_FLOAT_COUNT * sizeof(float), data, GL_DYNAMIC_DRAW);
+        capacity = instanceCount;
+    } else if (instanceCount > 0) {
+        // Reuse the existing storage when the instance count shrinks or stays the same
+        glBufferSubData(GL_ARRAY_BUFFER, 0, instanceCount * INSTANCE_FLOAT_COUNT * sizeof(float), data);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    this->instanceCount = instanceCount;
+
+    Graphics &graphics = Graphics::getInstance();
+    if (graphics.handleErrors()) {
+        loggerError("Could not set instance buffer data. instances:%u", instanceCount);
+        return false;
+    }
+
+    return true;
+}
+
+bool InstanceBuffer::updateData(const float *data, unsigned int firstInstance, unsigned int instanceCount) {
+    PROFILER_BLOCK("InstanceBuffer::updateData");
+
+    if (buffer == 0 || firstInstance + instanceCount > this->instanceCount) {
+        loggerError("Instance buffer update out of range. firstInstance:%u, instances:%u, instanceCount:%u",
+            firstInstance, instanceCount, this->instanceCount);
+        return false;
+    }
+
+    if (instanceCount == 0) {
+        return true;
+    }
+
+    RenderQueue::getInstance().flush();
+
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    glBufferSubData(GL_ARRAY_BUFFER,
+        firstInstance * INSTANCE_FLOAT_COUNT * sizeof(float),
+        instanceCount * INSTANCE_FLOAT_COUNT * sizeof(float),
+        data);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    return true;
+}
+
+unsigned int InstanceBuffer::getInstanceCount() {
+    return instanceCount;
+}
+
+void InstanceBuffer::bindAttributes() {
+    const GLsizei stride = INSTANCE_FLOAT_COUNT * sizeof(float);
+
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    for (GLuint column = 0; column < 4; column++) {
+        GLuint attrib = INSTANCE_TRANSFORMATION_ATTRIB + column;
+        glEnableVertexAttribArray(attrib);
+        glVertexAttribPointer(attrib, 4, GL_FLOAT, GL_FALSE, stride, (const GLvoid*)(column * 4 * sizeof(float)));
+        glVertexAttribDivisor(attrib, 1);
+    }
+
+    glEnableVertexAttribArray(INSTANCE_COLOR_ATTRIB);
+    glVertexAttribPointer(INSTANCE_COLOR_ATTRIB, 4, GL_FLOAT, GL_FALSE, stride, (const GLvoid*)(16 * sizeof(float)));
+    glVertexAttribDivisor(INSTANCE_COLOR_ATTRIB, 1);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void InstanceBuffer::unbindAttributes() {
+    for (GLuint attrib = INSTANCE_TRANSFORMATION_ATTRIB; attrib <= INSTANCE_COLOR_ATTRIB; attrib++) {
+        glVertexAttribDivisor(attrib, 0);
+        glDisableVertexAttribArray(attrib);
+    }
+}
+
+void InstanceBuffer::free() {
+    RenderQueue::getInstance().flush();
+
+    if (buffer != 0) {
+        glDeleteBuffers(1, &buffer);
+        buffer = 0;
+    }
+
+    instanceCount = 0;
+    capacity = 0;
+}
@@ -0,0 +1,30 @@
+#ifndef ENGINE_GRAPHICS_MODEL_INSTANCEBUFFER_H_
+#define ENGINE_GRAPHICS_MODEL_INSTANCEBUFFER_H_
+
+#include "GL/gl3w.h"
+
+// Per instance layout: column-major 4x4 transformation matrix followed by RGBA color
+#define INSTANCE_FLOAT_COUNT 20
+
+/**
+ * GPU buffer of per instance transformations and colors for instanced mesh drawing.
+ * Instance transformations are applied in the model space of the drawn mesh.
+ */
+class InstanceBuffer {
+public:
+    InstanceBuffer();
+    ~InstanceBuffer();
+
+    bool setData(const float *data, unsigned int instanceCount);
+    bool updateData(const float *data, unsigned int firstInstance, unsigned int instanceCount);
+    unsigned int getInstanceCount();
+    void bindAttributes();
+    void unbindAttributes();
+    void free();
+private:
+    GLuint buffer;
+    unsigned int instanceCount;
+    unsigned int capacity;
+};
+
+#endif /*ENGINE_GRAPHICS_MODEL_INSTANCEBUFFER_H_*/
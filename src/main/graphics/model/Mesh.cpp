@@ -1,10 +1,13 @@
 #include "Mesh.h"
 
+#include <algorithm>
+
 #include "glm/glm.hpp"
 #include "glm/gtc/matrix_transform.hpp"
 #include "glm/gtc/type_ptr.hpp"
 
 #include "graphics/TextureOpenGl.h"
+#include "InstanceBuffer.h"
 
 #include "logger/logger.h"
 
@@ -14,6 +17,8 @@
 #define UV_ATTRIB 1
 #define NORMAL_ATTRIB 2
 #define COLOR_ATTRIB 3
+#define BONE_INDEX_ATTRIB 4
+#define BONE_WEIGHT_ATTRIB 5
 
 #include "graphics/Graphics.h"
 #include "graphics/Image.h"
@@ -22,6 +27,9 @@
 #include "io/MemoryManager.h"
 #include "graphics/ShaderProgram.h"
 #include "graphics/ShaderProgramOpenGl.h"
+#include "graphics/RenderQueue.h"
+#include "graphics/LightManager.h"
+#include "Settings.h"
 #include "math/TransformationMatrix.h"
 #include "time/Timer.h"
 
@@ -37,6 +45,8 @@ Mesh::Mesh() {
     normalBuffer = 0;
     colorBuffer = 0;
     indexBuffer = 0;
+    boneIndexBuffer = 0;
+    boneWeightBuffer = 0;
     faceDrawType = FaceType::TRIANGLES;
     // FIXME: Material should construct as a default
     material = NULL;
@@ -71,7 +81,7 @@ const std::string& Mesh::getName() {
 }
 
 void Mesh::print() {
-    loggerInfo("Mesh(%s, 0x%p, type:%d) - VAO(%u), Faces: %u, Vertices(%u): %u, normals(%u): %u, UVs(%u): %u, colors(%u): %u, indices(%u): %u",
+    loggerInfo("Mesh(%s, 0x%p, type:%d) - VAO(%u), Faces: %u, Vertices(%u): %u, normals(%u): %u, UVs(%u): %u, colors(%u): %u, indices(%u): %u, bones(%u): %u",
         name.c_str(),
         this,
         faceDrawType,
@@ -81,7 +91,8 @@ void Mesh::print() {
         normalBuffer, normals.size(),
         texCoordBuffer, texCoords.size(),
         colorBuffer, colors.size(),
-        indexBuffer, indices.size());
+        indexBuffer, indices.size(),
+        boneIndexBuffer, boneTransformations.size() / 16);
 }
 
 void Mesh::addVertex(float x, float y, float z) {
@@ -118,6 +129,122 @@ void Mesh::addIndex(unsigned int index) {
     indices.push_back(index);
 }
 
+bool Mesh::setVertices(const float *data, size_t count) {
+    if (count % 3 != 0) {
+        loggerError("Vertex array size must be a multiple of 3. mesh:'%s', count:%u", name.c_str(), count);
+        return false;
+    }
+
+    // queued draws read the mesh arrays and buffers when they are submitted
+    RenderQueue::getInstance().flush();
+    vertices.assign(data, data + count);
+    return true;
+}
+
+bool Mesh::setNormals(const float *data, size_t count) {
+    if (count % 3 != 0) {
+        loggerError("Normal array size must be a multiple of 3. mesh:'%s', count:%u", name.c_str(), count);
+        return false;
+    }
+
+    RenderQueue::getInstance().flush();
+    normals.assign(data, data + count);
+    return true;
+}
+
+bool Mesh::setTexCoords(const float *data, size_t count) {
+    if (count % 2 != 0) {
+        loggerError("Texture coordinate array size must be a multiple of 2. mesh:'%s', count:%u", name.c_str(), count);
+        return false;
+    }
+
+    RenderQueue::getInstance().flush();
+    texCoords.assign(data, data + count);
+    return true;
+}
+
+bool Mesh::setColors(const float *data, size_t count) {
+    if (count % 4 != 0) {
+        loggerError("Color array size must be a multiple of 4. mesh:'%s', count:%u", name.c_str(), count);
+        return false;
+    }
+
+    RenderQueue::getInstance().flush();
+    colors.assign(data, data + count);
+    return true;
+}
+
+void Mesh::setIndices(const unsigned int *data, size_t count) {
+    RenderQueue::getInstance().flush();
+    indices.assign(data, data + count);
+}
+
+void Mesh::setIndices(const unsigned short *data, size_t count) {
+    RenderQueue::getInstance().flush();
+    indices.assign(data, data + count);
+}
+
+void Mesh::addBoneWeight(unsigned int vertexIndex, unsigned int boneIndex, float weight) {
+    if (boneIndex >= MAX_BONE_COUNT) {
+        loggerWarning("Bone index exceeds the maximum bone count, weight ignored. mesh:'%s', boneIndex:%u, maxBoneCount:%d", name.c_str(), boneIndex, MAX_BONE_COUNT);
+        return;
+    }
+
+    size_t vertexCount = vertices.size() / 3;
+    if (vertexIndex >= vertexCount) {
+        loggerWarning("Bone weight vertex out of bounds. mesh:'%s', vertexIndex:%u, vertices:%u", name.c_str(), vertexIndex, vertexCount);
+        return;
+    }
+
+    if (boneWeights.size() < vertexCount * MAX_BONE_WEIGHTS) {
+        boneIndices.resize(vertexCount * MAX_BONE_WEIGHTS, 0);
+        boneWeights.resize(vertexCount * MAX_BONE_WEIGHTS, 0.0f);
+    }
+
+    // keep only the most influential weights, the lightest one gets replaced
+    size_t offset = vertexIndex * MAX_BONE_WEIGHTS;
+    size_t lightest = offset;
+    for (size_t i = offset; i < offset + MAX_BONE_WEIGHTS; i++) {
+        if (boneWeights[i] < boneWeights[lightest]) {
+            lightest = i;
+        }
+    }
+
+    if (boneWeights[lightest] < weight) {
+        boneIndices[lightest] = static_cast<int>(boneIndex);
+        boneWeights[lightest] = weight;
+    }
+}
+
+void Mesh::setBoneTransformation(unsigned int boneIndex, const float *matrix4) {
+    if (boneIndex >= MAX_BONE_COUNT) {
+        return;
+    }
+
+    if (boneTransformations.size() < (boneIndex + 1) * 16) {
+        boneTransformations.resize((boneIndex + 1) * 16, 0.0f);
+    }
+
+    std::copy_n(matrix4, 16, boneTransformations.begin() + boneIndex * 16);
+}
+
+void Mesh::setInstanceNodeTransformation(const float *matrix4) {
+    if (matrix4 == NULL) {
+        instanceNodeTransformation.clear();
+        return;
+    }
+
+    instanceNodeTransformation.assign(matrix4, matrix4 + 16);
+}
+
+bool Mesh::isSkinned() {
+    if (boneIndexBuffer == 0) {
+        return false;
+    }
+
+    return true;
+}
+
 void Mesh::setMaterial(Material *material, bool handleMaterialMemory) {
     this->material = material;
     this->handleMaterialMemory = handleMaterialMemory;
@@ -213,6 +340,46 @@ bool Mesh::generate() {
         glVertexAttribPointer(COLOR_ATTRIB, 4, GL_FLOAT, GL_FALSE, 0, NULL);
     }
 
+    if (! boneWeights.empty()) {
+        // weights may have been capped to MAX_BONE_WEIGHTS, so ensure that they sum up to one
+        for (size_t offset = 0; offset < boneWeights.size(); offset += MAX_BONE_WEIGHTS) {
+            float sum = 0.0f;
+            for (size_t i = offset; i < offset + MAX_BONE_WEIGHTS; i++) {
+                sum += boneWeights[i];
+            }
+
+            if (sum > 0.0f) {
+                for (size_t i = offset; i < offset + MAX_BONE_WEIGHTS; i++) {
+                    boneWeights[i] /= sum;
+                }
+            }
+        }
+
+        if (boneIndexBuffer == 0) {
+            glGenBuffers(1, &boneIndexBuffer);
+            if (boneIndexBuffer == 0) {
+                loggerWarning("Could not generate bone index buffer for mesh. boneIndices:%d", boneIndices.size());
+                return false;
+            }
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, boneIndexBuffer);
+        glEnableVertexAttribArray(BONE_INDEX_ATTRIB);
+        glBufferData(GL_ARRAY_BUFFER, boneIndices.size() * sizeof(int), &boneIndices[0], GL_STATIC_DRAW);
+        glVertexAttribIPointer(BONE_INDEX_ATTRIB, MAX_BONE_WEIGHTS, GL_INT, 0, NULL);
+
+        if (boneWeightBuffer == 0) {
+            glGenBuffers(1, &boneWeightBuffer);
+            if (boneWeightBuffer == 0) {
+                loggerWarning("Could not generate bone weight buffer for mesh. boneWeights:%d", boneWeights.size());
+                return false;
+            }
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, boneWeightBuffer);
+        glEnableVertexAttribArray(BONE_WEIGHT_ATTRIB);
+        glBufferData(GL_ARRAY_BUFFER, boneWeights.size() * sizeof(float), &boneWeights[0], GL_STATIC_DRAW);
+        glVertexAttribPointer(BONE_WEIGHT_ATTRIB, MAX_BONE_WEIGHTS, GL_FLOAT, GL_FALSE, 0, NULL);
+    }
+
     if (! indices.empty()) {
         if (indexBuffer == 0) {
             glGenBuffers(1, &indexBuffer);
@@ -227,8 +394,8 @@ bool Mesh::generate() {
 
     glBindVertexArray(0);
 
-    loggerTrace("Mesh generated. ptr:0x%p, vertexArray:%d, indexBuffer:%d, colorBuffer:%d, normalBuffer:%d, texCoordBuffer:%d, vertexBuffer:%d",
-        this, vertexArray, indexBuffer, colorBuffer, normalBuffer, texCoordBuffer, vertexBuffer);
+    loggerTrace("Mesh generated. ptr:0x%p, vertexArray:%d, indexBuffer:%d, colorBuffer:%d, normalBuffer:%d, texCoordBuffer:%d, vertexBuffer:%d, boneIndexBuffer:%d, boneWeightBuffer:%d",
+        this, vertexArray, indexBuffer, colorBuffer, normalBuffer, texCoordBuffer, vertexBuffer, boneIndexBuffer, boneWeightBuffer);
 
     Graphics &graphics = Graphics::getInstance();
     if (graphics.handleErrors()) {
@@ -242,6 +409,9 @@ bool Mesh::generate() {
 void Mesh::free() {
     PROFILER_BLOCK("Mesh::free");
 
+    // generate() frees the buffers first, so regenerating also flushes the queue
+    RenderQueue::getInstance().flush();
+
     glBindVertexArray(vertexArray);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
@@ -266,6 +436,14 @@ void Mesh::free() {
         glDeleteBuffers(1, &indexBuffer);
         indexBuffer = 0;
     }
+    if (boneIndexBuffer != 0) {
+        glDeleteBuffers(1, &boneIndexBuffer);
+        boneIndexBuffer = 0;
+    }
+    if (boneWeightBuffer != 0) {
+        glDeleteBuffers(1, &boneWeightBuffer);
+        boneWeightBuffer = 0;
+    }
 
     if (vertexArray != 0) {
         glBindVertexArray(0);
@@ -275,11 +453,15 @@ void Mesh::free() {
 }
 
 void Mesh::clear() {
+    RenderQueue::getInstance().flush();
     vertices.clear();
     normals.clear();
     texCoords.clear();
     colors.clear();
     indices.clear();
+    boneIndices.clear();
+    boneWeights.clear();
+    boneTransformations.clear();
 }
 
 bool Mesh::isGenerated() {
@@ -307,12 +489,31 @@ void Mesh::draw(double begin, double end) {
         return;
     }
 
-    TransformationMatrix& transformationMatrix = TransformationMatrix::getInstance();
-    transformationMatrix.translate(translate.x, translate.y, translate.z);
-    transformationMatrix.scale(scale.x, scale.y, scale.z);
-    transformationMatrix.rotateX(rotate.x);
-    transformationMatrix.rotateY(rotate.y);
-    transformationMatrix.rotateZ(rotate.z);
+    drawMesh(end, NULL);
+}
+
+void Mesh::drawInstanced(InstanceBuffer *instanceBuffer) {
+    PROFILER_BLOCK("Mesh::drawInstanced");
+    if (!isGenerated()) {
+        loggerError("Mesh not generated before instanced draw attempt!");
+        return;
+    }
+
+    if (instanceBuffer == NULL || instanceBuffer->getInstanceCount() == 0) {
+        return;
+    }
+
+    drawMesh(1.0, instanceBuffer);
+}
+
+void Mesh::drawMesh(double end, InstanceBuffer *instanceBuffer) {
+    RenderQueue& renderQueue = RenderQueue::getInstance();
+    bool sharedMeshState = isSkinned() || (instanceBuffer && !instanceNodeTransformation.empty());
+    if (renderQueue.isRecording() && renderQueue.add(this, material, sharedMeshState, end, instanceBuffer)) {
+        return;
+    }
+
+    applyTransformation();
 
     if (material) {
         material->bind();
@@ -320,6 +521,32 @@ void Mesh::draw(double begin, double end) {
         ShaderProgram::useCurrentBind();
     }
 
+    drawGeometry(end, instanceBuffer);
+
+    if (material) {
+        material->unbind();
+    } else {
+        ShaderProgram::useCurrentBind();
+    }
+}
+
+void Mesh::drawRecorded(double end, InstanceBuffer *instanceBuffer) {
+    applyTransformation();
+    // refresh the transformation dependent uniforms of the bound program
+    ShaderProgram::useCurrentBind();
+    drawGeometry(end, instanceBuffer);
+}
+
+void Mesh::applyTransformation() {
+    TransformationMatrix& transformationMatrix = TransformationMatrix::getInstance();
+    transformationMatrix.translate(translate.x, translate.y, translate.z);
+    transformationMatrix.scale(scale.x, scale.y, scale.z);
+    transformationMatrix.rotateX(rotate.x);
+    transformationMatrix.rotateY(rotate.y);
+    transformationMatrix.rotateZ(rotate.z);
+}
+
+void Mesh::drawGeometry(double end, InstanceBuffer *instanceBuffer) {
     glBindVertexArray(vertexArray);
 
 /*
@@ -354,7 +581,58 @@ void Mesh::draw(double begin, double end) {
         glUniform1i(enableVertexColorId, colors.empty() ? 0 : 1);
     }
 
-    if (! indices.empty()) {
+    // built-in shaders light only meshes with normals, custom shaders read the cluster buffers directly
+    LightManager& lightManager = LightManager::getInstance();
+    bool clusteredLighting = Settings::demo.graphics.clusteredLighting.defaultShader && !normals.empty()
+        && lightManager.getLighting() && lightManager.getActiveLightCount() > 0;
+    GLint enableClusteredLightingId = ShaderProgramOpenGl::getUniformLocation("enableClusteredLighting");
+    if (enableClusteredLightingId != -1) {
+        glUniform1i(enableClusteredLightingId, clusteredLighting ? 1 : 0);
+    }
+
+    GLint enableInstancingId = ShaderProgramOpenGl::getUniformLocation("enableInstancing");
+    if (enableInstancingId != -1) {
+        glUniform1i(enableInstancingId, instanceBuffer ? 1 : 0);
+    }
+    if (instanceBuffer) {
+        GLint instanceNodeId = ShaderProgramOpenGl::getUniformLocation("instanceNode");
+        if (instanceNodeId != -1) {
+            static const float identity[16] = {
+                1.0f, 0.0f, 0.0f, 0.0f,
+                0.0f, 1.0f, 0.0f, 0.0f,
+                0.0f, 0.0f, 1.0f, 0.0f,
+                0.0f, 0.0f, 0.0f, 1.0f
+            };
+            glUniformMatrix4fv(instanceNodeId, 1, GL_FALSE, instanceNodeTransformation.empty() ? identity : &instanceNodeTransformation[0]);
+        }
+        instanceBuffer->bindAttributes();
+    }
+
+    bool skinned = isSkinned() && !boneTransformations.empty();
+    GLint enableSkinningId = ShaderProgramOpenGl::getUniformLocation("enableSkinning");
+    if (enableSkinningId != -1) {
+        glUniform1i(enableSkinningId, skinned ? 1 : 0);
+    }
+    if (skinned) {
+        GLint bonesId = ShaderProgramOpenGl::getUniformLocation("bones");
+        if (bonesId != -1) {
+            glUniformMatrix4fv(bonesId, boneTransformations.size() / 16, GL_FALSE, &boneTransformations[0]);
+        }
+    }
+
+    if (instanceBuffer) {
+        GLsizei instanceCount = instanceBuffer->getInstanceCount();
+        if (! indices.empty()) {
+            glDrawElementsInstanced(getDrawElementsMode(), indices.size(), GL_UNSIGNED_INT, 0, instanceCount);
+        } else {
+            glDrawArraysInstanced(getDrawElementsMode(), 0, vertices.size() / 3, instanceCount);
+        }
+
+        instanceBuffer->unbindAttributes();
+        if (enableInstancingId != -1) {
+            glUniform1i(enableInstancingId, 0);
+        }
+    } else if (! indices.empty()) {
         //glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
         glDrawElements(getDrawElementsMode(), indices.size() * end, GL_UNSIGNED_INT, 0);
         //glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
@@ -375,10 +653,9 @@ void Mesh::draw(double begin, double end) {
     glBindBuffer(GL_ARRAY_BUFFER, 0);*/
     glBindVertexArray(0);
 
-    if (material) {
-        material->unbind();
-    } else {
-        ShaderProgram::useCurrentBind();
+    // images and quads drawn with the same program stay unlit
+    if (clusteredLighting && enableClusteredLightingId != -1) {
+        glUniform1i(enableClusteredLightingId, 0);
     }
 }
 
@@ -8,6 +8,11 @@
 
 #include "Material.h"
 
+class InstanceBuffer;
+
+// NOTE: Hard-coded values in GLSL
+#define MAX_BONE_COUNT 60
+#define MAX_BONE_WEIGHTS 4
 
  enum class FaceType {
     POINTS,
@@ -33,6 +38,23 @@ public:
     void addTexCoord(float x, float y);
     void addColor(float r, float g, float b, float a = 1.0f);
     void addIndex(unsigned int index);
+    /**
+     * Replace whole attribute arrays at once. Counts are in elements (floats / indices), not vertices.
+     */
+    bool setVertices(const float *data, size_t count);
+    bool setNormals(const float *data, size_t count);
+    bool setTexCoords(const float *data, size_t count);
+    bool setColors(const float *data, size_t count);
+    void setIndices(const unsigned int *data, size_t count);
+    void setIndices(const unsigned short *data, size_t count);
+    void addBoneWeight(unsigned int vertexIndex, unsigned int boneIndex, float weight);
+    void setBoneTransformation(unsigned int boneIndex, const float *matrix4);
+    /**
+     * Transformation applied to the vertices before the instance transformation in instanced draws.
+     * NULL resets to identity.
+     */
+    void setInstanceNodeTransformation(const float *matrix4);
+    bool isSkinned();
     void setMaterial(Material *material, bool handleMaterialMemory = false);
     Material* getMaterial();
     void setFaceDrawType(FaceType faceDrawType);
@@ -42,6 +64,11 @@ public:
     bool isGenerated();
     void draw(double begin, double end);
     void draw();
+    void drawInstanced(InstanceBuffer *instanceBuffer);
+    /**
+     * Draw with the material and shader program already bound, used when submitting RenderQueue.
+     */
+    void drawRecorded(double end, InstanceBuffer *instanceBuffer);
 
     void setRotate(double x, double y, double z);
     void setScale(double x, double y, double z);
@@ -51,6 +78,9 @@ public:
     void end();
 private:
     GLenum getDrawElementsMode();
+    void drawMesh(double end, InstanceBuffer *instanceBuffer);
+    void applyTransformation();
+    void drawGeometry(double end, InstanceBuffer *instanceBuffer);
 
     std::string name;
 
@@ -60,6 +90,10 @@ private:
     std::vector<float> texCoords;
     std::vector<float> colors;
     std::vector<unsigned int> indices;
+    std::vector<int> boneIndices;
+    std::vector<float> boneWeights;
+    std::vector<float> boneTransformations;
+    std::vector<float> instanceNodeTransformation;
     Material* material;
     bool handleMaterialMemory;
     GLuint vertexArray;
@@ -68,6 +102,8 @@ private:
     GLuint normalBuffer;
     GLuint colorBuffer;
     GLuint indexBuffer;
+    GLuint boneIndexBuffer;
+    GLuint boneWeightBuffer;
     FaceType faceDrawType;
 
     Vector3 scale;
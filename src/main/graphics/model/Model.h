@@ -2,11 +2,13 @@
 #define ENGINE_GRAPHICS_MODEL_MODEL_H_
 
 #include <string>
+#include <cstdint>
 
 #include "io/File.h"
 
 class Material;
 class Mesh;
+class InstanceBuffer;
 
 class Model : public File {
 public:
@@ -21,7 +23,21 @@ public:
     virtual void addMaterial(Material* material) = 0;
     virtual void addMesh(Mesh* mesh) = 0;
     virtual void draw() = 0;
+    /**
+     * Draw the model once per instance in the buffer with a single draw call per mesh.
+     */
+    virtual void drawInstanced(InstanceBuffer *instanceBuffer) = 0;
     virtual bool load() = 0;
+    /**
+     * Import model data to CPU memory. May be called from a worker thread, no GL calls allowed.
+     */
+    virtual bool importData() = 0;
+    /**
+     * Upload imported data to GPU. Must be called from the main thread.
+     * @param deadline SystemTime milliseconds when upload should yield, 0 for no limit
+     * @return true when upload is finished, false if deadline was hit or upload failed (see getError)
+     */
+    virtual bool uploadData(uint64_t deadline = 0) = 0;
 protected:
     explicit Model(std::string filePath);
 };
@@ -9,12 +9,16 @@
 
 #include <assimp/IOStream.hpp>
 #include <assimp/IOSystem.hpp>
+#include <assimp/DefaultIOSystem.h>
 
 #include "Settings.h"
 #include "logger/logger.h"
 
 #include "Material.h"
 #include "Mesh.h"
+#include "InstanceBuffer.h"
+#include "ModelCacheAssimp.h"
+#include "ModelLoader.h"
 
 #include "io/MemoryManager.h"
 #include "math/MathUtils.h"
@@ -26,12 +30,18 @@
 #include "graphics/Graphics.h"
 #include "graphics/Fbo.h"
 
+#include "time/SystemTime.h"
+
 #include "EnginePlayer.h"
 
 #include <sstream>
+#include <mutex>
+#include <algorithm>
 
 #include "glm/gtc/quaternion.hpp"
 #include "glm/gtx/quaternion.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "glm/gtc/type_ptr.hpp"
 
 static std::string matrixToString(const aiMatrix4x4& aiMat) {
     double matrix[16] = {
@@ -68,11 +78,23 @@ Model* Model::newInstance(std::string filePath) {
 }
 
 ModelAssimp::ModelAssimp(std::string filePath) : Model(filePath) {
+    cachedScene = NULL;
+    uploadIndex = 0;
+    loading = false;
     loggerInfo("Model init: '%s'", getFilePath().c_str());
 }
 
 ModelAssimp::~ModelAssimp() {
+    // import may still be running in a worker thread
+    ModelLoader::getInstance().cancel(this);
+
     clear();
+    clearPendingMeshes();
+
+    if (cachedScene) {
+        delete cachedScene;
+        cachedScene = NULL;
+    }
 }
 
 bool ModelAssimp::isSupported() {
@@ -142,6 +164,23 @@ private:
     }
 };
 
+// Records the files opened by the importer, so that the model cache can detect changes in referenced files (e.g. .mtl)
+class AssimpDependencyIOSystem : public Assimp::DefaultIOSystem {
+public:
+    explicit AssimpDependencyIOSystem(std::vector<std::string>& dependencies) : dependencies(dependencies) {}
+    Assimp::IOStream* Open(const char* strFile, const char* strMode) {
+        Assimp::IOStream* stream = Assimp::DefaultIOSystem::Open(strFile, strMode);
+        if (stream && strMode && strMode[0] == 'r'
+                && std::find(dependencies.begin(), dependencies.end(), std::string(strFile)) == dependencies.end()) {
+            dependencies.push_back(std::string(strFile));
+        }
+
+        return stream;
+    }
+private:
+    std::vector<std::string>& dependencies;
+};
+
 class AssimpCustomLogStream :public Assimp::LogStream {
 public:
     void write(const char* message) {
@@ -192,8 +231,16 @@ Mesh *ModelAssimp::getMesh(std::string name) {
     return NULL;
 }
 
+const aiScene* ModelAssimp::getScene() {
+    if (cachedScene) {
+        return cachedScene;
+    }
+
+    return importer.GetScene();
+}
+
 bool ModelAssimp::isLoaded() {
-    if (importer.GetScene() == NULL) {
+    if (loading || getScene() == NULL) {
         return false;
     }
 
@@ -201,28 +248,156 @@ bool ModelAssimp::isLoaded() {
 }
 
 void ModelAssimp::draw() {
-    const aiScene* scene = importer.GetScene();
+    drawScene(NULL);
+}
+
+void ModelAssimp::drawInstanced(InstanceBuffer *instanceBuffer) {
+    if (instanceBuffer == NULL || instanceBuffer->getInstanceCount() == 0) {
+        return;
+    }
+
+    drawScene(instanceBuffer);
+}
+
+void ModelAssimp::drawScene(InstanceBuffer *instanceBuffer) {
+    if (loading) {
+        loggerTrace("Model is being loaded, can't draw. file:'%s'", getFilePath().c_str());
+        return;
+    }
+
+    const aiScene* scene = getScene();
     if (scene == NULL) {
         loggerWarning("No scene imported successfully, can't draw");
         return;
     }
 
+    // node animations are evaluated once per frame, both skinned and unskinned meshes use the same node transformations
+    updateNodeTransformation(scene, scene->mRootNode, glm::dmat4(1.0));
+
+    if (!meshBones.empty()) {
+        drawSkinnedMeshes(scene, instanceBuffer);
+    }
+
     const aiNode *rootNode = scene->mRootNode;
-    drawNode(scene, rootNode);
+    drawNode(scene, rootNode, instanceBuffer);
 }
 
-void ModelAssimp::drawNode(const aiScene* scene, const aiNode *node) {
-    // ref: http://assimp.sourceforge.net/lib_html/structai_node.html
+void ModelAssimp::drawMesh(Mesh *mesh, InstanceBuffer *instanceBuffer) {
+    if (instanceBuffer) {
+        mesh->drawInstanced(instanceBuffer);
+    } else {
+        mesh->draw();
+    }
+}
+
+void ModelAssimp::drawSkinnedMeshes(const aiScene* scene, InstanceBuffer *instanceBuffer) {
+    PROFILER_BLOCK("ModelAssimp::drawSkinnedMeshes");
+
+    // Bone palette is calculated once per frame from the node hierarchy, vertices are skinned in the vertex shader
+    TransformationMatrix& transformationMatrix = TransformationMatrix::getInstance();
+    transformationMatrix.push();
+    transformationMatrix.setModelMode();
+
+    for (auto& it : meshBones) {
+        Mesh *modelMesh = it.first;
+        const std::vector<BoneAssimp>& bones = it.second;
 
+        for (unsigned int boneIndex = 0; boneIndex < bones.size(); boneIndex++) {
+            const BoneAssimp& bone = bones[boneIndex];
+
+            glm::dmat4 nodeTransformation = glm::dmat4(1.0);
+            auto nodeTransformationIt = nodeTransformations.find(bone.node);
+            if (nodeTransformationIt != nodeTransformations.end()) {
+                nodeTransformation = nodeTransformationIt->second.transformation;
+            }
+
+            glm::mat4 boneTransformation = glm::mat4(nodeTransformation * bone.offset);
+            modelMesh->setBoneTransformation(boneIndex, glm::value_ptr(boneTransformation));
+        }
+
+        drawMesh(modelMesh, instanceBuffer);
+    }
+
+    transformationMatrix.pop();
+}
+
+void ModelAssimp::updateNodeTransformation(const aiScene* scene, const aiNode *node, const glm::dmat4& parentTransformation) {
     aiVector3D scale = aiVector3D();
     aiQuaternion rotate = aiQuaternion();
     aiVector3D translate = aiVector3D();
     node->mTransformation.Decompose(scale, rotate, translate);
 
+    animateNode(scene, node, scale, rotate, translate);
+
+    glm::dmat4 transformation = glm::translate(parentTransformation, glm::dvec3(translate.x, translate.y, translate.z));
+    transformation *= glm::mat4_cast(glm::dquat(rotate.w, rotate.x, rotate.y, rotate.z));
+    transformation = glm::scale(transformation, glm::dvec3(scale.x, scale.y, scale.z));
+
+    NodeTransformationAssimp& nodeTransformation = nodeTransformations[node];
+    nodeTransformation.scale = scale;
+    nodeTransformation.rotate = rotate;
+    nodeTransformation.translate = translate;
+    nodeTransformation.transformation = transformation;
+
+    for (unsigned int nodeI = 0; nodeI < node->mNumChildren; nodeI++) {
+        updateNodeTransformation(scene, node->mChildren[nodeI], transformation);
+    }
+}
+
+void ModelAssimp::drawNode(const aiScene* scene, const aiNode *node, InstanceBuffer *instanceBuffer) {
+    // ref: http://assimp.sourceforge.net/lib_html/structai_node.html
+
     TransformationMatrix& transformationMatrix = TransformationMatrix::getInstance();
     transformationMatrix.push();
     transformationMatrix.setModelMode();
 
+    // apply node specific matrix transformations (also applicable for the children nodes)
+    // same T*R*S order as in the bone space node transformations, animations are evaluated by updateNodeTransformation
+    const NodeTransformationAssimp& nodeTransformation = nodeTransformations[node];
+    glm::mat4 instanceNodeTransformation = glm::mat4(1.0f);
+    if (instanceBuffer) {
+        // instances are placed in the model space, so the node hierarchy is applied before the instance transformation in the shader
+        instanceNodeTransformation = glm::mat4(nodeTransformation.transformation);
+    } else {
+        const aiVector3D& translate = nodeTransformation.translate;
+        const aiQuaternion& rotate = nodeTransformation.rotate;
+        const aiVector3D& scale = nodeTransformation.scale;
+        transformationMatrix.translate(translate.x, translate.y, translate.z);
+        transformationMatrix.rotateQuaternion(rotate.w, rotate.x, rotate.y, rotate.z);
+        transformationMatrix.scale(scale.x, scale.y, scale.z);
+    }
+
+    // draw meshes related to the node
+    for (unsigned int meshIndex = 0; meshIndex < node->mNumMeshes; meshIndex++) {
+        Mesh* modelMesh = meshes[node->mMeshes[meshIndex]];
+        if (modelMesh == NULL) {
+            // mesh upload failed
+            continue;
+        }
+
+        if (modelMesh->isSkinned()) {
+            // skinned meshes are drawn in the bone space
+            continue;
+        }
+
+        if (instanceBuffer) {
+            modelMesh->setInstanceNodeTransformation(glm::value_ptr(instanceNodeTransformation));
+            drawMesh(modelMesh, instanceBuffer);
+            modelMesh->setInstanceNodeTransformation(NULL);
+        } else {
+            drawMesh(modelMesh, instanceBuffer);
+        }
+    }
+
+    // process children nodes
+    for (unsigned int nodeI = 0; nodeI < node->mNumChildren; nodeI++) {
+        drawNode(scene, node->mChildren[nodeI], instanceBuffer);
+    }
+
+    transformationMatrix.pop();
+}
+
+void ModelAssimp::animateNode(const aiScene* scene, const aiNode *node, aiVector3D& scale, aiQuaternion& rotate, aiVector3D& translate) {
     if (scene->HasAnimations()) {
         // Animations are handled last, as they may refer to previously processed data (nodes, meshes, cameras, lights)
         for (unsigned int animationI = 0; animationI < scene->mNumAnimations; animationI++) {
@@ -368,28 +543,40 @@ void ModelAssimp::drawNode(const aiScene* scene, const aiNode *node) {
 
         }
     }
+}
 
-    // apply node specific matrix transformations (also applicable for the children nodes)
-    transformationMatrix.scale(scale.x, scale.y, scale.z); // TODO: Should scale be where?
-    transformationMatrix.translate(translate.x, translate.y, translate.z);
-    transformationMatrix.rotateQuaternion(rotate.w, rotate.x, rotate.y, rotate.z);
 
-    // draw meshes related to the node
-    for (unsigned int meshIndex = 0; meshIndex < node->mNumMeshes; meshIndex++) {
-        Mesh* modelMesh = meshes[node->mMeshes[meshIndex]];
-        modelMesh->draw();
-    }
+static void initializeAssimpLogger() {
+    unsigned int severity = Assimp::Logger::Err;
+    switch (Settings::logger.logLevel) {
+        case LEVEL_TRACE:
+            // Info and Debugging logging is really fine level, so TRACE is 
+            severity = Assimp::Logger::Info | Assimp::Logger::Err | Assimp::Logger::Warn | Assimp::Logger::Debugging;
+            break;
+        default:
+            severity = Assimp::Logger::Err | Assimp::Logger::Warn;
+            break;
 
-    // process children nodes
-    for (unsigned int nodeI = 0; nodeI < node->mNumChildren; nodeI++) {
-        drawNode(scene, node->mChildren[nodeI]);
     }
 
-    transformationMatrix.pop();
+    Assimp::DefaultLogger::create(NULL, Assimp::Logger::VERBOSE, 0, NULL);
+    Assimp::DefaultLogger::get()->attachStream(new AssimpCustomLogStream(), severity);
 }
 
-
 bool ModelAssimp::load() {
+    if (loading) {
+        loggerWarning("Model is being loaded asynchronously, can't load. file:'%s'", getFilePath().c_str());
+        return false;
+    }
+
+    if (!importData()) {
+        return false;
+    }
+
+    return uploadData();
+}
+
+bool ModelAssimp::importData() {
     //File file = File("vitunufo2.3ds");
     //File file = File("dollar.obj");
     //File file = File("box.obj");
@@ -416,20 +603,9 @@ bool ModelAssimp::load() {
         return;
     }*/
 
-    unsigned int severity = Assimp::Logger::Err;
-    switch (Settings::logger.logLevel) {
-        case LEVEL_TRACE:
-            // Info and Debugging logging is really fine level, so TRACE is 
-            severity = Assimp::Logger::Info | Assimp::Logger::Err | Assimp::Logger::Warn | Assimp::Logger::Debugging;
-            break;
-        default:
-            severity = Assimp::Logger::Err | Assimp::Logger::Warn;
-            break;
-
-    }
-
-    Assimp::DefaultLogger::create(NULL, Assimp::Logger::VERBOSE, 0, NULL);
-    Assimp::DefaultLogger::get()->attachStream(new AssimpCustomLogStream(), severity);
+    // importing may happen in a worker thread, so logger is set only once
+    static std::once_flag loggerInitialized;
+    std::call_once(loggerInitialized, initializeAssimpLogger);
 
     //importer.SetIOHandler( new AssimpCustomIOSystem());
 
@@ -465,43 +641,116 @@ bool ModelAssimp::load() {
         pFlags |= aiProcess_OptimizeGraph;
     }
 
-    const aiScene* scene = importer.ReadFile(
-        getFilePath().c_str(),
-        pFlags);
+    loading = true;
+
+    const aiScene* scene = NULL;
 
-    /*const aiScene* scene = importer.ReadFileFromMemory(
-        static_cast<void*>(file.getData()), file.length(),
-        aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_FlipUVs | aiProcess_JoinIdenticalVertices);*/
+    std::string cacheFilePath = "";
+    if (Settings::demo.graphics.model.cache) {
+        cacheFilePath = ModelCacheAssimp::getCacheFilePath(getFilePath(), pFlags);
+        if (!cacheFilePath.empty()) {
+            aiScene *cacheScene = ModelCacheAssimp::read(cacheFilePath);
+            if (cacheScene) {
+                // cache hit, post-processing is not needed
+                importer.FreeScene();
+                if (cachedScene) {
+                    delete cachedScene;
+                }
+                cachedScene = cacheScene;
+                scene = cachedScene;
+            }
+        }
+    }
 
     if (scene == NULL) {
-        loggerError("Could not load file. file:'%s', error:%s", getFilePath().c_str(), importer.GetErrorString());
-        return false;
+        std::vector<std::string> dependencies;
+        if (!cacheFilePath.empty()) {
+            // importer takes the ownership of the IO handler
+            importer.SetIOHandler(new AssimpDependencyIOSystem(dependencies));
+        }
+
+        scene = importer.ReadFile(
+            getFilePath().c_str(),
+            pFlags);
+
+        if (!cacheFilePath.empty()) {
+            importer.SetIOHandler(NULL);
+        }
+
+        /*const aiScene* scene = importer.ReadFileFromMemory(
+            static_cast<void*>(file.getData()), file.length(),
+            aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_FlipUVs | aiProcess_JoinIdenticalVertices);*/
+
+        if (scene == NULL) {
+            loggerError("Could not load file. file:'%s', error:%s", getFilePath().c_str(), importer.GetErrorString());
+            loading = false;
+            return false;
+        }
+
+        if (cachedScene) {
+            delete cachedScene;
+            cachedScene = NULL;
+        }
+
+        if (!cacheFilePath.empty()) {
+            ModelCacheAssimp::write(cacheFilePath, scene, getFilePath(), dependencies);
+        }
     }
 
     // http://assimp.sourceforge.net/lib_html/structai_node.html
 
-    clear();
+    if (!scene->HasMeshes()) {
+        loggerWarning("No meshes found in the object, can't load. file:'%s'", getFilePath().c_str());
+        loading = false;
+        return false;
+    }
 
-    if (scene->HasMaterials()) {
-        for (unsigned int i = 0; i < scene->mNumMaterials; i++) {
-            const aiMaterial* material = scene->mMaterials[i];
-            handleMaterial(material);
-        }
+    // CPU side mesh data is prepared here, GPU resources are created in uploadData
+    clearPendingMeshes();
+    for (unsigned int i = 0; i < scene->mNumMeshes; i++) {
+        handleMesh(scene, scene->mMeshes[i]);
     }
+    uploadIndex = 0;
 
-    unsigned int faces = 0;
-    if (scene->HasMeshes()) {
-        for (unsigned int i = 0; i < scene->mNumMeshes; i++) {
-            const aiMesh* mesh = scene->mMeshes[i];
-            faces += mesh->mNumFaces;
+    return true;
+}
 
-            handleMesh(scene, mesh);
-        }
-    } else {
-        loggerWarning("No meshes found in the object, can't load. file:'%s'");
+bool ModelAssimp::uploadData(uint64_t deadline) {
+    PROFILER_BLOCK("ModelAssimp::uploadData");
+
+    const aiScene* scene = getScene();
+    if (scene == NULL) {
+        loggerError("No scene imported, can't upload. file:'%s'", getFilePath().c_str());
+        setError(true);
+        loading = false;
         return false;
     }
 
+    if (uploadIndex == 0) {
+        clear();
+
+        if (scene->HasMaterials()) {
+            for (unsigned int i = 0; i < scene->mNumMaterials; i++) {
+                const aiMaterial* material = scene->mMaterials[i];
+                handleMaterial(material);
+            }
+        }
+    }
+
+    // meshes are uploaded one at a time, so that the upload can be spread over several frames
+    while (uploadIndex < pendingMeshes.size()) {
+        if (deadline > 0 && uploadIndex > 0 && SystemTime::getTimeInMillis() >= deadline) {
+            return false;
+        }
+
+        uploadMesh(scene, pendingMeshes[uploadIndex]);
+        pendingMeshes[uploadIndex].mesh = NULL;
+        uploadIndex++;
+    }
+
+    clearPendingMeshes();
+    uploadIndex = 0;
+
     if (scene->HasLights()) {
         for (unsigned int i = 0; i < scene->mNumLights; i++) {
             const aiLight* light = scene->mLights[i];
@@ -523,16 +772,34 @@ bool ModelAssimp::load() {
     if (Settings::logger.logLevel < LEVEL_INFO) {
         // Print some fine information about the meshes
         for(Mesh* mesh : meshes) {
-            mesh->print();
+            if (mesh) {
+                mesh->print();
+            }
         }
     }
 
+    unsigned int faces = 0;
+    for (unsigned int i = 0; i < scene->mNumMeshes; i++) {
+        faces += scene->mMeshes[i]->mNumFaces;
+    }
+
     loggerInfo("Loaded 3d object. file:'%s', totalFaces:%u, materials:%d, meshes:%u, lights:%u, cameras:%u, animations:%u, ptr:0x%p",
         getFilePath().c_str(), faces, scene->mNumMaterials, scene->mNumMeshes, scene->mNumLights, scene->mNumCameras, scene->mNumAnimations, this);
 
+    loading = false;
+
     return true;
 }
 
+void ModelAssimp::clearPendingMeshes() {
+    for (MeshAssimp& pendingMesh : pendingMeshes) {
+        if (pendingMesh.mesh) {
+            delete pendingMesh.mesh;
+        }
+    }
+    pendingMeshes.clear();
+}
+
 static TextureType getTextureType(aiTextureType assimpTextureType) {
     switch(assimpTextureType) {
         case aiTextureType_NORMALS:
@@ -657,8 +924,6 @@ bool ModelAssimp::handleMaterial(const aiMaterial* material) {
 }
 
 bool ModelAssimp::handleMesh(const aiScene* scene, const aiMesh* mesh) {
-    const aiVector3D Zero3D(0.0f, 0.0f, 0.0f);
-
     //m_Entries[Index].MaterialIndex = paiMesh->mMaterialIndex;
     Mesh *modelMesh = new Mesh();
     if (modelMesh == NULL) {
@@ -667,35 +932,66 @@ bool ModelAssimp::handleMesh(const aiScene* scene, const aiMesh* mesh) {
     }
     modelMesh->setName(std::string(mesh->mName.data));
 
-    //if (scene->mNumMaterial)
-    if (scene->HasMaterials()) {
-        modelMesh->setMaterial(getMaterial(mesh->mMaterialIndex));
+    // assimp vectors are tightly packed floats, so positions and normals are assigned as whole arrays
+    static_assert(sizeof(aiVector3D) == 3 * sizeof(float), "aiVector3D must be three floats");
+    modelMesh->setVertices(reinterpret_cast<const float*>(mesh->mVertices), mesh->mNumVertices * 3);
+    if (mesh->HasNormals()) {
+        modelMesh->setNormals(reinterpret_cast<const float*>(mesh->mNormals), mesh->mNumVertices * 3);
     }
 
-    for (unsigned int i = 0; i < mesh->mNumVertices ; i++) {
-        const aiVector3D* pPos      = &(mesh->mVertices[i]);
-        const aiVector3D* pNormal   = &(mesh->mNormals[i]);
-        const aiVector3D* pTexCoord = mesh->HasTextureCoords(0) ? &(mesh->mTextureCoords[0][i]) : &Zero3D;
+    std::vector<float> texCoords(mesh->mNumVertices * 2, 0.0f);
+    if (mesh->HasTextureCoords(0)) {
+        for (unsigned int i = 0; i < mesh->mNumVertices; i++) {
+            const aiVector3D& texCoord = mesh->mTextureCoords[0][i];
+            texCoords[i * 2] = texCoord.x;
+            texCoords[i * 2 + 1] = texCoord.y;
+        }
+    }
+    modelMesh->setTexCoords(texCoords.data(), texCoords.size());
+
+    MeshAssimp pendingMesh;
+    pendingMesh.mesh = modelMesh;
+    pendingMesh.source = mesh;
 
-        modelMesh->addVertex(pPos->x, pPos->y, pPos->z);
-        if (mesh->HasNormals()) {
-            modelMesh->addNormal(pNormal->x, pNormal->y, pNormal->z);
+    std::vector<BoneAssimp>& bones = pendingMesh.bones;
+    if (mesh->HasBones()) {
+        if (mesh->mNumBones > MAX_BONE_COUNT) {
+            loggerWarning("Mesh has too many bones, extra bones ignored. file:'%s', meshName:'%s', bones:%u, maxBoneCount:%d",
+                getFilePath().c_str(), mesh->mName.data, mesh->mNumBones, MAX_BONE_COUNT);
+        }
+
+        for (unsigned int boneI = 0; boneI < mesh->mNumBones && boneI < MAX_BONE_COUNT; boneI++) {
+            // ref: http://assimp.sourceforge.net/lib_html/structai_bone.html
+            const aiBone* bone = mesh->mBones[boneI];
+
+            BoneAssimp modelBone;
+            modelBone.node = scene->mRootNode->FindNode(bone->mName);
+            if (modelBone.node == NULL) {
+                loggerWarning("Bone node not found. file:'%s', meshName:'%s', bone:'%s'", getFilePath().c_str(), mesh->mName.data, bone->mName.data);
+            }
+
+            // offset matrix transforms from mesh space to bone space in bind pose
+            const aiMatrix4x4& m = bone->mOffsetMatrix;
+            modelBone.offset = glm::dmat4(
+                m.a1, m.b1, m.c1, m.d1,
+                m.a2, m.b2, m.c2, m.d2,
+                m.a3, m.b3, m.c3, m.d3,
+                m.a4, m.b4, m.c4, m.d4);
+            bones.push_back(modelBone);
+
+            for (unsigned int weightI = 0; weightI < bone->mNumWeights; weightI++) {
+                const aiVertexWeight& vertexWeight = bone->mWeights[weightI];
+                modelMesh->addBoneWeight(vertexWeight.mVertexId, boneI, vertexWeight.mWeight);
+            }
         }
-        modelMesh->addTexCoord(pTexCoord->x, pTexCoord->y);
-        /*loggerTrace("%u/%u: v: x:%.2f y:%.2f z:%2.f - vt: u:%.2f v:%.2f - vn: x:%.2f y:%.2f z:%2.f",
-            i, mesh->mNumVertices,
-            pPos->x, pPos->y, pPos->z,
-            pTexCoord->x, pTexCoord->y,
-            pNormal->x, pNormal->y, pNormal->z);*/
     }
 
+    std::vector<unsigned int> indices;
+    indices.reserve(mesh->mNumFaces * 3);
     unsigned int origNumIndices = 0;
     for (unsigned int i = 0; i < mesh->mNumFaces; i++) {
-        //FIXME: addIndex should take only one parameter
         const aiFace& face = mesh->mFaces[i];
-        for (unsigned int faceIndex = 0; faceIndex < face.mNumIndices; faceIndex++) {
-            modelMesh->addIndex(face.mIndices[faceIndex]);
-        }
+        indices.insert(indices.end(), face.mIndices, face.mIndices + face.mNumIndices);
         if (origNumIndices > 0 && origNumIndices != face.mNumIndices) {
             loggerInfo("Face indice count varying. face:%u/%u, expected:%u, actual:%u", i, mesh->mNumFaces, origNumIndices, face.mNumIndices);
         }
@@ -709,19 +1005,40 @@ bool ModelAssimp::handleMesh(const aiScene* scene, const aiMesh* mesh) {
         }*/
         origNumIndices = face.mNumIndices;
     }
+    modelMesh->setIndices(indices.data(), indices.size());
     /*if (origNumIndices != 3) {
         loggerInfo("Face has %u indices. Not a triangle? faces:%u, file:'%s'", origNumIndices, mesh->mNumFaces, getFilePath().c_str());
     }*/
 
+    pendingMeshes.push_back(pendingMesh);
+
+    return true;
+}
+
+bool ModelAssimp::uploadMesh(const aiScene* scene, MeshAssimp& pendingMesh) {
+    Mesh *modelMesh = pendingMesh.mesh;
+    const aiMesh *mesh = pendingMesh.source;
+
+    //if (scene->mNumMaterial)
+    if (scene->HasMaterials()) {
+        modelMesh->setMaterial(getMaterial(mesh->mMaterialIndex));
+    }
+
     std::string materialName = "NULL";
     if (modelMesh->getMaterial()) {
         materialName = modelMesh->getMaterial()->getName();
     }
     if (modelMesh->generate()) {
-        loggerDebug("Generated mesh. file:'%s', meshName:'%s', faces:%u, material:'%s'", getFilePath().c_str(), mesh->mName.data, mesh->mNumFaces, materialName.c_str());
+        loggerDebug("Generated mesh. file:'%s', meshName:'%s', faces:%u, bones:%u, material:'%s'", getFilePath().c_str(), mesh->mName.data, mesh->mNumFaces, pendingMesh.bones.size(), materialName.c_str());
         addMesh(modelMesh);
+        if (modelMesh->isSkinned()) {
+            meshBones[modelMesh] = pendingMesh.bones;
+        }
     } else {
         loggerWarning("Could not generate mesh. file:'%s', meshName:'%s', material:'%s'", getFilePath().c_str(), mesh->mName.data, materialName.c_str());
+        delete modelMesh;
+        // keep the slot, node mesh indices refer to the scene mesh order
+        addMesh(NULL);
         return false;
     }
 
@@ -817,4 +1134,7 @@ void ModelAssimp::clear() {
         }
     }
     materials.clear();
+
+    meshBones.clear();
+    nodeTransformations.clear();
 }
@@ -2,10 +2,15 @@
 #define ENGINE_GRAPHICS_MODEL_MODELASSIMP_H_
 
 #include <vector>
+#include <map>
+#include <atomic>
 
 #include "Model.h"
 
 #include <assimp/Importer.hpp>
+#include <assimp/types.h>
+
+#include "glm/glm.hpp"
 
 struct aiScene;
 struct aiMaterial;
@@ -15,6 +20,26 @@ struct aiAnimation;
 struct aiCamera;
 struct aiLight;
 
+struct BoneAssimp {
+    const aiNode *node;
+    glm::dmat4 offset;
+};
+
+struct NodeTransformationAssimp {
+    // animated node transformation relative to the parent node
+    aiVector3D scale;
+    aiQuaternion rotate;
+    aiVector3D translate;
+    // node transformation in the model space
+    glm::dmat4 transformation;
+};
+
+struct MeshAssimp {
+    Mesh *mesh;
+    const aiMesh *source;
+    std::vector<BoneAssimp> bones;
+};
+
 class ModelAssimp : public Model {
 public:
     explicit ModelAssimp(std::string filePath);
@@ -28,20 +53,37 @@ public:
     void addMaterial(Material* material);
     void addMesh(Mesh* mesh);
     void draw();
+    void drawInstanced(InstanceBuffer *instanceBuffer);
     bool load();
+    bool importData();
+    bool uploadData(uint64_t deadline = 0);
     void clear();
 protected:
     std::vector<Material*> materials;
     std::vector<Mesh*> meshes;
 private:
-    void drawNode(const aiScene* scene, const aiNode *node);
+    const aiScene* getScene();
+    void drawScene(InstanceBuffer *instanceBuffer);
+    void drawNode(const aiScene* scene, const aiNode *node, InstanceBuffer *instanceBuffer);
+    void drawSkinnedMeshes(const aiScene* scene, InstanceBuffer *instanceBuffer);
+    void drawMesh(Mesh *mesh, InstanceBuffer *instanceBuffer);
+    void animateNode(const aiScene* scene, const aiNode *node, aiVector3D& scale, aiQuaternion& rotate, aiVector3D& translate);
+    void updateNodeTransformation(const aiScene* scene, const aiNode *node, const glm::dmat4& parentTransformation);
 
     bool handleMaterial(const aiMaterial* material);
     bool handleMesh(const aiScene* scene, const aiMesh* mesh);
+    bool uploadMesh(const aiScene* scene, MeshAssimp& pendingMesh);
+    void clearPendingMeshes();
     bool handleCamera(const aiCamera* camera);
     bool handleLight(const aiLight* light);
 
     Assimp::Importer importer;
+    aiScene *cachedScene;
+    std::map<Mesh*, std::vector<BoneAssimp>> meshBones;
+    std::map<const aiNode*, NodeTransformationAssimp> nodeTransformations;
+    std::vector<MeshAssimp> pendingMeshes;
+    size_t uploadIndex;
+    std::atomic<bool> loading;
 };
 
 #endif /*ENGINE_GRAPHICS_MODEL_MODELASSIMP_H_*/
@@ -0,0 +1,696 @@
+#include "ModelCacheAssimp.h"
+
+#include <assimp/scene.h>
+#include <assimp/material.h>
+
+#include "Settings.h"
+#include "io/File.h"
+#include "logger/logger.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <errno.h>
+
+#include <atomic>
+#include <vector>
+
+// Bump the version whenever the cache file layout changes
+#define CACHE_MAGIC 0x434c444d // "MDLC"
+#define CACHE_VERSION 2
+
+class CacheWriter {
+public:
+    void write(const void *value, size_t size) {
+        const unsigned char *bytes = reinterpret_cast<const unsigned char*>(value);
+        data.insert(data.end(), bytes, bytes + size);
+    }
+
+    void writeUint(uint32_t value) {
+        write(&value, sizeof(value));
+    }
+
+    void writeDouble(double value) {
+        write(&value, sizeof(value));
+    }
+
+    void writeUint64(uint64_t value) {
+        write(&value, sizeof(value));
+    }
+
+    void writeString(const std::string& value) {
+        writeUint(static_cast<uint32_t>(value.size()));
+        write(value.data(), value.size());
+    }
+
+    void writeString(const aiString& value) {
+        writeUint(value.length);
+        write(value.data, value.length);
+    }
+
+    std::vector<unsigned char> data;
+};
+
+class CacheReader {
+public:
+    CacheReader(const unsigned char *data, size_t size) {
+        this->data = data;
+        this->size = size;
+        position = 0;
+        error = false;
+    }
+
+    bool read(void *value, size_t readSize) {
+        if (error || position + readSize > size) {
+            error = true;
+            return false;
+        }
+
+        memcpy(value, data + position, readSize);
+        position += readSize;
+        return true;
+    }
+
+    uint32_t readUint() {
+        uint32_t value = 0;
+        read(&value, sizeof(value));
+        return value;
+    }
+
+    double readDouble() {
+        double value = 0.0;
+        read(&value, sizeof(value));
+        return value;
+    }
+
+    uint64_t readUint64() {
+        uint64_t value = 0;
+        read(&value, sizeof(value));
+        return value;
+    }
+
+    void readString(std::string& value) {
+        uint32_t length = readUint();
+        if (!hasCapacity(length, 1)) {
+            return;
+        }
+
+        value.assign(reinterpret_cast<const char*>(data + position), length);
+        position += length;
+    }
+
+    void readString(aiString& value) {
+        uint32_t length = readUint();
+        if (length >= MAXLEN) {
+            error = true;
+            return;
+        }
+
+        value.length = length;
+        read(value.data, length);
+        value.data[length] = '\0';
+    }
+
+    // sanity check for element counts, prevents huge allocations from corrupted files
+    bool hasCapacity(uint32_t count, size_t elementSize) {
+        if (error || position + static_cast<size_t>(count) * elementSize > size) {
+            error = true;
+            return false;
+        }
+
+        return true;
+    }
+
+    bool error;
+private:
+    const unsigned char *data;
+    size_t size;
+    size_t position;
+};
+
+static void writeMaterial(CacheWriter& writer, const aiMaterial* material) {
+    writer.writeUint(material->mNumProperties);
+    for (unsigned int i = 0; i < material->mNumProperties; i++) {
+        const aiMaterialProperty* property = material->mProperties[i];
+        writer.writeString(property->mKey);
+        writer.writeUint(property->mSemantic);
+        writer.writeUint(property->mIndex);
+        writer.writeUint(static_cast<uint32_t>(property->mType));
+        writer.writeUint(property->mDataLength);
+        writer.write(property->mData, property->mDataLength);
+    }
+}
+
+static aiMaterial* readMaterial(CacheReader& reader) {
+    aiMaterial* material = new aiMaterial();
+
+    uint32_t numProperties = reader.readUint();
+    for (uint32_t i = 0; i < numProperties && !reader.error; i++) {
+        aiString key;
+        reader.readString(key);
+        uint32_t semantic = reader.readUint();
+        uint32_t index = reader.readUint();
+        aiPropertyTypeInfo type = static_cast<aiPropertyTypeInfo>(reader.readUint());
+        uint32_t dataLength = reader.readUint();
+        if (!reader.hasCapacity(dataLength, 1)) {
+            break;
+        }
+
+        std::vector<char> data(dataLength);
+        reader.read(data.data(), dataLength);
+        material->AddBinaryProperty(data.data(), dataLength, key.data, semantic, index, type);
+    }
+
+    return material;
+}
+
+static void writeMesh(CacheWriter& writer, const aiMesh* mesh) {
+    writer.writeString(mesh->mName);
+    writer.writeUint(mesh->mMaterialIndex);
+    writer.writeUint(mesh->mPrimitiveTypes);
+
+    writer.writeUint(mesh->mNumVertices);
+    writer.write(mesh->mVertices, sizeof(aiVector3D) * mesh->mNumVertices);
+
+    writer.writeUint(mesh->HasNormals() ? 1 : 0);
+    if (mesh->HasNormals()) {
+        writer.write(mesh->mNormals, sizeof(aiVector3D) * mesh->mNumVertices);
+    }
+
+    writer.writeUint(mesh->HasTextureCoords(0) ? 1 : 0);
+    if (mesh->HasTextureCoords(0)) {
+        writer.writeUint(mesh->mNumUVComponents[0]);
+        writer.write(mesh->mTextureCoords[0], sizeof(aiVector3D) * mesh->mNumVertices);
+    }
+
+    writer.writeUint(mesh->mNumFaces);
+    for (unsigned int i = 0; i < mesh->mNumFaces; i++) {
+        const aiFace& face = mesh->mFaces[i];
+        writer.writeUint(face.mNumIndices);
+        writer.write(face.mIndices, sizeof(unsigned int) * face.mNumIndices);
+    }
+
+    writer.writeUint(mesh->mNumBones);
+    for (unsigned int i = 0; i < mesh->mNumBones; i++) {
+        const aiBone* bone = mesh->mBones[i];
+        writer.writeString(bone->mName);
+        writer.write(&bone->mOffsetMatrix, sizeof(bone->mOffsetMatrix));
+        writer.writeUint(bone->mNumWeights);
+        writer.write(bone->mWeights, sizeof(aiVertexWeight) * bone->mNumWeights);
+    }
+}
+
+static aiMesh* readMesh(CacheReader& reader) {
+    aiMesh* mesh = new aiMesh();
+
+    reader.readString(mesh->mName);
+    mesh->mMaterialIndex = reader.readUint();
+    mesh->mPrimitiveTypes = reader.readUint();
+
+    uint32_t numVertices = reader.readUint();
+    if (!reader.hasCapacity(numVertices, sizeof(aiVector3D))) {
+        return mesh;
+    }
+    mesh->mNumVertices = numVertices;
+    mesh->mVertices = new aiVector3D[numVertices];
+    reader.read(mesh->mVertices, sizeof(aiVector3D) * numVertices);
+
+    if (reader.readUint() && reader.hasCapacity(numVertices, sizeof(aiVector3D))) {
+        mesh->mNormals = new aiVector3D[numVertices];
+        reader.read(mesh->mNormals, sizeof(aiVector3D) * numVertices);
+    }
+
+    if (reader.readUint() && reader.hasCapacity(numVertices, sizeof(aiVector3D))) {
+        mesh->mNumUVComponents[0] = reader.readUint();
+        mesh->mTextureCoords[0] = new aiVector3D[numVertices];
+        reader.read(mesh->mTextureCoords[0], sizeof(aiVector3D) * numVertices);
+    }
+
+    uint32_t numFaces = reader.readUint();
+    if (!reader.hasCapacity(numFaces, sizeof(uint32_t))) {
+        return mesh;
+    }
+    mesh->mNumFaces = numFaces;
+    mesh->mFaces = new aiFace[numFaces];
+    for (uint32_t i = 0; i < numFaces && !reader.error; i++) {
+        aiFace& face = mesh->mFaces[i];
+        uint32_t numIndices = reader.readUint();
+        if (!reader.hasCapacity(numIndices, sizeof(unsigned int))) {
+            break;
+        }
+        face.mNumIndices = numIndices;
+        face.mIndices = new unsigned int[numIndices];
+        reader.read(face.mIndices, sizeof(unsigned int) * numIndices);
+    }
+
+    uint32_t numBones = reader.readUint();
+    if (!reader.hasCapacity(numBones, sizeof(aiMatrix4x4))) {
+        return mesh;
+    }
+    mesh->mNumBones = numBones;
+    mesh->mBones = new aiBone*[numBones];
+    for (uint32_t i = 0; i < numBones; i++) {
+        mesh->mBones[i] = new aiBone();
+    }
+    for (uint32_t i = 0; i < numBones && !reader.error; i++) {
+        aiBone* bone = mesh->mBones[i];
+        reader.readString(bone->mName);
+        reader.read(&bone->mOffsetMatrix, sizeof(bone->mOffsetMatrix));
+        uint32_t numWeights = reader.readUint();
+        if (!reader.hasCapacity(numWeights, sizeof(aiVertexWeight))) {
+            break;
+        }
+        bone->mNumWeights = numWeights;
+        bone->mWeights = new aiVertexWeight[numWeights];
+        reader.read(bone->mWeights, sizeof(aiVertexWeight) * numWeights);
+    }
+
+    return mesh;
+}
+
+static void writeNode(CacheWriter& writer, const aiNode* node) {
+    writer.writeString(node->mName);
+    writer.write(&node->mTransformation, sizeof(node->mTransformation));
+
+    writer.writeUint(node->mNumMeshes);
+    writer.write(node->mMeshes, sizeof(unsigned int) * node->mNumMeshes);
+
+    writer.writeUint(node->mNumChildren);
+    for (unsigned int i = 0; i < node->mNumChildren; i++) {
+        writeNode(writer, node->mChildren[i]);
+    }
+}
+
+static aiNode* readNode(CacheReader& reader, aiNode* parent) {
+    aiNode* node = new aiNode();
+    node->mParent = parent;
+
+    reader.readString(node->mName);
+    reader.read(&node->mTransformation, sizeof(node->mTransformation));
+
+    uint32_t numMeshes = reader.readUint();
+    if (!reader.hasCapacity(numMeshes, sizeof(unsigned int))) {
+        return node;
+    }
+    node->mNumMeshes = numMeshes;
+    node->mMeshes = new unsigned int[numMeshes];
+    reader.read(node->mMeshes, sizeof(unsigned int) * numMeshes);
+
+    uint32_t numChildren = reader.readUint();
+    if (!reader.hasCapacity(numChildren, sizeof(aiMatrix4x4))) {
+        return node;
+    }
+    node->mNumChildren = numChildren;
+    node->mChildren = new aiNode*[numChildren];
+    for (uint32_t i = 0; i < numChildren; i++) {
+        node->mChildren[i] = NULL;
+    }
+    for (uint32_t i = 0; i < numChildren && !reader.error; i++) {
+        node->mChildren[i] = readNode(reader, node);
+    }
+
+    return node;
+}
+
+static void writeAnimation(CacheWriter& writer, const aiAnimation* animation) {
+    writer.writeString(animation->mName);
+    writer.writeDouble(animation->mDuration);
+    writer.writeDouble(animation->mTicksPerSecond);
+
+    writer.writeUint(animation->mNumChannels);
+    for (unsigned int i = 0; i < animation->mNumChannels; i++) {
+        const aiNodeAnim* channel = animation->mChannels[i];
+        writer.writeString(channel->mNodeName);
+        writer.writeUint(static_cast<uint32_t>(channel->mPreState));
+        writer.writeUint(static_cast<uint32_t>(channel->mPostState));
+        writer.writeUint(channel->mNumPositionKeys);
+        writer.write(channel->mPositionKeys, sizeof(aiVectorKey) * channel->mNumPositionKeys);
+        writer.writeUint(channel->mNumRotationKeys);
+        writer.write(channel->mRotationKeys, sizeof(aiQuatKey) * channel->mNumRotationKeys);
+        writer.writeUint(channel->mNumScalingKeys);
+        writer.write(channel->mScalingKeys, sizeof(aiVectorKey) * channel->mNumScalingKeys);
+    }
+}
+
+static aiAnimation* readAnimation(CacheReader& reader) {
+    aiAnimation* animation = new aiAnimation();
+
+    reader.readString(animation->mName);
+    animation->mDuration = reader.readDouble();
+    animation->mTicksPerSecond = reader.readDouble();
+
+    uint32_t numChannels = reader.readUint();
+    if (!reader.hasCapacity(numChannels, sizeof(uint32_t))) {
+        return animation;
+    }
+    animation->mNumChannels = numChannels;
+    animation->mChannels = new aiNodeAnim*[numChannels];
+    for (uint32_t i = 0; i < numChannels; i++) {
+        animation->mChannels[i] = new aiNodeAnim();
+    }
+    for (uint32_t i = 0; i < numChannels && !reader.error; i++) {
+        aiNodeAnim* channel = animation->mChannels[i];
+        reader.readString(channel->mNodeName);
+        channel->mPreState = static_cast<aiAnimBehaviour>(reader.readUint());
+        channel->mPostState = static_cast<aiAnimBehaviour>(reader.readUint());
+
+        uint32_t numPositionKeys = reader.readUint();
+        if (!reader.hasCapacity(numPositionKeys, sizeof(aiVectorKey))) {
+            break;
+        }
+        channel->mNumPositionKeys = numPositionKeys;
+        channel->mPositionKeys = new aiVectorKey[numPositionKeys];
+        reader.read(channel->mPositionKeys, sizeof(aiVectorKey) * numPositionKeys);
+
+        uint32_t numRotationKeys = reader.readUint();
+        if (!reader.hasCapacity(numRotationKeys, sizeof(aiQuatKey))) {
+            break;
+        }
+        channel->mNumRotationKeys = numRotationKeys;
+        channel->mRotationKeys = new aiQuatKey[numRotationKeys];
+        reader.read(channel->mRotationKeys, sizeof(aiQuatKey) * numRotationKeys);
+
+        uint32_t numScalingKeys = reader.readUint();
+        if (!reader.hasCapacity(numScalingKeys, sizeof(aiVectorKey))) {
+            break;
+        }
+        channel->mNumScalingKeys = numScalingKeys;
+        channel->mScalingKeys = new aiVectorKey[numScalingKeys];
+        reader.read(channel->mScalingKeys, sizeof(aiVectorKey) * numScalingKeys);
+    }
+
+    return animation;
+}
+
+static void writeLight(CacheWriter& writer, const aiLight* light) {
+    writer.writeString(light->mName);
+    writer.writeUint(static_cast<uint32_t>(light->mType));
+    writer.write(&light->mPosition, sizeof(light->mPosition));
+    writer.write(&light->mDirection, sizeof(light->mDirection));
+    writer.write(&light->mAttenuationConstant, sizeof(light->mAttenuationConstant));
+    writer.write(&light->mAttenuationLinear, sizeof(light->mAttenuationLinear));
+    writer.write(&light->mAttenuationQuadratic, sizeof(light->mAttenuationQuadratic));
+    writer.write(&light->mColorDiffuse, sizeof(light->mColorDiffuse));
+    writer.write(&light->mColorSpecular, sizeof(light->mColorSpecular));
+    writer.write(&light->mColorAmbient, sizeof(light->mColorAmbient));
+    writer.write(&light->mAngleInnerCone, sizeof(light->mAngleInnerCone));
+    writer.write(&light->mAngleOuterCone, sizeof(light->mAngleOuterCone));
+}
+
+static aiLight* readLight(CacheReader& reader) {
+    aiLight* light = new aiLight();
+
+    reader.readString(light->mName);
+    light->mType = static_cast<aiLightSourceType>(reader.readUint());
+    reader.read(&light->mPosition, sizeof(light->mPosition));
+    reader.read(&light->mDirection, sizeof(light->mDirection));
+    reader.read(&light->mAttenuationConstant, sizeof(light->mAttenuationConstant));
+    reader.read(&light->mAttenuationLinear, sizeof(light->mAttenuationLinear));
+    reader.read(&light->mAttenuationQuadratic, sizeof(light->mAttenuationQuadratic));
+    reader.read(&light->mColorDiffuse, sizeof(light->mColorDiffuse));
+    reader.read(&light->mColorSpecular, sizeof(light->mColorSpecular));
+    reader.read(&light->mColorAmbient, sizeof(light->mColorAmbient));
+    reader.read(&light->mAngleInnerCone, sizeof(light->mAngleInnerCone));
+    reader.read(&light->mAngleOuterCone, sizeof(light->mAngleOuterCone));
+
+    return light;
+}
+
+static void writeCamera(CacheWriter& writer, const aiCamera* camera) {
+    writer.writeString(camera->mName);
+    writer.write(&camera->mPosition, sizeof(camera->mPosition));
+    writer.write(&camera->mUp, sizeof(camera->mUp));
+    writer.write(&camera->mLookAt, sizeof(camera->mLookAt));
+    writer.write(&camera->mHorizontalFOV, sizeof(camera->mHorizontalFOV));
+    writer.write(&camera->mClipPlaneNear, sizeof(camera->mClipPlaneNear));
+    writer.write(&camera->mClipPlaneFar, sizeof(camera->mClipPlaneFar));
+    writer.write(&camera->mAspect, sizeof(camera->mAspect));
+}
+
+static aiCamera* readCamera(CacheReader& reader) {
+    aiCamera* camera = new aiCamera();
+
+    reader.readString(camera->mName);
+    reader.read(&camera->mPosition, sizeof(camera->mPosition));
+    reader.read(&camera->mUp, sizeof(camera->mUp));
+    reader.read(&camera->mLookAt, sizeof(camera->mLookAt));
+    reader.read(&camera->mHorizontalFOV, sizeof(camera->mHorizontalFOV));
+    reader.read(&camera->mClipPlaneNear, sizeof(camera->mClipPlaneNear));
+    reader.read(&camera->mClipPlaneFar, sizeof(camera->mClipPlaneFar));
+    reader.read(&camera->mAspect, sizeof(camera->mAspect));
+
+    return camera;
+}
+
+// Allocates the array and reads elements until an error occurs, so that aiScene destructor can clean up partial data
+#define READ_SCENE_ARRAY(reader, scene, type, count, array, readFunction) \
+    { \
+        uint32_t elementCount = reader.readUint(); \
+        if (reader.hasCapacity(elementCount, sizeof(uint32_t))) { \
+            scene->array = new type*[elementCount]; \
+            for (uint32_t i = 0; i < elementCount && !reader.error; i++) { \
+                scene->array[i] = readFunction(reader); \
+                scene->count = i + 1; \
+            } \
+        } \
+    }
+
+static uint64_t hashFile(const std::string& filePath) {
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ULL;
+
+    FILE *fp = fopen(filePath.c_str(), "rb");
+    if (fp == NULL) {
+        return 0;
+    }
+
+    unsigned char buffer[64 * 1024];
+    size_t readBytes = 0;
+    while ((readBytes = fread(buffer, 1, sizeof(buffer), fp)) > 0) {
+        for (size_t i = 0; i < readBytes; i++) {
+            hash ^= buffer[i];
+            hash *= 1099511628211ULL;
+        }
+    }
+
+    fclose(fp);
+
+    return hash;
+}
+
+static bool createDirectory(const std::string& path) {
+#ifdef _WIN32
+    return mkdir(path.c_str()) == 0 || errno == EEXIST;
+#else
+    return mkdir(path.c_str(), 0755) == 0 || errno == EEXIST;
+#endif
+}
+
+// creates all missing parent directories of the file
+static bool createParentDirectories(const std::string& filePath) {
+    for (size_t separator = filePath.find_first_of("/\\", 1); separator != std::string::npos; separator = filePath.find_first_of("/\\", separator + 1)) {
+        std::string directory = filePath.substr(0, separator);
+        if (directory.back() == ':' || directory.back() == '.') {
+            // drive letter or relative path component
+            continue;
+        }
+
+        if (!createDirectory(directory)) {
+            loggerWarning("Could not create model cache directory. directory:'%s'", directory.c_str());
+            return false;
+        }
+    }
+
+    return true;
+}
+
+std::string ModelCacheAssimp::getCacheFilePath(const std::string& sourceFilePath, unsigned int importFlags) {
+    uint64_t hash = hashFile(sourceFilePath);
+    if (hash == 0) {
+        return std::string("");
+    }
+
+    char fileName[64];
+    snprintf(fileName, sizeof(fileName), "%016llx_%08x_%d.model", static_cast<unsigned long long>(hash), importFlags, CACHE_VERSION);
+
+    std::string cacheDirectory = Settings::demo.graphics.model.cacheDirectory;
+    if (!cacheDirectory.empty() && cacheDirectory.back() != '/') {
+        cacheDirectory += '/';
+    }
+
+    // relative cache directory is kept under the project data directory, not the working directory
+    bool absolute = !cacheDirectory.empty() && (cacheDirectory[0] == '/' || cacheDirectory[0] == '\\'
+        || (cacheDirectory.size() > 1 && cacheDirectory[1] == ':'));
+    if (!absolute) {
+        cacheDirectory = File::getProjectPath() + cacheDirectory;
+    }
+
+    return cacheDirectory + std::string(fileName);
+}
+
+aiScene* ModelCacheAssimp::read(const std::string& cacheFilePath) {
+    PROFILER_BLOCK("ModelCacheAssimp::read");
+
+    FILE *fp = fopen(cacheFilePath.c_str(), "rb");
+    if (fp == NULL) {
+        loggerTrace("Model cache miss. cacheFile:'%s'", cacheFilePath.c_str());
+        return NULL;
+    }
+
+    fseek(fp, 0, SEEK_END);
+    long fileSize = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+
+    std::vector<unsigned char> data(fileSize > 0 ? static_cast<size_t>(fileSize) : 0);
+    size_t readBytes = data.empty() ? 0 : fread(data.data(), 1, data.size(), fp);
+    fclose(fp);
+
+    if (data.empty() || readBytes != data.size()) {
+        loggerWarning("Could not read model cache. cacheFile:'%s', readBytes:%u, fileSize:%ld", cacheFilePath.c_str(), readBytes, fileSize);
+        return NULL;
+    }
+
+    CacheReader reader(data.data(), data.size());
+    if (reader.readUint() != CACHE_MAGIC || reader.readUint() != CACHE_VERSION
+            || reader.readUint() != static_cast<uint32_t>(sizeof(aiVector3D))) {
+        loggerWarning("Model cache not compatible. cacheFile:'%s'", cacheFilePath.c_str());
+        return NULL;
+    }
+
+    // files referenced by the model are not part of the cache key, cache is stale if any of them changed
+    uint32_t dependencyCount = reader.readUint();
+    for (uint32_t i = 0; i < dependencyCount && !reader.error; i++) {
+        std::string dependency;
+        reader.readString(dependency);
+        uint64_t hash = reader.readUint64();
+        if (!reader.error && hashFile(dependency) != hash) {
+            loggerDebug("Model cache stale, referenced file changed. cacheFile:'%s', file:'%s'", cacheFilePath.c_str(), dependency.c_str());
+            return NULL;
+        }
+    }
+
+    if (reader.error) {
+        loggerWarning("Model cache corrupted. cacheFile:'%s'", cacheFilePath.c_str());
+        return NULL;
+    }
+
+    aiScene* scene = new aiScene();
+    scene->mFlags = reader.readUint();
+
+    READ_SCENE_ARRAY(reader, scene, aiMaterial, mNumMaterials, mMaterials, readMaterial);
+    READ_SCENE_ARRAY(reader, scene, aiMesh, mNumMeshes, mMeshes, readMesh);
+    READ_SCENE_ARRAY(reader, scene, aiAnimation, mNumAnimations, mAnimations, readAnimation);
+    READ_SCENE_ARRAY(reader, scene, aiLight, mNumLights, mLights, readLight);
+    READ_SCENE_ARRAY(reader, scene, aiCamera, mNumCameras, mCameras, readCamera);
+
+    if (!reader.error) {
+        scene->mRootNode = readNode(reader, NULL);
+    }
+
+    if (reader.error) {
+        loggerWarning("Model cache corrupted. cacheFile:'%s'", cacheFilePath.c_str());
+        delete scene;
+        return NULL;
+    }
+
+    loggerDebug("Model cache hit. cacheFile:'%s', size:%ld", cacheFilePath.c_str(), fileSize);
+
+    return scene;
+}
+
+bool ModelCacheAssimp::write(const std::string& cacheFilePath, const aiScene* scene, const std::string& sourceFilePath, const std::vector<std::string>& dependencies) {
+    PROFILER_BLOCK("ModelCacheAssimp::write");
+
+    if (scene == NULL || scene->mRootNode == NULL) {
+        return false;
+    }
+
+    CacheWriter writer;
+    writer.writeUint(CACHE_MAGIC);
+    writer.writeUint(CACHE_VERSION);
+    writer.writeUint(static_cast<uint32_t>(sizeof(aiVector3D)));
+
+    std::vector<std::string> referencedFiles;
+    for (const std::string& dependency : dependencies) {
+        // source file content is already in the cache file name
+        if (dependency != sourceFilePath) {
+            referencedFiles.push_back(dependency);
+        }
+    }
+
+    writer.writeUint(static_cast<uint32_t>(referencedFiles.size()));
+    for (const std::string& referencedFile : referencedFiles) {
+        writer.writeString(referencedFile);
+        writer.writeUint64(hashFile(referencedFile));
+    }
+
+    writer.writeUint(scene->mFlags);
+
+    writer.writeUint(scene->mNumMaterials);
+    for (unsigned int i = 0; i < scene->mNumMaterials; i++) {
+        writeMaterial(writer, scene->mMaterials[i]);
+    }
+
+    writer.writeUint(scene->mNumMeshes);
+    for (unsigned int i = 0; i < scene->mNumMeshes; i++) {
+        writeMesh(writer, scene->mMeshes[i]);
+    }
+
+    writer.writeUint(scene->mNumAnimations);
+    for (unsigned int i = 0; i < scene->mNumAnimations; i++) {
+        writeAnimation(writer, scene->mAnimations[i]);
+    }
+
+    writer.writeUint(scene->mNumLights);
+    for (unsigned int i = 0; i < scene->mNumLights; i++) {
+        writeLight(writer, scene->mLights[i]);
+    }
+
+    writer.writeUint(scene->mNumCameras);
+    for (unsigned int i = 0; i < scene->mNumCameras; i++) {
+        writeCamera(writer, scene->mCameras[i]);
+    }
+
+    writeNode(writer, scene->mRootNode);
+
+    if (!createParentDirectories(cacheFilePath)) {
+        return false;
+    }
+
+    // cache is written to a temporary file and renamed in place, so readers never see a partial file
+    // even if the player crashes or two import workers write the same model
+    static std::atomic<unsigned int> tempFileCounter(0);
+    char tempSuffix[32];
+    snprintf(tempSuffix, sizeof(tempSuffix), ".%u.tmp", tempFileCounter++);
+    std::string tempFilePath = cacheFilePath + std::string(tempSuffix);
+
+    FILE *fp = fopen(tempFilePath.c_str(), "wb");
+    if (fp == NULL) {
+        loggerWarning("Could not open model cache for writing. cacheFile:'%s'", tempFilePath.c_str());
+        return false;
+    }
+
+    size_t writtenBytes = fwrite(writer.data.data(), 1, writer.data.size(), fp);
+    bool closed = fclose(fp) == 0;
+
+    if (writtenBytes != writer.data.size() || !closed) {
+        loggerWarning("Could not write model cache. cacheFile:'%s', writtenBytes:%u, size:%u", tempFilePath.c_str(), writtenBytes, writer.data.size());
+        remove(tempFilePath.c_str());
+        return false;
+    }
+
+#ifdef _WIN32
+    // rename does not replace existing files on Windows
+    remove(cacheFilePath.c_str());
+#endif
+    if (rename(tempFilePath.c_str(), cacheFilePath.c_str()) != 0) {
+        loggerWarning("Could not move model cache in place. cacheFile:'%s'", cacheFilePath.c_str());
+        remove(tempFilePath.c_str());
+        return false;
+    }
+
+    loggerDebug("Wrote model cache. cacheFile:'%s', size:%u", cacheFilePath.c_str(), writer.data.size());
+
+    return true;
+}
@@ -0,0 +1,21 @@
+#ifndef ENGINE_GRAPHICS_MODEL_MODELCACHEASSIMP_H_
+#define ENGINE_GRAPHICS_MODEL_MODELCACHEASSIMP_H_
+
+#include <string>
+#include <vector>
+
+struct aiScene;
+
+/**
+ * Binary cache of post-processed assimp scenes.
+ * Cache files are keyed by the source file content hash and the import post-processing flags.
+ * Content hashes of the other files read by the importer (e.g. .mtl) are stored in the cache and verified on read.
+ */
+class ModelCacheAssimp {
+public:
+    static std::string getCacheFilePath(const std::string& sourceFilePath, unsigned int importFlags);
+    static aiScene* read(const std::string& cacheFilePath);
+    static bool write(const std::string& cacheFilePath, const aiScene* scene, const std::string& sourceFilePath, const std::vector<std::string>& dependencies);
+};
+
+#endif /*ENGINE_GRAPHICS_MODEL_MODELCACHEASSIMP_H_*/
@@ -0,0 +1,212 @@
+#include "ModelLoader.h"
+
+#include "Model.h"
+#include "Settings.h"
+#include "time/SystemTime.h"
+#include "logger/logger.h"
+
+ModelLoader& ModelLoader::getInstance() {
+    static ModelLoader modelLoader;
+    return modelLoader;
+}
+
+ModelLoader::ModelLoader() {
+    stopping = false;
+}
+
+ModelLoader::~ModelLoader() {
+    clear();
+}
+
+void ModelLoader::startWorkers() {
+    if (!workers.empty()) {
+        return;
+    }
+
+    unsigned int workerCount = Settings::demo.graphics.model.importWorkers;
+    if (workerCount == 0) {
+        workerCount = 1;
+    }
+
+    loggerDebug("Starting model import workers. workers:%u", workerCount);
+
+    stopping = false;
+    for (unsigned int i = 0; i < workerCount; i++) {
+        workers.push_back(std::thread(&ModelLoader::work, this));
+    }
+}
+
+void ModelLoader::work() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        ModelLoad *modelLoad = NULL;
+        loadQueued.wait(lock, [this, &modelLoad]() {
+            if (stopping) {
+                return true;
+            }
+
+            for (ModelLoad &load : loads) {
+                if (load.state == LoadState::QUEUED) {
+                    modelLoad = &load;
+                    return true;
+                }
+            }
+
+            return false;
+        });
+
+        if (stopping) {
+            return;
+        }
+
+        // the load stays in the list while importing, cancel waits for the import to finish
+        modelLoad->state = LoadState::IMPORTING;
+        Model *model = modelLoad->model;
+
+        lock.unlock();
+        bool imported = model->importData();
+        lock.lock();
+
+        modelLoad->state = imported ? LoadState::IMPORTED : LoadState::FAILED;
+        loadImported.notify_all();
+    }
+}
+
+bool ModelLoader::load(Model *model) {
+    if (model == NULL) {
+        loggerError("No model given, can't load");
+        return false;
+    }
+
+    if (isLoading(model)) {
+        return true;
+    }
+
+    if (model->isLoaded()) {
+        if (!model->modified()) {
+            return true;
+        }
+
+        // reloading modified files is done synchronously to avoid drawing half uploaded model
+        if (!model->load()) {
+            model->setError(true);
+            return false;
+        }
+
+        return true;
+    }
+
+    model->setError(false);
+
+    startWorkers();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ModelLoad modelLoad;
+        modelLoad.model = model;
+        modelLoad.state = LoadState::QUEUED;
+        loads.push_back(modelLoad);
+    }
+    loadQueued.notify_one();
+
+    loggerDebug("Model import queued. file:'%s'", model->getFilePath().c_str());
+
+    return true;
+}
+
+void ModelLoader::process() {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (loads.empty()) {
+        return;
+    }
+
+    PROFILER_BLOCK("ModelLoader::process");
+
+    uint64_t deadline = SystemTime::getTimeInMillis() + static_cast<uint64_t>(Settings::demo.graphics.model.uploadTimeBudget);
+
+    auto it = loads.begin();
+    while (it != loads.end()) {
+        ModelLoad &modelLoad = *it;
+        if (modelLoad.state == LoadState::QUEUED || modelLoad.state == LoadState::IMPORTING) {
+            ++it;
+            continue;
+        }
+
+        if (modelLoad.state == LoadState::FAILED) {
+            loggerError("Model import failed. file:'%s'", modelLoad.model->getFilePath().c_str());
+            modelLoad.model->setError(true);
+            it = loads.erase(it);
+            continue;
+        }
+
+        if (SystemTime::getTimeInMillis() >= deadline) {
+            break;
+        }
+
+        // workers don't touch imported loads, so upload is done without holding the lock
+        modelLoad.state = LoadState::UPLOADING;
+        lock.unlock();
+        bool uploaded = modelLoad.model->uploadData(deadline) || modelLoad.model->getError();
+        lock.lock();
+
+        if (uploaded) {
+            it = loads.erase(it);
+        } else {
+            // deadline hit, continue on next frame
+            ++it;
+        }
+    }
+}
+
+bool ModelLoader::isLoading() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return !loads.empty();
+}
+
+bool ModelLoader::isLoading(Model *model) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (ModelLoad &modelLoad : loads) {
+        if (modelLoad.model == model) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ModelLoader::cancel(Model *model) {
+    std::unique_lock<std::mutex> lock(mutex);
+    auto it = loads.begin();
+    while (it != loads.end()) {
+        if (it->model != model) {
+            ++it;
+            continue;
+        }
+
+        ModelLoad &modelLoad = *it;
+        loadImported.wait(lock, [&modelLoad]() {
+            return modelLoad.state != LoadState::IMPORTING;
+        });
+
+        loggerDebug("Model load cancelled. file:'%s'", model->getFilePath().c_str());
+        it = loads.erase(it);
+    }
+}
+
+void ModelLoader::clear() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    loadQueued.notify_all();
+
+    // workers finish the import they are running
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    loads.clear();
+    stopping = false;
+}
@@ -0,0 +1,56 @@
+#ifndef ENGINE_GRAPHICS_MODEL_MODELLOADER_H_
+#define ENGINE_GRAPHICS_MODEL_MODELLOADER_H_
+
+#include <list>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+class Model;
+
+/**
+ * Loads models asynchronously. Model data is imported by a bounded set of worker threads
+ * and uploaded to GPU in the main thread within a per-frame time budget.
+ */
+class ModelLoader {
+public:
+    static ModelLoader& getInstance();
+    ModelLoader();
+    ~ModelLoader();
+    bool load(Model *model);
+    void process();
+    bool isLoading();
+    bool isLoading(Model *model);
+    /**
+     * Drop pending load of the model. Waits if the model is being imported, must be called before the model is freed.
+     */
+    void cancel(Model *model);
+    void clear();
+private:
+    enum class LoadState {
+        QUEUED,
+        IMPORTING,
+        IMPORTED,
+        FAILED,
+        UPLOADING
+    };
+
+    struct ModelLoad {
+        Model *model;
+        LoadState state;
+    };
+
+    void startWorkers();
+    void work();
+
+    // loads are added and removed only in the main thread, workers change the state under the mutex
+    std::list<ModelLoad> loads;
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable loadQueued;
+    std::condition_variable loadImported;
+    bool stopping;
+};
+
+#endif /*ENGINE_GRAPHICS_MODEL_MODELLOADER_H_*/
@@ -29,9 +29,9 @@ TexturedQuad* TexturedQuad::newInstance(Fbo* fbo, Texture *fboTexture) {
         return NULL;
     }
 
-    //NB. FBO should be size of full window dimensions...
-    double width = static_cast<double>(Settings::demo.graphics.canvasWidth) * (fbo->getWidth()/Settings::window.screenAreaWidth);
-    double height = static_cast<double>(Settings::demo.graphics.canvasHeight) * (fbo->getHeight()/Settings::window.screenAreaHeight);
+    //NB. FBO is drawn in full window dimensions, FBO resolution does not affect the drawn size
+    double width = static_cast<double>(Settings::demo.graphics.canvasWidth);
+    double height = static_cast<double>(Settings::demo.graphics.canvasHeight);
 
     TexturedQuad* texturedQuad = new TexturedQuad(width, height);
     texturedQuad->setParent(static_cast<void*>(fbo));
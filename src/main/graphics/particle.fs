@@ -0,0 +1,20 @@
+#version 330 core
+
+in vec4 particleColor;
+
+out vec4 fragColor;
+uniform sampler2D texture0;
+uniform bool enableTexture = false;
+
+void main(void)
+{
+    fragColor = particleColor;
+
+    if (enableTexture) {
+        fragColor *= texture(texture0, gl_PointCoord);
+    } else {
+        // soft round sprite
+        float distance = length(gl_PointCoord * 2.0 - 1.0);
+        fragColor.a *= 1.0 - smoothstep(0.5, 1.0, distance);
+    }
+}
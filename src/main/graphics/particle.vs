@@ -0,0 +1,34 @@
+#version 330 core
+
+layout(location = 0) in vec4 particlePosition; // xyz position, w age
+layout(location = 1) in vec4 particleVelocity; // xyz velocity, w life time
+
+out vec4 particleColor;
+uniform mat4 mvp;
+uniform mat4 projection;
+uniform vec4 startColor;
+uniform vec4 endColor;
+uniform float startSize;
+uniform float endSize;
+uniform float viewportHeight;
+
+void main(void)
+{
+    float age = particlePosition.w;
+    float life = particleVelocity.w;
+    if (age >= life) {
+        // dead particle, move outside of the clip volume
+        gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+        gl_PointSize = 1.0;
+        particleColor = vec4(0.0);
+        return;
+    }
+
+    float t = age / life;
+    gl_Position = mvp * vec4(particlePosition.xyz, 1.0);
+    particleColor = mix(startColor, endColor, t);
+
+    // size is in world units, convert to pixels with the projection scale
+    float size = mix(startSize, endSize, t);
+    gl_PointSize = size * projection[1][1] * viewportHeight * 0.5 / max(gl_Position.w, 0.0001);
+}
@@ -0,0 +1,57 @@
+#version 330 core
+
+layout(location = 0) in vec4 particlePosition; // xyz position, w age
+layout(location = 1) in vec4 particleVelocity; // xyz velocity, w life time
+
+out vec4 feedbackPosition;
+out vec4 feedbackVelocity;
+
+uniform float deltaTime;
+uniform float seed;
+uniform int particleCount;
+uniform int emitBegin;
+uniform int emitCount;
+uniform vec3 emitterPosition;
+uniform vec3 emitterPositionRandomness;
+uniform vec3 emitterVelocity;
+uniform vec3 emitterVelocityRandomness;
+uniform float lifeTime;
+uniform float lifeTimeRandomness;
+uniform vec3 gravity;
+uniform float drag;
+
+float random(float n)
+{
+    return fract(sin(n * 12.9898 + seed * 78.233) * 43758.5453);
+}
+
+vec3 randomVec3(float n)
+{
+    return vec3(random(n), random(n + 1.7), random(n + 3.1)) * 2.0 - 1.0;
+}
+
+void main(void)
+{
+    vec3 position = particlePosition.xyz;
+    float age = particlePosition.w;
+    vec3 velocity = particleVelocity.xyz;
+    float life = particleVelocity.w;
+
+    // particles in the emit window of the ring are respawned, emitBegin is always less than particleCount
+    int emitOffset = (gl_VertexID - emitBegin + particleCount) % particleCount;
+    if (emitOffset < emitCount) {
+        float n = float(gl_VertexID);
+        position = emitterPosition + randomVec3(n) * emitterPositionRandomness;
+        velocity = emitterVelocity + randomVec3(n + 5.3) * emitterVelocityRandomness;
+        age = 0.0;
+        life = max(lifeTime + (random(n + 7.9) * 2.0 - 1.0) * lifeTimeRandomness, 0.0);
+    } else if (age < life) {
+        velocity += gravity * deltaTime;
+        velocity *= max(1.0 - drag * deltaTime, 0.0);
+        position += velocity * deltaTime;
+        age += deltaTime;
+    }
+
+    feedbackPosition = vec4(position, age);
+    feedbackVelocity = vec4(velocity, life);
+}
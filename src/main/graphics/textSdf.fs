@@ -0,0 +1,39 @@
+#version 330 core
+
+in vec2 texCoord;
+out vec4 fragColor;
+
+uniform sampler2D texture0; // signed distance field glyph atlas
+uniform vec4 color = vec4(1.0,1.0,1.0,1.0);
+uniform float sdfOutlineWidth = 0.0;
+uniform vec4 sdfOutlineColor = vec4(0.0,0.0,0.0,1.0);
+uniform float sdfGlowWidth = 0.0;
+uniform vec4 sdfGlowColor = vec4(1.0,1.0,1.0,1.0);
+
+void main(void)
+{
+    // 0.5 is the glyph edge, values grow towards the inside of the glyph
+    float distance = texture(texture0, texCoord).r;
+    float smoothing = max(fwidth(distance) * 0.5, 0.0001);
+
+    float fill = smoothstep(0.5 - smoothing, 0.5 + smoothing, distance);
+    vec4 glyph = vec4(color.rgb, color.a * fill);
+
+    float outerEdge = 0.5;
+    if (sdfOutlineWidth > 0.0) {
+        outerEdge = 0.5 - sdfOutlineWidth;
+        float outline = smoothstep(outerEdge - smoothing, outerEdge + smoothing, distance);
+        glyph = vec4(mix(sdfOutlineColor.rgb, color.rgb, fill), mix(sdfOutlineColor.a, color.a, fill) * outline);
+    }
+
+    vec4 glow = vec4(0.0);
+    if (sdfGlowWidth > 0.0) {
+        glow = vec4(sdfGlowColor.rgb, sdfGlowColor.a * smoothstep(outerEdge - sdfGlowWidth, outerEdge, distance));
+    }
+
+    // glyph over glow
+    float alpha = glyph.a + glow.a * (1.0 - glyph.a);
+    vec3 rgb = (glyph.rgb * glyph.a + glow.rgb * glow.a * (1.0 - glyph.a)) / max(alpha, 0.0001);
+
+    fragColor = clamp(vec4(rgb, alpha), vec4(0.0,0.0,0.0,0.0), vec4(1.0,1.0,1.0,1.0));
+}
@@ -0,0 +1,13 @@
+#version 330 core
+
+layout(location = 0) in vec3 vertexPosition;
+layout(location = 1) in vec2 vertexTexCoord;
+
+out vec2 texCoord;
+uniform mat4 mvp;
+
+void main(void)
+{
+    gl_Position = mvp * vec4(vertexPosition, 1.0);
+    texCoord = vertexTexCoord;
+}
@@ -0,0 +1,135 @@
+#include "VideoDecodeScheduler.h"
+
+#include "VideoFile.h"
+#include "Settings.h"
+#include "logger/logger.h"
+
+#include <algorithm>
+#include <thread>
+
+VideoDecodeScheduler& VideoDecodeScheduler::getInstance() {
+    static VideoDecodeScheduler videoDecodeScheduler;
+    return videoDecodeScheduler;
+}
+
+VideoDecodeScheduler::VideoDecodeScheduler() {
+    frame = 0;
+}
+
+unsigned int VideoDecodeScheduler::getWorkerCount() {
+    unsigned int workers = Settings::demo.graphics.video.decodeWorkers;
+    if (workers == 0) {
+        // leave one core for the main thread
+        unsigned int cores = std::thread::hardware_concurrency();
+        workers = cores > 1 ? cores - 1 : 1;
+    }
+
+    return workers;
+}
+
+VideoDecodeScheduler::VideoDecode* VideoDecodeScheduler::find(VideoFile *video) {
+    for (VideoDecode &decode : decodes) {
+        if (decode.video == video) {
+            return &decode;
+        }
+    }
+
+    return NULL;
+}
+
+void VideoDecodeScheduler::suspend(VideoDecode &decode) {
+    if (decode.active) {
+        loggerDebug("Suspending video decoding. file:'%s'", decode.video->getFilePath().c_str());
+        decode.video->suspend();
+        decode.active = false;
+    }
+}
+
+unsigned int VideoDecodeScheduler::getActiveCount() {
+    unsigned int count = 0;
+    for (const VideoDecode &decode : decodes) {
+        if (decode.active) {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+bool VideoDecodeScheduler::request(VideoFile *video, double deadline) {
+    VideoDecode *decode = find(video);
+    if (decode == NULL) {
+        VideoDecode newDecode;
+        newDecode.video = video;
+        newDecode.active = false;
+        decodes.push_back(newDecode);
+        decode = &decodes.back();
+    }
+
+    decode->deadline = deadline;
+    decode->requestFrame = frame;
+
+    // free workers are granted right away, process() only pre-empts by the earliest deadline
+    if (!decode->active && getActiveCount() < getWorkerCount()) {
+        decode->active = true;
+    }
+
+    return decode->active;
+}
+
+void VideoDecodeScheduler::release(VideoFile *video) {
+    decodes.erase(std::remove_if(decodes.begin(), decodes.end(), [video](const VideoDecode &decode) {
+        return decode.video == video;
+    }), decodes.end());
+}
+
+void VideoDecodeScheduler::process(bool paused) {
+    // paused demo is drawn only when needed, so videos must not be suspended for not being drawn
+    if (decodes.empty() || paused) {
+        return;
+    }
+
+    PROFILER_BLOCK("VideoDecodeScheduler::process");
+
+    // videos drawn in the previous frame compete for the workers, the earliest deadlines win
+    std::vector<VideoDecode*> requested;
+    for (VideoDecode &decode : decodes) {
+        if (decode.requestFrame < frame) {
+            suspend(decode);
+        } else {
+            requested.push_back(&decode);
+        }
+    }
+
+    // on equal deadlines running decoders are kept, so that decoders are not restarted back and forth
+    std::stable_sort(requested.begin(), requested.end(), [](const VideoDecode *a, const VideoDecode *b) {
+        if (a->deadline != b->deadline) {
+            return a->deadline < b->deadline;
+        }
+
+        return a->active && !b->active;
+    });
+
+    unsigned int workerCount = getWorkerCount();
+    for (size_t i = 0; i < requested.size(); i++) {
+        VideoDecode *decode = requested[i];
+        if (i < workerCount) {
+            decode->active = true;
+            continue;
+        }
+
+        if (decode->active) {
+            loggerTrace("Video decode worker given to a more urgent video. file:'%s', deadline:%.3f", decode->video->getFilePath().c_str(), decode->deadline);
+            suspend(*decode);
+        } else {
+            loggerTrace("Video waiting for decode worker. file:'%s', deadline:%.3f", decode->video->getFilePath().c_str(), decode->deadline);
+        }
+    }
+
+    frame++;
+}
+
+void VideoDecodeScheduler::clear() {
+    decodes.clear();
+    frame = 0;
+}
@@ -0,0 +1,40 @@
+#ifndef ENGINE_GRAPHICS_VIDEO_VIDEODECODESCHEDULER_H_
+#define ENGINE_GRAPHICS_VIDEO_VIDEODECODESCHEDULER_H_
+
+#include <vector>
+#include <cstdint>
+
+class VideoFile;
+
+/**
+ * Limits the amount of videos decoding at the same time, each video still decodes in its own theoraplay thread.
+ * Videos request a worker when they are drawn and get it immediately if one is free. Once per frame
+ * the workers are re-ranked, so that videos with later next frame deadlines are pre-empted by earlier ones
+ * and videos not drawn anymore are suspended. Nothing is suspended while the timer is paused.
+ */
+class VideoDecodeScheduler {
+public:
+    static VideoDecodeScheduler& getInstance();
+    VideoDecodeScheduler();
+    bool request(VideoFile *video, double deadline);
+    void release(VideoFile *video);
+    void process(bool paused);
+    void clear();
+    unsigned int getWorkerCount();
+private:
+    struct VideoDecode {
+        VideoFile *video;
+        double deadline;
+        uint64_t requestFrame;
+        bool active;
+    };
+
+    VideoDecode* find(VideoFile *video);
+    unsigned int getActiveCount();
+    void suspend(VideoDecode &decode);
+
+    std::vector<VideoDecode> decodes;
+    uint64_t frame;
+};
+
+#endif /*ENGINE_GRAPHICS_VIDEO_VIDEODECODESCHEDULER_H_*/
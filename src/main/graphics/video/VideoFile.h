@@ -14,10 +14,13 @@ public:
     virtual void play() = 0;
     virtual void setStartTime(float startTime) = 0;
     virtual void setLength(float length) = 0;
+    virtual void setFrameCacheSize(unsigned int frameCacheSize) = 0;
     virtual void setTime(float time) = 0;
     virtual void stop() = 0;
     virtual void pause() = 0;
     virtual void draw() = 0;
+    virtual void suspend() = 0;
+    virtual unsigned int getLateFrameCount() = 0;
 protected:
     explicit VideoFile(std::string filePath);
 };
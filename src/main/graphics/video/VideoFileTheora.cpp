@@ -1,7 +1,12 @@
 #include "VideoFileTheora.h"
+#include "VideoFrameConverter.h"
+#include "VideoKeyframeIndex.h"
+#include "VideoFrameCache.h"
+#include "VideoDecodeScheduler.h"
 
 #include <stdio.h>
 #include <string.h>
+#include <stdlib.h>
 #include <unistd.h>
 #include <assert.h>
 #include <math.h>
@@ -12,6 +17,7 @@
 #include "logger/logger.h"
 #include "graphics/Graphics.h"
 #include "EnginePlayer.h"
+#include "Settings.h"
 
 #include <algorithm>
 #include "GL/gl3w.h"
@@ -34,6 +40,22 @@ struct video_theora_t {
     THEORAPLAY_Decoder *decoder;
     struct video_theora_frame_t *currentFrame;
     SDL_AudioSpec audioSpec;
+    // frames decoded ahead of the playback position, oldest first
+    const THEORAPLAY_VideoFrame **frameRing;
+    unsigned int frameRingSize;
+    unsigned int frameRingStart;
+    unsigned int frameRingCount;
+    // time of the last frame taken from the decoder
+    double decodePosition;
+    // decoder restarted from a keyframe page counts frames from zero, its timestamps are offset by this
+    double decodeTimeOffset;
+    // true, if decodeTimeOffset is exact, only then decoded frames can be cached by their frame number
+    bool decodeTimeVerified;
+    // true, if the last frame load changed framePixels
+    bool frameUpdated;
+    // YUV planes of the frame to show, either from currentFrame or from the frame cache
+    const unsigned char *framePixels;
+    double videoFps;
 };
 
 //static Uint32 baseticks = 0;
@@ -126,8 +148,77 @@ static void queue_audio(const THEORAPLAY_AudioPacket *audio)
 #define CODEC_NULL 0
 #define CODEC_THEORA 1
 
+// jumping forward more than this is done by seeking to a keyframe instead of decoding through
+#define SEEK_FORWARD_THRESHOLD 2.0
 
-#define MAXFRAMES 0xFFFF
+// frame timestamps are rounded to milliseconds, tolerance in frames when mapping times to frame numbers
+#define FRAME_NUMBER_TOLERANCE 0.1
+
+/**
+ * Number of the first frame at or after the given time. Used for both frame cache lookups and stores.
+ */
+static unsigned int getFrameNumber(double time, double fps)
+{
+    double frameNumber = ceil(time*fps - FRAME_NUMBER_TOLERANCE);
+    return frameNumber > 0.0 ? static_cast<unsigned int>(frameNumber) : 0;
+}
+
+/**
+ * Decoder input that serves the stream headers and then continues from a keyframe page
+ */
+struct video_theora_seek_io_t {
+    FILE *file;
+    long position;
+    long headerEnd;
+    long seekOffset;
+};
+
+static long seekIoRead(THEORAPLAY_Io *io, void *buffer, long bufferLength)
+{
+    struct video_theora_seek_io_t *seekIo = (struct video_theora_seek_io_t*)io->userdata;
+
+    if (seekIo->position < seekIo->headerEnd && seekIo->position + bufferLength > seekIo->headerEnd)
+    {
+        bufferLength = seekIo->headerEnd - seekIo->position;
+    }
+
+    long bytesRead = (long)fread(buffer, 1, (size_t)bufferLength, seekIo->file);
+    if (bytesRead <= 0)
+    {
+        return ferror(seekIo->file) ? -1 : 0;
+    }
+
+    seekIo->position += bytesRead;
+    if (seekIo->position == seekIo->headerEnd)
+    {
+        fseek(seekIo->file, seekIo->seekOffset, SEEK_SET);
+        seekIo->position = seekIo->seekOffset;
+    }
+
+    return bytesRead;
+}
+
+static void seekIoClose(THEORAPLAY_Io *io)
+{
+    struct video_theora_seek_io_t *seekIo = (struct video_theora_seek_io_t*)io->userdata;
+    fclose(seekIo->file);
+    free(seekIo);
+    free(io);
+}
+
+/**
+ * Timeline time of a frame from the current decoder
+ */
+static double getFrameTime(const struct video_theora_t *codec, const THEORAPLAY_VideoFrame *videoFrame)
+{
+    return videoFrame->playms/1000.0 + codec->decodeTimeOffset;
+}
+
+static size_t getFrameSize(const THEORAPLAY_VideoFrame *videoFrame) {
+    // IYUV: full resolution Y plane and half resolution U and V planes
+    return static_cast<size_t>(videoFrame->width) * videoFrame->height
+        + 2 * static_cast<size_t>(videoFrame->width / 2) * (videoFrame->height / 2);
+}
 
 static bool timerIsAddTimeGracePeriod() {
     return false; //TODO: is timer grace period needed?
@@ -155,16 +246,25 @@ VideoFile* VideoFile::newInstance(std::string filePath) {
 
 VideoFileTheora::VideoFileTheora(std::string filePath) : VideoFile(filePath) {
     codec = NULL;
+    frameConverter = NULL;
+    keyframeIndex = new VideoKeyframeIndex();
+    frameCache = new VideoFrameCache();
+    frameCache->setMemoryLimit(static_cast<size_t>(Settings::demo.graphics.video.frameCacheSize) * 1024 * 1024);
 	freeVideoTheora();
 }
 
 VideoFileTheora::~VideoFileTheora() {
+    VideoDecodeScheduler::getInstance().release(this);
+
     if (texture != NULL) {
         loggerDebug("Deconstructing video and texture. file:'%s', texture:0x%p", getFilePath().c_str(), texture);
         delete texture;
     }
 
     freeVideoTheora();
+
+    delete keyframeIndex;
+    delete frameCache;
 }
 
 bool VideoFileTheora::isSupported() {
@@ -209,126 +309,122 @@ bool VideoFileTheora::load(bool rollback) {
     codec->currentFrame = NULL;
     codec->decoder = NULL;
 
+    codec->frameRingSize = std::max(1u, Settings::demo.graphics.video.decodeAheadFrames);
+    codec->frameRing = (const THEORAPLAY_VideoFrame**)malloc(sizeof(const THEORAPLAY_VideoFrame*) * codec->frameRingSize);
+    if (codec->frameRing == NULL) {
+        loggerFatal("Could not allocate memory for video frames. file:'%s'", getFilePath().c_str());
+        return false;
+    }
+
+    keyframeIndex->build(getData(), length());
+    frameCache->clear();
+
     if (!loadVideoTheora())
     {
         loggerError("Could not load video '%s'!", getFilePath().c_str());
         return false;
     }
 
+    // decoding continues when video is drawn and gets a decode worker
+    suspend();
+
     return true;
 }
 
-bool VideoFileTheora::loadVideoTheoraFrame(double time)
+bool VideoFileTheora::loadVideoTheoraFrame(double time, bool wait)
 {
+    codec->frameUpdated = false;
+
     if (time > 0.0 && timerIsAddTimeGracePeriod())
     {
         return true;
     }
 
-    if (codec->currentFrame != NULL && codec->currentFrame->video->playms/1000.0 > time+0.5)
+    if (codec->videoFps > 0.0 && frameCache->getMemoryLimit() > 0)
     {
-        THEORAPLAY_stopDecode(codec->decoder);
-        codec->decoder = NULL;
+        unsigned int frameNumber = getFrameNumber(time, codec->videoFps);
+        if (frameCache->get(frameNumber, cachedFramePixels))
+        {
+            codec->framePixels = cachedFramePixels.data();
+            codec->frameUpdated = true;
+
+            return true;
+        }
     }
 
-    if (codec->decoder == NULL)
+    if (codec->decoder != NULL)
     {
-        if (codec->decoder)
+        bool seekBackward = codec->decodePosition > time+0.5;
+        bool seekForward = false;
+        if (time > codec->decodePosition + SEEK_FORWARD_THRESHOLD)
         {
-            THEORAPLAY_stopDecode(codec->decoder);
+            // seek only if there's a keyframe to skip to
+            double keyframeTime = 0.0;
+            keyframeIndex->findSeekOffset(time, keyframeTime);
+            seekForward = keyframeTime > codec->decodePosition;
         }
 
-        loggerDebug("Start decode again '%s'",getFilePath().c_str());
-        codec->decoder = THEORAPLAY_startDecodeFile(getFilePath().c_str(), MAXFRAMES, THEORAPLAY_VIDFMT_RGB);
-        if (!codec->decoder)
+        if (seekBackward || seekForward)
         {
-            loggerError("Could not decode file! '%s'");
-            return false;
+            stopDecode();
         }
-
-        //freeVideoFramesTheora(video);
-
-        //THEORAPLAY_setDecodeTime(codec->decoder, 0.0);
     }
 
-    //unsigned int frame = time*fps;
-    THEORAPLAY_setDecodeTime(codec->decoder, time);
-
-    //loadVideoTheoraFrame(0);
+    if (codec->decoder == NULL)
+    {
+        if (!startDecode(time))
+        {
+            return false;
+        }
+    }
 
-    //const unsigned int MAX_PLAY_TIME_MS = 30000;
-    const unsigned int MAX_DECODE_WAIT_MS = 1000;
+    THEORAPLAY_setDecodeTime(codec->decoder, time - codec->decodeTimeOffset);
 
-    //loggerDebug("Getting frame %d (%.2f) '%s'!", frame, frame/fps, getFilePath().c_str());
+    bool late = false;
+    const THEORAPLAY_VideoFrame *videoFrame = acquireVideoFrame(time, !wait, late);
 
-    //loggerDebug("=> Getting frame %d/%d!", frame, codec->framesSize);
-    unsigned int loadStart = SystemTime::getTimeInMillis();
-    const THEORAPLAY_VideoFrame *video_frame = NULL;
-    
-    int pauseWait = 0;
-    while(1)
+    if (wait)
     {
-        video_frame = THEORAPLAY_getVideo(codec->decoder);
+        const unsigned int MAX_DECODE_WAIT_MS = 1000;
+        unsigned int loadStart = SystemTime::getTimeInMillis();
+        bool slownessLogged = false;
 
-        unsigned int wait_sum = SystemTime::getTimeInMillis()-loadStart;
-        if (wait_sum > MAX_DECODE_WAIT_MS && pauseWait == 0)
+        while (videoFrame == NULL && THEORAPLAY_isDecoding(codec->decoder))
         {
-            pauseWait = 1;
-            loggerInfo("Tried to decode video over %d ms. Slowness... video:%s", wait_sum, getFilePath().c_str());
-
-            Timer& timer = EnginePlayer::getInstance().getTimer();
-            if (!timer.isPause())
+            unsigned int waitSum = SystemTime::getTimeInMillis()-loadStart;
+            if (waitSum > MAX_DECODE_WAIT_MS && !slownessLogged)
             {
-                pauseWait = 2;
-                timer.setTimeInSeconds(timer.getTimeInSeconds() -(wait_sum/1000.0));
-                timer.pause(true);
+                slownessLogged = true;
+                loggerInfo("Tried to decode video over %d ms. Slowness... video:%s", waitSum, getFilePath().c_str());
             }
-        }
 
-        if (video_frame != NULL)
-        {
-            if (video_frame->playms/1000.0 >= time)
-            {
-                //loggerDebug("Using frame! time:%.3f, frameTime:%.3f",time,video_frame->playms/1000.0);
-                break;
-            }
-            else
-            {
-                //loggerDebug("Skipping frame! time:%.3f, frameTime:%.3f",time,video_frame->playms/1000.0);
-                THEORAPLAY_freeVideo(video_frame);    //discard frame => will not be used
-            }
+            SDL_Delay(1);
+            videoFrame = acquireVideoFrame(time, false, late);
         }
-
-        if (!THEORAPLAY_isDecoding(codec->decoder))
-        {
-            return true;
-        }        
     }
 
-    if (pauseWait == 2)
+    if (videoFrame == NULL)
     {
-        Timer& timer = EnginePlayer::getInstance().getTimer();
-        if (timer.isPause())
+        if (THEORAPLAY_isDecoding(codec->decoder))
         {
-            timer.pause(false);
+            lateFrameCount++;
+            loggerTrace("Video frame not decoded in time, using previous frame. video:'%s', time:%.3f, lateFrames:%u", getFilePath().c_str(), time, lateFrameCount);
         }
+
+        return true;
     }
 
-    assert (video_frame != NULL);
+    if (late)
+    {
+        lateFrameCount++;
+        loggerTrace("Video frame not decoded in time, using newest frame. video:'%s', time:%.3f, frameTime:%.3f, lateFrames:%u", getFilePath().c_str(), time, getFrameTime(codec, videoFrame), lateFrameCount);
+    }
 
     struct video_theora_frame_t *frame = (struct video_theora_frame_t*)malloc(sizeof(struct video_theora_frame_t));
     assert(frame);
     frame->audio = NULL;
-    frame->video = video_frame;
+    frame->video = videoFrame;
     frame->fileCursor = frame->video->filecursor;
-    //add_to_array(struct video_theora_frame_t, codec->frames, frame);
-
-
-    /*if (frame->playms >= MAX_PLAY_TIME_MS)
-    {
-        loggerWarning("Maximum video length is %.2f seconds. Video truncated to maximum length. video:%s", MAX_PLAY_TIME_MS/1000.0f, getFilePath().c_str());
-        return 0;
-    }*/
 
     while ((frame->audio = THEORAPLAY_getAudio(codec->decoder)) != NULL)
     {
@@ -347,6 +443,17 @@ bool VideoFileTheora::loadVideoTheoraFrame(double time)
         freeFrameTheora(&codec->currentFrame);
     }
     codec->currentFrame = frame;
+    codec->framePixels = frame->video->pixels;
+    codec->videoFps = frame->video->fps;
+    codec->frameUpdated = true;
+
+    // offset of a decoder restarted from a keyframe is estimated from the page packet counts
+    // and its frames before the keyframe are decoded without reference frames, don't cache those
+    if (frameCache->getMemoryLimit() > 0 && codec->videoFps > 0.0 && codec->decodeTimeVerified)
+    {
+        unsigned int frameNumber = getFrameNumber(getFrameTime(codec, frame->video), codec->videoFps);
+        frameCache->put(frameNumber, frame->video->pixels, getFrameSize(frame->video));
+    }
 
     assert(codec->currentFrame->video != NULL);
     //loggerTrace("Loaded frame '%s'! decodedTime:%.3f, time:%.3f", getFilePath().c_str(), frame->video->playms/1000.0, time);
@@ -354,9 +461,160 @@ bool VideoFileTheora::loadVideoTheoraFrame(double time)
     return true;
 }
 
+const THEORAPLAY_VideoFrame* VideoFileTheora::acquireVideoFrame(double time, bool allowLate, bool &late)
+{
+    late = false;
+    const THEORAPLAY_VideoFrame *newestFrame = NULL;
+
+    // never blocks: only frames that the decoder thread has already finished are looked at
+    while (1)
+    {
+        unsigned int added = fillFrameRing();
+
+        while (codec->frameRingCount > 0 && getFrameTime(codec, codec->frameRing[codec->frameRingStart]) < time)
+        {
+            if (newestFrame != NULL)
+            {
+                THEORAPLAY_freeVideo(newestFrame);    //discard frame => will not be used
+            }
+
+            newestFrame = popFrameRing();
+        }
+
+        if (codec->frameRingCount > 0)
+        {
+            if (newestFrame != NULL)
+            {
+                THEORAPLAY_freeVideo(newestFrame);
+            }
+
+            return popFrameRing();
+        }
+
+        if (added == 0)
+        {
+            break;
+        }
+    }
+
+    if (newestFrame != NULL && !allowLate)
+    {
+        THEORAPLAY_freeVideo(newestFrame);
+        newestFrame = NULL;
+    }
+
+    late = newestFrame != NULL;
+    return newestFrame;
+}
+
+unsigned int VideoFileTheora::fillFrameRing()
+{
+    unsigned int added = 0;
+
+    while (codec->frameRingCount < codec->frameRingSize)
+    {
+        const THEORAPLAY_VideoFrame *videoFrame = THEORAPLAY_getVideo(codec->decoder);
+        if (videoFrame == NULL)
+        {
+            break;
+        }
+
+        codec->frameRing[(codec->frameRingStart + codec->frameRingCount) % codec->frameRingSize] = videoFrame;
+        codec->frameRingCount++;
+        added++;
+    }
+
+    return added;
+}
+
+const THEORAPLAY_VideoFrame* VideoFileTheora::popFrameRing()
+{
+    assert(codec->frameRingCount > 0);
+
+    const THEORAPLAY_VideoFrame *videoFrame = codec->frameRing[codec->frameRingStart];
+    codec->frameRingStart = (codec->frameRingStart + 1) % codec->frameRingSize;
+    codec->frameRingCount--;
+    codec->decodePosition = getFrameTime(codec, videoFrame);
+
+    return videoFrame;
+}
+
+void VideoFileTheora::stopDecode()
+{
+    while (codec->frameRingCount > 0)
+    {
+        THEORAPLAY_freeVideo(popFrameRing());
+    }
+    codec->frameRingStart = 0;
+
+    if (codec->decoder != NULL)
+    {
+        THEORAPLAY_stopDecode(codec->decoder);
+        codec->decoder = NULL;
+    }
+}
+
+bool VideoFileTheora::startDecode(double time)
+{
+    double keyframeTime = 0.0;
+    double firstFrameTime = 0.0;
+    long seekOffset = keyframeIndex->findSeekOffset(time, keyframeTime, firstFrameTime);
+
+    // decoder thread buffers at most the same amount of frames as the ring
+    unsigned int maxFrames = codec->frameRingSize;
+
+    if (keyframeIndex->isEmpty() || seekOffset <= keyframeIndex->getHeaderEnd())
+    {
+        loggerDebug("Start decode again '%s'",getFilePath().c_str());
+        codec->decoder = THEORAPLAY_startDecodeFile(getFilePath().c_str(), maxFrames, THEORAPLAY_VIDFMT_IYUV);
+        keyframeTime = 0.0;
+        firstFrameTime = 0.0;
+    }
+    else
+    {
+        loggerDebug("Start decode from keyframe '%s'! time:%.3f, keyframeTime:%.3f, firstFrameTime:%.3f, offset:%ld", getFilePath().c_str(), time, keyframeTime, firstFrameTime, seekOffset);
+
+        FILE *file = fopen(getFilePath().c_str(), "rb");
+        if (file == NULL)
+        {
+            loggerError("Could not open video file! '%s'", getFilePath().c_str());
+            return false;
+        }
+
+        struct video_theora_seek_io_t *seekIo = (struct video_theora_seek_io_t*)malloc(sizeof(struct video_theora_seek_io_t));
+        THEORAPLAY_Io *io = (THEORAPLAY_Io*)malloc(sizeof(THEORAPLAY_Io));
+        assert(seekIo && io);
+
+        seekIo->file = file;
+        seekIo->position = 0;
+        seekIo->headerEnd = keyframeIndex->getHeaderEnd();
+        seekIo->seekOffset = seekOffset;
+
+        io->read = seekIoRead;
+        io->close = seekIoClose;
+        io->userdata = seekIo;
+
+        // decoder takes ownership of io and closes it when stopped
+        codec->decoder = THEORAPLAY_startDecode(io, maxFrames, THEORAPLAY_VIDFMT_IYUV);
+    }
+
+    if (!codec->decoder)
+    {
+        loggerError("Could not decode file! '%s'", getFilePath().c_str());
+        return false;
+    }
+
+    // libtheora derives timestamps from its own frame counter, not from the page granule positions
+    codec->decodeTimeOffset = firstFrameTime;
+    codec->decodeTimeVerified = keyframeTime == 0.0 && firstFrameTime == 0.0;
+    codec->decodePosition = keyframeTime;
+
+    return true;
+}
+
 bool VideoFileTheora::loadVideoTheora()
 {
-    loadVideoTheoraFrame(0.0);
+    loadVideoTheoraFrame(0.0, true);
 
     int isInitialized = THEORAPLAY_isInitialized(codec->decoder);
     int hasAudio = THEORAPLAY_hasAudioStream(codec->decoder);
@@ -367,7 +625,7 @@ bool VideoFileTheora::loadVideoTheora()
         THEORAPLAY_stopDecode(codec->decoder);
     }*/
 
-    if (!isInitialized || !hasVideo)
+    if (!isInitialized || !hasVideo || codec->currentFrame == NULL)
     {
         loggerError("Could not initialize video! '%s'");
         return false;
@@ -439,12 +697,23 @@ bool VideoFileTheora::freeVideoTheora()
             freeFrameTheora(&codec->currentFrame);
         }
 
+        if (codec->frameRing)
+        {
+            stopDecode();
+            free(codec->frameRing);
+        }
+
         THEORAPLAY_stopDecode(codec->decoder);
 
         free(codec);
         codec = NULL;
     }
 
+    if (frameConverter != NULL) {
+        delete frameConverter;
+        frameConverter = NULL;
+    }
+
     width = height = frame = 0;
     speed = 1.0;
     fps = 0.0;
@@ -458,11 +727,31 @@ bool VideoFileTheora::freeVideoTheora()
     pauseTime = 0.0f;
     length = 0.0f;
     currentFrame = 0;
+    lateFrameCount = 0;
     state = VIDEO_STOPPED;
 
     return true;
 }
 
+void VideoFileTheora::setFrameCacheSize(unsigned int frameCacheSize)
+{
+    frameCache->setMemoryLimit(static_cast<size_t>(frameCacheSize) * 1024 * 1024);
+}
+
+void VideoFileTheora::suspend()
+{
+    if (codec != NULL && codec->decoder != NULL)
+    {
+        // current frame stays in the texture, decoding continues from the nearest keyframe when resumed
+        stopDecode();
+    }
+}
+
+unsigned int VideoFileTheora::getLateFrameCount()
+{
+    return lateFrameCount;
+}
+
 void VideoFileTheora::setLength(float length)
 {
     this->length = length;
@@ -471,19 +760,18 @@ void VideoFileTheora::setLength(float length)
 bool VideoFileTheora::videoRefreshFrame()
 {
     assert(codecType == CODEC_THEORA);
-    const THEORAPLAY_VideoFrame *videoFrame = codec->currentFrame->video;
-    assert(videoFrame);
+    assert(codec->framePixels);
 
     // TODO: support varying image sizes?
     /*const unsigned int w = videoFrame->width;
     const unsigned int h = videoFrame->height;*/
 
-    if (texture != NULL) {
-        texture->update(videoFrame->pixels);
-    } else {
+    if (texture == NULL) {
         texture = Texture::newInstance();
-        texture->setFormat(TextureFormat::RGB);
-        if (texture->create(width, height, videoFrame->pixels) == false) {
+        texture->setFormat(TextureFormat::RGBA);
+        // video frames are updated constantly, mipmaps would need to be regenerated for each frame
+        texture->setMipmap(TextureMipmap::NONE);
+        if (texture->create(width, height) == false) {
             loggerError("Could not load image, error creating texture. file:'%s' width:%d, height:%d, texture:0x%p",
                 getFilePath().c_str(), width, height, texture);
 
@@ -491,7 +779,20 @@ bool VideoFileTheora::videoRefreshFrame()
         }
     }
 
-    return true;
+    // decoder outputs YUV planes, RGB conversion is done in GPU
+    if (frameConverter == NULL) {
+        frameConverter = new VideoFrameConverter();
+        if (!frameConverter->create(width, height, texture)) {
+            loggerError("Could not create video frame converter. file:'%s' width:%d, height:%d",
+                getFilePath().c_str(), width, height);
+
+            delete frameConverter;
+            frameConverter = NULL;
+            return false;
+        }
+    }
+
+    return frameConverter->update(codec->framePixels);
 }
 
 void VideoFileTheora::setSpeed(double speed)
@@ -587,8 +888,7 @@ void VideoFileTheora::draw()
     {
         if (state == VIDEO_PLAYING && codec->decoder)
         {
-            THEORAPLAY_stopDecode(codec->decoder);
-            codec->decoder = NULL;
+            stopDecode();
         }
 
         return;
@@ -611,17 +911,30 @@ void VideoFileTheora::draw()
         return;
     }*/
 
+    // next frame needs to be ready by this time
+    double deadline = EnginePlayer::getInstance().getTimer().getTimeInSeconds();
+    if (fps*speed > 0.0)
+    {
+        deadline += 1.0/(fps*speed);
+    }
+
+    if (!VideoDecodeScheduler::getInstance().request(this, deadline))
+    {
+        return; //no free decode worker, keep showing the previous frame
+    }
+
     if (currentFrame == frame_i)
     {
         return; //assume that frame has been buffered
     }
-    currentFrame = frame_i;
     loadVideoTheoraFrame(runningTime*speed);
 
     //codec->currentFrame->video = codec->frames[currentFrame]->video;
 
-    if (codec->currentFrame->video)
+    // if frame was not decoded in time, previous frame is kept and load is retried on next draw
+    if (codec->frameUpdated)
     {
+        currentFrame = frame_i;
         //loggerTrace("FRAME PLAY: %u, %u, %.2f, fps:%.2f, speed:%.2f", currentFrame, frame_i, runningTime, fps, speed);
         videoRefreshFrame();
     }
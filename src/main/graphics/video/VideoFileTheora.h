@@ -3,9 +3,15 @@
 
 #include "VideoFile.h"
 
+#include <vector>
+
 class Texture;
+class VideoFrameConverter;
+class VideoKeyframeIndex;
+class VideoFrameCache;
 struct video_theora_frame_t;
 struct video_theora_t;
+struct THEORAPLAY_VideoFrame;
 
 
 class VideoFileTheora : public VideoFile {
@@ -22,12 +28,20 @@ public:
     void setStartTime(float startTime);
     void setTime(float time);
     void setLength(float length);
+    void setFrameCacheSize(unsigned int frameCacheSize);
     void stop();
     void pause();
     void draw();
+    void suspend();
+    unsigned int getLateFrameCount();
 
 private:
-    bool loadVideoTheoraFrame(double time);
+    bool loadVideoTheoraFrame(double time, bool wait=false);
+    const THEORAPLAY_VideoFrame* acquireVideoFrame(double time, bool allowLate, bool &late);
+    unsigned int fillFrameRing();
+    const THEORAPLAY_VideoFrame* popFrameRing();
+    bool startDecode(double time);
+    void stopDecode();
     bool loadVideoTheora();
     void freeFrameTheora(struct video_theora_frame_t **frame);
     bool freeVideoTheora();
@@ -41,10 +55,16 @@ private:
     double fps;
     double speed;
     unsigned int currentFrame;
+    unsigned int lateFrameCount;
     bool paused;
     bool useAudio;
     bool loop;
     Texture *frameTexture;
+    VideoFrameConverter *frameConverter;
+    VideoKeyframeIndex *keyframeIndex;
+    VideoFrameCache *frameCache;
+    // copy of the cached frame being shown, cache entries may be evicted before the frame is converted
+    std::vector<unsigned char> cachedFramePixels;
     int codecType;
     struct video_theora_t *codec;
 };
@@ -0,0 +1,84 @@
+#include "VideoFrameCache.h"
+
+#include "logger/logger.h"
+
+#include <string.h>
+
+VideoFrameCache::VideoFrameCache() {
+    memoryLimit = 0;
+    memoryUsage = 0;
+    hits = 0;
+    misses = 0;
+}
+
+void VideoFrameCache::setMemoryLimit(size_t memoryLimit) {
+    this->memoryLimit = memoryLimit;
+    evict(0);
+}
+
+size_t VideoFrameCache::getMemoryLimit() {
+    return memoryLimit;
+}
+
+size_t VideoFrameCache::getMemoryUsage() {
+    return memoryUsage;
+}
+
+bool VideoFrameCache::get(unsigned int frame, std::vector<unsigned char>& pixels) {
+    auto it = frames.find(frame);
+    if (it == frames.end()) {
+        misses++;
+        return false;
+    }
+
+    hits++;
+    usage.splice(usage.begin(), usage, it->second.usage);
+
+    pixels.assign(it->second.pixels.begin(), it->second.pixels.end());
+
+    return true;
+}
+
+bool VideoFrameCache::put(unsigned int frame, const unsigned char *pixels, size_t size) {
+    if (size > memoryLimit) {
+        return false;
+    }
+
+    if (frames.find(frame) != frames.end()) {
+        return true;
+    }
+
+    evict(size);
+
+    usage.push_front(frame);
+
+    CachedFrame& cachedFrame = frames[frame];
+    cachedFrame.pixels.resize(size);
+    memcpy(cachedFrame.pixels.data(), pixels, size);
+    cachedFrame.usage = usage.begin();
+    memoryUsage += size;
+
+    return true;
+}
+
+void VideoFrameCache::evict(size_t size) {
+    while (!usage.empty() && memoryUsage + size > memoryLimit) {
+        auto it = frames.find(usage.back());
+        memoryUsage -= it->second.pixels.size();
+        frames.erase(it);
+        usage.pop_back();
+    }
+}
+
+void VideoFrameCache::clear() {
+    if (hits > 0 || misses > 0) {
+        loggerDebug("Video frame cache cleared. frames:%u, memoryUsage:%u, hits:%u, misses:%u",
+            static_cast<unsigned int>(frames.size()), static_cast<unsigned int>(memoryUsage), hits, misses);
+    }
+
+    frames.clear();
+    usage.clear();
+    memoryUsage = 0;
+    hits = 0;
+    misses = 0;
+}
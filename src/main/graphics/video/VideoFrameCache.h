@@ -0,0 +1,43 @@
+#ifndef ENGINE_GRAPHICS_VIDEO_VIDEOFRAMECACHE_H_
+#define ENGINE_GRAPHICS_VIDEO_VIDEOFRAMECACHE_H_
+
+#include <list>
+#include <vector>
+#include <unordered_map>
+#include <cstddef>
+
+/**
+ * Least recently used cache of decoded video frames, keyed by frame number.
+ * Frames are evicted when the memory limit would be exceeded.
+ */
+class VideoFrameCache {
+public:
+    VideoFrameCache();
+    void setMemoryLimit(size_t memoryLimit);
+    size_t getMemoryLimit();
+    size_t getMemoryUsage();
+    /**
+     * Copy cached frame to pixels. Returns false if the frame is not cached.
+     * Frames are copied out, so that later puts may evict them.
+     */
+    bool get(unsigned int frame, std::vector<unsigned char>& pixels);
+    bool put(unsigned int frame, const unsigned char *pixels, size_t size);
+    void clear();
+private:
+    void evict(size_t size);
+
+    struct CachedFrame {
+        std::vector<unsigned char> pixels;
+        std::list<unsigned int>::iterator usage;
+    };
+
+    std::unordered_map<unsigned int, CachedFrame> frames;
+    // most recently used frame first
+    std::list<unsigned int> usage;
+    size_t memoryLimit;
+    size_t memoryUsage;
+    unsigned int hits;
+    unsigned int misses;
+};
+
+#endif /*ENGINE_GRAPHICS_VIDEO_VIDEOFRAMECACHE_H_*/
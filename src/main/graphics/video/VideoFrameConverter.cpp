@@ -0,0 +1,271 @@
+#include "VideoFrameConverter.h"
+
+#include "graphics/Texture.h"
+#include "graphics/TextureOpenGl.h"
+#include "graphics/Shader.h"
+#include "graphics/ShaderProgram.h"
+#include "graphics/ShaderProgramOpenGl.h"
+#include "graphics/Graphics.h"
+#include "io/MemoryManager.h"
+#include "logger/logger.h"
+
+#include <string.h>
+
+ShaderProgram *VideoFrameConverter::shaderProgram = NULL;
+
+VideoFrameConverter::VideoFrameConverter() {
+    width = 0;
+    height = 0;
+    frameSize = 0;
+    output = NULL;
+    pixelBufferIndex = 0;
+    framebuffer = 0;
+    vertexArray = 0;
+
+    for (int i = 0; i < VIDEO_FRAME_PLANES; i++) {
+        planes[i] = NULL;
+        planeWidth[i] = 0;
+        planeHeight[i] = 0;
+        planeOffset[i] = 0;
+    }
+
+    for (int i = 0; i < VIDEO_PIXEL_BUFFERS; i++) {
+        pixelBuffers[i] = 0;
+    }
+}
+
+VideoFrameConverter::~VideoFrameConverter() {
+    free();
+}
+
+bool VideoFrameConverter::initShaderProgram() {
+    if (shaderProgram != NULL) {
+        return true;
+    }
+
+    MemoryManager<Shader>& shaderMemory = MemoryManager<Shader>::getInstance();
+    Shader *vertexShader = shaderMemory.getResource(std::string("_embedded/videoYuv.vs"), true);
+    Shader *fragmentShader = shaderMemory.getResource(std::string("_embedded/videoYuv.fs"), true);
+    if (!vertexShader->load() || !fragmentShader->load()) {
+        loggerError("Could not compile video YUV conversion shaders");
+        return false;
+    }
+
+    MemoryManager<ShaderProgram>& shaderProgramMemory = MemoryManager<ShaderProgram>::getInstance();
+    ShaderProgram *program = shaderProgramMemory.getResource(std::string("DefaultVideoYuv"), true);
+    program->addShader(vertexShader);
+    program->addShader(fragmentShader);
+    if (!program->link()) {
+        loggerError("Could not link video YUV conversion shader program");
+        return false;
+    }
+
+    shaderProgram = program;
+    return true;
+}
+
+bool VideoFrameConverter::create(int width, int height, Texture *output) {
+    PROFILER_BLOCK("VideoFrameConverter::create");
+
+    free();
+
+    if (output == NULL) {
+        loggerError("No output texture given for video frame conversion");
+        return false;
+    }
+
+    if (!initShaderProgram()) {
+        return false;
+    }
+
+    this->width = width;
+    this->height = height;
+    this->output = output;
+
+    // IYUV: full resolution luma plane followed by quarter resolution U and V planes
+    planeWidth[0] = width;
+    planeHeight[0] = height;
+    planeWidth[1] = planeWidth[2] = width / 2;
+    planeHeight[1] = planeHeight[2] = height / 2;
+
+    frameSize = 0;
+    for (int i = 0; i < VIDEO_FRAME_PLANES; i++) {
+        planeOffset[i] = frameSize;
+        frameSize += static_cast<size_t>(planeWidth[i]) * static_cast<size_t>(planeHeight[i]);
+
+        planes[i] = Texture::newInstance();
+        planes[i]->setFormat(TextureFormat::RED);
+        planes[i]->setFilter(TextureFilter::LINEAR);
+        planes[i]->setMipmap(TextureMipmap::NONE);
+        if (!planes[i]->create(planeWidth[i], planeHeight[i])) {
+            loggerError("Could not create video plane texture. plane:%d, dimensions:%dx%d", i, planeWidth[i], planeHeight[i]);
+            free();
+            return false;
+        }
+    }
+
+    glGenBuffers(VIDEO_PIXEL_BUFFERS, pixelBuffers);
+    for (int i = 0; i < VIDEO_PIXEL_BUFFERS; i++) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixelBuffers[i]);
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(frameSize), NULL, GL_STREAM_DRAW);
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    pixelBufferIndex = 0;
+
+    // attribute-less draw still needs a vertex array in core profile
+    glGenVertexArrays(1, &vertexArray);
+
+    GLint previousFramebuffer = 0;
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previousFramebuffer);
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, framebuffer);
+    glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, dynamic_cast<TextureOpenGl*>(output)->getId(), 0);
+    GLenum status = glCheckFramebufferStatus(GL_DRAW_FRAMEBUFFER);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, static_cast<GLuint>(previousFramebuffer));
+
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        loggerError("Video frame conversion framebuffer not complete. status:0x%X", status);
+        free();
+        return false;
+    }
+
+    Graphics &graphics = Graphics::getInstance();
+    if (graphics.handleErrors()) {
+        loggerError("Could not create video frame converter. dimensions:%dx%d", width, height);
+        free();
+        return false;
+    }
+
+    loggerDebug("Created video frame converter. dimensions:%dx%d, frameSize:%u, pixelBuffers:%d", width, height, frameSize, VIDEO_PIXEL_BUFFERS);
+
+    return true;
+}
+
+void VideoFrameConverter::uploadPlanes(const unsigned char *yuvPlanes) {
+    // previous uploads may still be in flight, ring of buffers avoids stalling on them
+    pixelBufferIndex = (pixelBufferIndex + 1) % VIDEO_PIXEL_BUFFERS;
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixelBuffers[pixelBufferIndex]);
+    void *mappedBuffer = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(frameSize),
+        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (mappedBuffer == NULL) {
+        loggerWarning("Could not map video pixel buffer, uploading directly");
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        for (int i = 0; i < VIDEO_FRAME_PLANES; i++) {
+            planes[i]->update(yuvPlanes + planeOffset[i]);
+        }
+        return;
+    }
+
+    memcpy(mappedBuffer, yuvPlanes, frameSize);
+    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (int i = 0; i < VIDEO_FRAME_PLANES; i++) {
+        // with a bound unpack buffer the data pointer is an offset to the buffer
+        planes[i]->bind();
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, planeWidth[i], planeHeight[i], GL_RED, GL_UNSIGNED_BYTE,
+            reinterpret_cast<const void*>(planeOffset[i]));
+        planes[i]->unbind();
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+
+void VideoFrameConverter::convert() {
+    GLint previousFramebuffer = 0;
+    GLint previousViewport[4] = {0, 0, 0, 0};
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previousFramebuffer);
+    glGetIntegerv(GL_VIEWPORT, previousViewport);
+    GLboolean blend = glIsEnabled(GL_BLEND);
+    GLboolean depthTest = glIsEnabled(GL_DEPTH_TEST);
+    // scripts may leave scissor or face culling enabled, they would clip the full-screen triangle
+    GLboolean scissorTest = glIsEnabled(GL_SCISSOR_TEST);
+    GLboolean cullFace = glIsEnabled(GL_CULL_FACE);
+
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, framebuffer);
+    glViewport(0, 0, width, height);
+    glDisable(GL_BLEND);
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_SCISSOR_TEST);
+    glDisable(GL_CULL_FACE);
+
+    shaderProgram->bind();
+
+    const char *samplers[VIDEO_FRAME_PLANES] = {"textureY", "textureU", "textureV"};
+    for (int i = 0; i < VIDEO_FRAME_PLANES; i++) {
+        planes[i]->bind(i);
+        GLint samplerId = ShaderProgramOpenGl::getUniformLocation(samplers[i]);
+        if (samplerId != -1) {
+            glUniform1i(samplerId, i);
+        }
+    }
+
+    glBindVertexArray(vertexArray);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glBindVertexArray(0);
+
+    for (int i = VIDEO_FRAME_PLANES - 1; i >= 0; i--) {
+        planes[i]->unbind(i);
+    }
+
+    shaderProgram->unbind();
+
+    if (cullFace) {
+        glEnable(GL_CULL_FACE);
+    }
+    if (scissorTest) {
+        glEnable(GL_SCISSOR_TEST);
+    }
+    if (depthTest) {
+        glEnable(GL_DEPTH_TEST);
+    }
+    if (blend) {
+        glEnable(GL_BLEND);
+    }
+    glViewport(previousViewport[0], previousViewport[1], previousViewport[2], previousViewport[3]);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, static_cast<GLuint>(previousFramebuffer));
+}
+
+bool VideoFrameConverter::update(const unsigned char *yuvPlanes) {
+    PROFILER_BLOCK("VideoFrameConverter::update");
+
+    if (framebuffer == 0 || yuvPlanes == NULL) {
+        loggerError("Video frame converter not created, can't update. converter:0x%p", this);
+        return false;
+    }
+
+    uploadPlanes(yuvPlanes);
+    convert();
+
+    return true;
+}
+
+void VideoFrameConverter::free() {
+    for (int i = 0; i < VIDEO_FRAME_PLANES; i++) {
+        if (planes[i] != NULL) {
+            delete planes[i];
+            planes[i] = NULL;
+        }
+    }
+
+    if (pixelBuffers[0] != 0) {
+        glDeleteBuffers(VIDEO_PIXEL_BUFFERS, pixelBuffers);
+        for (int i = 0; i < VIDEO_PIXEL_BUFFERS; i++) {
+            pixelBuffers[i] = 0;
+        }
+    }
+
+    if (framebuffer != 0) {
+        glDeleteFramebuffers(1, &framebuffer);
+        framebuffer = 0;
+    }
+
+    if (vertexArray != 0) {
+        glDeleteVertexArrays(1, &vertexArray);
+        vertexArray = 0;
+    }
+
+    output = NULL;
+}
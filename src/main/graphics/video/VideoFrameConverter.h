@@ -0,0 +1,44 @@
+#ifndef ENGINE_GRAPHICS_VIDEO_VIDEOFRAMECONVERTER_H_
+#define ENGINE_GRAPHICS_VIDEO_VIDEOFRAMECONVERTER_H_
+
+#include "GL/gl3w.h"
+
+class Texture;
+class ShaderProgram;
+
+#define VIDEO_FRAME_PLANES 3
+#define VIDEO_PIXEL_BUFFERS 3
+
+/**
+ * Uploads YUV 4:2:0 (IYUV) video frames as three R8 plane textures through a ring of pixel unpack buffers
+ * and converts them to RGB in a shader, rendering to the given output texture.
+ */
+class VideoFrameConverter {
+public:
+    VideoFrameConverter();
+    ~VideoFrameConverter();
+    bool create(int width, int height, Texture *output);
+    bool update(const unsigned char *yuvPlanes);
+    void free();
+private:
+    bool initShaderProgram();
+    void uploadPlanes(const unsigned char *yuvPlanes);
+    void convert();
+
+    int width;
+    int height;
+    int planeWidth[VIDEO_FRAME_PLANES];
+    int planeHeight[VIDEO_FRAME_PLANES];
+    size_t planeOffset[VIDEO_FRAME_PLANES];
+    size_t frameSize;
+    Texture *planes[VIDEO_FRAME_PLANES];
+    Texture *output;
+    GLuint pixelBuffers[VIDEO_PIXEL_BUFFERS];
+    unsigned int pixelBufferIndex;
+    GLuint framebuffer;
+    GLuint vertexArray;
+
+    static ShaderProgram *shaderProgram;
+};
+
+#endif /*ENGINE_GRAPHICS_VIDEO_VIDEOFRAMECONVERTER_H_*/
@@ -0,0 +1,175 @@
+#include "VideoKeyframeIndex.h"
+
+#include "logger/logger.h"
+
+#include <ogg/ogg.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+
+VideoKeyframeIndex::VideoKeyframeIndex() {
+    clear();
+}
+
+void VideoKeyframeIndex::clear() {
+    pages.clear();
+    headerEnd = 0;
+    serialNumber = 0;
+    theoraFound = false;
+    fpsNumerator = 0;
+    fpsDenominator = 0;
+    granuleShift = 0;
+    frameOffset = 0;
+}
+
+bool VideoKeyframeIndex::isEmpty() {
+    return pages.empty();
+}
+
+long VideoKeyframeIndex::getHeaderEnd() {
+    return headerEnd;
+}
+
+bool VideoKeyframeIndex::parseIdentificationHeader(const unsigned char *packet, long length) {
+    const long IDENTIFICATION_HEADER_SIZE = 42;
+    if (length < IDENTIFICATION_HEADER_SIZE || packet[0] != 0x80 || memcmp(packet + 1, "theora", 6) != 0) {
+        return false;
+    }
+
+    unsigned char versionRevision = packet[9];
+    fpsNumerator = (packet[22] << 24) | (packet[23] << 16) | (packet[24] << 8) | packet[25];
+    fpsDenominator = (packet[26] << 24) | (packet[27] << 16) | (packet[28] << 8) | packet[29];
+    granuleShift = ((packet[40] & 0x03) << 3) | (packet[41] >> 5);
+
+    // since bitstream version 3.2.1 granule positions count frames starting from 1
+    frameOffset = versionRevision >= 1 ? 1 : 0;
+
+    return fpsNumerator > 0 && fpsDenominator > 0;
+}
+
+bool VideoKeyframeIndex::build(const unsigned char *data, size_t length) {
+    PROFILER_BLOCK("VideoKeyframeIndex::build");
+
+    clear();
+
+    if (data == NULL || length == 0) {
+        return false;
+    }
+
+    ogg_sync_state sync;
+    ogg_sync_init(&sync);
+
+    const size_t CHUNK_SIZE = 64 * 1024;
+    size_t position = 0;
+    long offset = 0;
+    ogg_page page;
+
+    while (true) {
+        long result = ogg_sync_pageseek(&sync, &page);
+        if (result == 0) {
+            if (position >= length) {
+                break;
+            }
+
+            size_t chunk = std::min(CHUNK_SIZE, length - position);
+            char *buffer = ogg_sync_buffer(&sync, static_cast<long>(chunk));
+            memcpy(buffer, data + position, chunk);
+            ogg_sync_wrote(&sync, static_cast<long>(chunk));
+            position += chunk;
+            continue;
+        }
+
+        if (result < 0) {
+            // skipped bytes while syncing to next page
+            offset += -result;
+            continue;
+        }
+
+        long pageOffset = offset;
+        offset += result;
+
+        ogg_int64_t granulePosition = ogg_page_granulepos(&page);
+
+        if (!theoraFound && ogg_page_bos(&page)) {
+            if (parseIdentificationHeader(page.body, page.body_len)) {
+                theoraFound = true;
+                serialNumber = ogg_page_serialno(&page);
+            }
+            continue;
+        }
+
+        // header pages have zero granule position, first data page of any stream ends the headers
+        if (headerEnd == 0 && granulePosition != 0 && !ogg_page_bos(&page)) {
+            headerEnd = pageOffset;
+        }
+
+        if (!theoraFound || ogg_page_serialno(&page) != serialNumber || granulePosition < 0 || headerEnd == 0) {
+            continue;
+        }
+
+        VideoKeyframePage keyframePage;
+        keyframePage.offset = pageOffset;
+        keyframePage.keyframe = (granulePosition >> granuleShift) - frameOffset;
+        keyframePage.frame = keyframePage.keyframe + (granulePosition & ((static_cast<ogg_int64_t>(1) << granuleShift) - 1));
+        keyframePage.firstFrame = keyframePage.frame - ogg_page_packets(&page) + 1 + (ogg_page_continued(&page) ? 1 : 0);
+        pages.push_back(keyframePage);
+    }
+
+    ogg_sync_clear(&sync);
+
+    if (!theoraFound) {
+        loggerWarning("No Theora stream found, video seeking index not available");
+        clear();
+        return false;
+    }
+
+    loggerDebug("Built video keyframe index. pages:%u, headerEnd:%ld, fps:%u/%u, granuleShift:%d",
+        pages.size(), headerEnd, fpsNumerator, fpsDenominator, granuleShift);
+
+    return true;
+}
+
+double VideoKeyframeIndex::getFrameTime(int64_t frame) {
+    return static_cast<double>(frame) * fpsDenominator / fpsNumerator;
+}
+
+long VideoKeyframeIndex::findSeekOffset(double time, double &keyframeTime) {
+    double firstFrameTime = 0.0;
+    return findSeekOffset(time, keyframeTime, firstFrameTime);
+}
+
+long VideoKeyframeIndex::findSeekOffset(double time, double &keyframeTime, double &firstFrameTime) {
+    keyframeTime = 0.0;
+    firstFrameTime = 0.0;
+    if (pages.empty()) {
+        return headerEnd;
+    }
+
+    int64_t targetFrame = static_cast<int64_t>(floor(time * fpsNumerator / fpsDenominator));
+
+    // keyframe of the target is found from the page where the target frame is completed
+    auto target = std::lower_bound(pages.begin(), pages.end(), targetFrame,
+        [](const VideoKeyframePage &page, int64_t frame) { return page.frame < frame; });
+    if (target == pages.end()) {
+        target = pages.end() - 1;
+    }
+
+    int64_t keyframe = target->keyframe;
+    if (keyframe > targetFrame) {
+        // keyframe starts after target in the same page, previous page's keyframe precedes the target
+        keyframe = target == pages.begin() ? 0 : (target - 1)->keyframe;
+    }
+
+    // decoding is started from the page where the frame before the keyframe is completed,
+    // as keyframe packet may begin in that page
+    auto start = std::lower_bound(pages.begin(), pages.end(), keyframe,
+        [](const VideoKeyframePage &page, int64_t frame) { return page.frame < frame; });
+    if (start == pages.begin()) {
+        return headerEnd;
+    }
+
+    // decoder counts frames from the first packet it gets, its timestamps are relative to that frame
+    keyframeTime = getFrameTime(keyframe);
+    firstFrameTime = getFrameTime((start - 1)->firstFrame);
+    return (start - 1)->offset;
+}
@@ -0,0 +1,42 @@
+#ifndef ENGINE_GRAPHICS_VIDEO_VIDEOKEYFRAMEINDEX_H_
+#define ENGINE_GRAPHICS_VIDEO_VIDEOKEYFRAMEINDEX_H_
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+struct VideoKeyframePage {
+    long offset;
+    int64_t keyframe;
+    int64_t frame;
+    // first frame fed to the decoder when decoding starts from this page, a continued packet is dropped
+    int64_t firstFrame;
+};
+
+/**
+ * Index of Theora video pages in an Ogg file, used to restart decoding from the nearest keyframe when seeking.
+ */
+class VideoKeyframeIndex {
+public:
+    VideoKeyframeIndex();
+    bool build(const unsigned char *data, size_t length);
+    void clear();
+    bool isEmpty();
+    long getHeaderEnd();
+    long findSeekOffset(double time, double &keyframeTime);
+    long findSeekOffset(double time, double &keyframeTime, double &firstFrameTime);
+private:
+    bool parseIdentificationHeader(const unsigned char *packet, long length);
+    double getFrameTime(int64_t frame);
+
+    std::vector<VideoKeyframePage> pages;
+    long headerEnd;
+    int serialNumber;
+    bool theoraFound;
+    unsigned int fpsNumerator;
+    unsigned int fpsDenominator;
+    int granuleShift;
+    int frameOffset;
+};
+
+#endif /*ENGINE_GRAPHICS_VIDEO_VIDEOKEYFRAMEINDEX_H_*/
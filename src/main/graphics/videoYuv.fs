@@ -0,0 +1,26 @@
+#version 330 core
+
+in vec2 texCoord;
+out vec4 fragColor;
+
+uniform sampler2D textureY;
+uniform sampler2D textureU;
+uniform sampler2D textureV;
+
+void main()
+{
+    // Decoder flips only RGB output, YUV planes are top-down
+    vec2 coord = vec2(texCoord.s, 1.0 - texCoord.t);
+
+    // Theora uses ITU-R BT.601 with video range luma and chroma
+    float y = 1.164383 * (texture(textureY, coord).r - 0.062745);
+    float u = texture(textureU, coord).r - 0.501961;
+    float v = texture(textureV, coord).r - 0.501961;
+
+    vec3 rgb = vec3(
+        y + 1.596027 * v,
+        y - 0.391762 * u - 0.812968 * v,
+        y + 2.017232 * u);
+
+    fragColor = vec4(clamp(rgb, 0.0, 1.0), 1.0);
+}
@@ -0,0 +1,11 @@
+#version 330 core
+
+out vec2 texCoord;
+
+// Full-screen triangle generated from the vertex ID, no vertex buffers needed
+void main(void)
+{
+    vec2 position = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    texCoord = position;
+    gl_Position = vec4(position * 2.0 - 1.0, 0.0, 1.0);
+}
@@ -13,6 +13,7 @@ public:
     virtual void setProjectionMode() = 0;
     virtual void setViewMode() = 0;
     virtual void setModelMode() = 0;
+    virtual MatrixMode getMode() = 0;
     virtual void loadIdentity() = 0;
     virtual void setMatrix4(const double* rowOrderMat4x4) = 0;
     virtual const double* getMatrix4() = 0;
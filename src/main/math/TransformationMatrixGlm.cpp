@@ -12,26 +12,47 @@
 
 #include "glm/gtc/matrix_inverse.hpp"
 
-std::vector<TransformationMatrixGlm*> TransformationMatrixGlm::matrixStack = {};
+TransformationMatrixGlm::StackEntry TransformationMatrixGlm::matrixStack[MATRIX_STACK_CAPACITY];
+unsigned int TransformationMatrixGlm::matrixStackSize = 0;
 
 void TransformationMatrixGlm::push() {
     PROFILER_BLOCK("TransformationMatrixGlm::push");
-    matrixStack.push_back(new TransformationMatrixGlm(*this));
+
+    if (matrixStackSize >= MATRIX_STACK_CAPACITY) {
+        loggerFatal("Matrix stack overflow, push/pop mismatch? capacity:%u", MATRIX_STACK_CAPACITY);
+        return;
+    }
+
+    StackEntry& entry = matrixStack[matrixStackSize++];
+    entry.projection = projection;
+    entry.view = view;
+    entry.model = model;
+    entry.mode = mode;
+    entry.mvp = mvp;
+    entry.normalMatrix = normalMatrix;
+    entry.dirty = dirty;
 }
 
 void TransformationMatrixGlm::pop() {
     PROFILER_BLOCK("TransformationMatrixGlm::pop");
 
-    if (matrixStack.begin() == matrixStack.end()) {
+    if (matrixStackSize == 0) {
         loggerFatal("Attempted to pop empty matrix stack");
         return;
     }
 
-    delete matrixStack.back();
-    matrixStack.pop_back();
-
-    if (! matrixStack.empty()) {
-        *this = *matrixStack.back();
+    matrixStackSize--;
+
+    if (matrixStackSize > 0) {
+        const StackEntry& entry = matrixStack[matrixStackSize - 1];
+        projection = entry.projection;
+        view = entry.view;
+        model = entry.model;
+        setMode(entry.mode);
+        mvp = entry.mvp;
+        normalMatrix = entry.normalMatrix;
+        // float copies are cheap to convert again, so they're not stored in the stack
+        dirty = entry.dirty | DIRTY_PROJECTION | DIRTY_VIEW | DIRTY_MODEL;
     }
 }
 
@@ -50,14 +71,16 @@ void TransformationMatrixGlm::operator=(const TransformationMatrixGlm& src) {
     view = src.view;
     model = src.model;
     normalMatrix = src.normalMatrix;
+    dirty = src.dirty;
     setMode(src.mode);
 }
 
 TransformationMatrixGlm::TransformationMatrixGlm() {
     matrix = NULL;
-    projection = glm::dmat4(1.0);
-    view = glm::dmat4(1.0);
-    model = glm::dmat4(1.0);
+    projection = MatrixGlm4(1.0f);
+    view = MatrixGlm4(1.0f);
+    model = MatrixGlm4(1.0f);
+    dirty = DIRTY_ALL;
     setProjectionMode();
 }
 
@@ -79,6 +102,10 @@ void TransformationMatrixGlm::setModelMode() {
     setMode(MODEL);
 }
 
+MatrixMode TransformationMatrixGlm::getMode() {
+    return mode;
+}
+
 void TransformationMatrixGlm::setMode(MatrixMode mode) {
     this->mode = mode;
     switch(mode) {
@@ -97,29 +124,51 @@ void TransformationMatrixGlm::setMode(MatrixMode mode) {
     }
 }
 
+void TransformationMatrixGlm::setDirty() {
+    switch(mode) {
+        case PROJECTION:
+            dirty |= DIRTY_MVP | DIRTY_PROJECTION;
+            break;
+        case VIEW:
+            dirty |= DIRTY_MVP | DIRTY_NORMAL | DIRTY_VIEW;
+            break;
+        case MODEL:
+            dirty |= DIRTY_MVP | DIRTY_NORMAL | DIRTY_MODEL;
+            break;
+        default:
+            dirty = DIRTY_ALL;
+            break;
+    }
+}
+
 void TransformationMatrixGlm::setMatrix4( const double* rowOrderMat4x4 ) {
     // row-order matrix (instead of column-order that OpenGL glLoadMatrixf would use)
     const double* m = rowOrderMat4x4;
-    *matrix = glm::dmat4(m[ 0], m[ 1], m[ 2], m[ 3],
-                         m[ 4], m[ 5], m[ 6], m[ 7],
-                         m[ 8], m[ 9], m[10], m[11],
-                         m[12], m[13], m[14], m[15]);
+    *matrix = MatrixGlm4(glm::dmat4(m[ 0], m[ 1], m[ 2], m[ 3],
+                                    m[ 4], m[ 5], m[ 6], m[ 7],
+                                    m[ 8], m[ 9], m[10], m[11],
+                                    m[12], m[13], m[14], m[15]));
+    setDirty();
 }
 
 const double* TransformationMatrixGlm::getMatrix4() {
-    return glm::value_ptr(*matrix);
+    matrix4 = glm::dmat4(*matrix);
+    return glm::value_ptr(matrix4);
 }
 
 void TransformationMatrixGlm::loadIdentity() {
-    *matrix = glm::dmat4(1.0);
+    *matrix = MatrixGlm4(1.0f);
+    setDirty();
 }
 
 void TransformationMatrixGlm::translate(double x, double y, double z) {
-    *matrix = glm::translate(*matrix, glm::dvec3(x, y, z));
+    *matrix = glm::translate(*matrix, VectorGlm3(x, y, z));
+    setDirty();
 }
 
 void TransformationMatrixGlm::scale(double x, double y, double z) {
-    *matrix = glm::scale(*matrix, glm::dvec3(x, y, z));
+    *matrix = glm::scale(*matrix, VectorGlm3(x, y, z));
+    setDirty();
 }
 
 void TransformationMatrixGlm::rotateQuaternion(double w, double x, double y, double z) {
@@ -131,15 +180,18 @@ void TransformationMatrixGlm::rotateQuaternion(double w, double x, double y, dou
 }
 
 void TransformationMatrixGlm::rotateX(double degrees) {
-    *matrix = glm::rotate(*matrix, glm::radians(degrees), glm::dvec3(-1.0, 0.0, 0.0));
+    *matrix = glm::rotate(*matrix, static_cast<MatrixScalar>(glm::radians(degrees)), VectorGlm3(-1.0, 0.0, 0.0));
+    setDirty();
 }
 
 void TransformationMatrixGlm::rotateY(double degrees) {
-    *matrix = glm::rotate(*matrix, glm::radians(degrees), glm::dvec3(0.0, -1.0, 0.0));
+    *matrix = glm::rotate(*matrix, static_cast<MatrixScalar>(glm::radians(degrees)), VectorGlm3(0.0, -1.0, 0.0));
+    setDirty();
 }
 
 void TransformationMatrixGlm::rotateZ(double degrees) {
-    *matrix = glm::rotate(*matrix, glm::radians(degrees), glm::dvec3(0.0, 0.0, -1.0));
+    *matrix = glm::rotate(*matrix, static_cast<MatrixScalar>(glm::radians(degrees)), VectorGlm3(0.0, 0.0, -1.0));
+    setDirty();
 }
 
 void TransformationMatrixGlm::perspective2d() {
@@ -156,7 +208,8 @@ void TransformationMatrixGlm::perspective2d(double width, double height) {
     lightManager.setLighting(false);
 
     setProjectionMode();
-    *matrix = glm::ortho(0.0, width, 0.0, height);
+    *matrix = MatrixGlm4(glm::ortho(0.0, width, 0.0, height));
+    setDirty();
 
     setViewMode();
     loadIdentity();
@@ -177,18 +230,20 @@ void TransformationMatrixGlm::perspective3d() {
     lightManager.setLighting(true);
 
     setProjectionMode();
-    *matrix = glm::perspective(camera.getHorizontalFov(), camera.getAspectRatio(), camera.getClipPlaneNear(), camera.getClipPlaneFar());
+    *matrix = MatrixGlm4(glm::perspective(camera.getHorizontalFov(), camera.getAspectRatio(), camera.getClipPlaneNear(), camera.getClipPlaneFar()));
+    setDirty();
 
     setViewMode();
 
     const Vector3& pos = camera.getPosition();
     const Vector3& look = camera.getLookAt();
     const Vector3& up = camera.getUp();
-    *matrix = glm::lookAt(
+    *matrix = MatrixGlm4(glm::lookAt(
         glm::dvec3(pos.x, pos.y, pos.z),
         glm::dvec3(look.x, look.y, look.z),
         glm::dvec3(up.x, up.y, up.z)
-    );
+    ));
+    setDirty();
     //loggerTrace("Current camera: %s", camera.toString().c_str());
 
     setModelMode();
@@ -198,12 +253,16 @@ void TransformationMatrixGlm::perspective3d() {
 glm::mat4 TransformationMatrixGlm::calculateMvp() {
     PROFILER_BLOCK("TransformationMatrixGlm::calculateMvp");
 
-    mvp = projection * view * model;
+    if (dirty & DIRTY_MVP) {
+        mvp = glm::mat4(projection * view * model);
+        dirty &= ~DIRTY_MVP;
+    }
+
     return mvp;
 }
 
 const float* TransformationMatrixGlm::getMvp() {
-    calculateMvp(); // TODO: precalculate mvp only when data changes
+    calculateMvp();
 
     return glm::value_ptr(mvp);
 }
@@ -225,7 +284,7 @@ void TransformationMatrixGlm::print() {
 }
 
 const float* TransformationMatrixGlm::getShadowMvp() {
-    calculateMvp(); // TODO: precalculate mvp only when data changes
+    calculateMvp();
 
     return glm::value_ptr(mvp);
 
@@ -253,22 +312,37 @@ const float* TransformationMatrixGlm::getShadowMvp() {
 }
 
 const float* TransformationMatrixGlm::getNormalMatrix() {
-    //TODO: Precalculate normal matrix only when data changes
-    normalMatrix = glm::inverseTranspose(glm::mat3(view * model));
+    if (dirty & DIRTY_NORMAL) {
+        normalMatrix = glm::inverseTranspose(glm::mat3(glm::mat4(view * model)));
+        dirty &= ~DIRTY_NORMAL;
+    }
+
     return glm::value_ptr(normalMatrix);
 }
 
 const float* TransformationMatrixGlm::getProjectionMatrix() {
-    fprojection = glm::mat4(projection);
+    if (dirty & DIRTY_PROJECTION) {
+        fprojection = glm::mat4(projection);
+        dirty &= ~DIRTY_PROJECTION;
+    }
+
     return glm::value_ptr(fprojection);
 }
 
 const float* TransformationMatrixGlm::getModelMatrix() {
-    fmodel = glm::mat4(model);
+    if (dirty & DIRTY_MODEL) {
+        fmodel = glm::mat4(model);
+        dirty &= ~DIRTY_MODEL;
+    }
+
     return glm::value_ptr(fmodel);
 }
 
 const float* TransformationMatrixGlm::getViewMatrix() {
-    fview = glm::mat4(view);
+    if (dirty & DIRTY_VIEW) {
+        fview = glm::mat4(view);
+        dirty &= ~DIRTY_VIEW;
+    }
+
     return glm::value_ptr(fview);
 }
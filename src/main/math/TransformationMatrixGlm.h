@@ -9,7 +9,24 @@
 #include "glm/gtc/quaternion.hpp"
 #include "glm/gtx/quaternion.hpp"
 
-#include <vector>
+// Maximum nesting depth of push()
+#define MATRIX_STACK_CAPACITY 128
+
+// Precision of the transformation stack, see ENGINE_SINGLE_PRECISION_MATRIX build option
+#ifdef ENGINE_SINGLE_PRECISION_MATRIX
+typedef float MatrixScalar;
+#if GLM_CONFIG_ALIGNED_GENTYPES == GLM_ENABLE
+typedef glm::mat<4, 4, float, glm::aligned_highp> MatrixGlm4;
+typedef glm::vec<3, float, glm::aligned_highp> VectorGlm3;
+#else
+typedef glm::mat4 MatrixGlm4;
+typedef glm::vec3 VectorGlm3;
+#endif
+#else
+typedef double MatrixScalar;
+typedef glm::dmat4 MatrixGlm4;
+typedef glm::dvec3 VectorGlm3;
+#endif
 
 class TransformationMatrixGlm : public TransformationMatrix {
 public:
@@ -19,6 +36,7 @@ public:
     void setProjectionMode();
     void setViewMode();
     void setModelMode();
+    MatrixMode getMode();
     void setMatrix4(const double* rowOrderMat4x4);
     const double* getMatrix4();
     void loadIdentity();
@@ -47,22 +65,48 @@ public:
     glm::mat4 calculateMvp();
     glm::mat4 mvp;
 private:
+    enum DirtyFlag {
+        DIRTY_MVP = 1 << 0,
+        DIRTY_NORMAL = 1 << 1,
+        DIRTY_PROJECTION = 1 << 2,
+        DIRTY_VIEW = 1 << 3,
+        DIRTY_MODEL = 1 << 4,
+        DIRTY_ALL = DIRTY_MVP | DIRTY_NORMAL | DIRTY_PROJECTION | DIRTY_VIEW | DIRTY_MODEL
+    };
+
+    struct StackEntry {
+        MatrixGlm4 projection;
+        MatrixGlm4 view;
+        MatrixGlm4 model;
+        MatrixMode mode;
+        // cached derived matrices are valid after pop() unless flagged dirty
+        glm::mat4 mvp;
+        glm::mat3 normalMatrix;
+        unsigned int dirty;
+    };
+
     void setMode(MatrixMode mode);
+    void setDirty();
 
-    glm::dmat4 *matrix;
-    glm::dmat4 projection;
-    glm::dmat4 view;
-    glm::dmat4 model;
+    MatrixGlm4 *matrix;
+    MatrixGlm4 projection;
+    MatrixGlm4 view;
+    MatrixGlm4 model;
+    // double copy of the current matrix for getMatrix4()
+    glm::dmat4 matrix4;
 
-    // float precisions are disliked
+    // float copies for uniforms
     glm::mat4 fprojection;
     glm::mat4 fview;
     glm::mat4 fmodel;
     glm::mat3 normalMatrix;
 
     MatrixMode mode;
+    // derived matrices that need to be recalculated, see DirtyFlag
+    unsigned int dirty;
 
-    static std::vector<TransformationMatrixGlm*> matrixStack;
+    static StackEntry matrixStack[MATRIX_STACK_CAPACITY];
+    static unsigned int matrixStackSize;
 };
 
 #endif /*ENGINE_MATH_TRANSFORMATIONMATRIXGLM_H_*/
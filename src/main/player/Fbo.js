@@ -4,8 +4,8 @@ var Fbo = function() {
     this.color = undefined;
 }
 
-Fbo.prototype.init = function(name) {
-    var legacy = fboInit(name);
+Fbo.prototype.init = function(name, transient, scale, mipmap) {
+    var legacy = fboInit(name, transient === true ? 1 : 0, scale !== void null ? scale : 1.0, mipmap === true ? 1 : 0);
 
     this.name = name;
     this.ptr = legacy.ptr;
@@ -37,8 +37,28 @@ Fbo.prototype.bind = function() {
     fboBind(this.ptr);
 }
 
-Fbo.prototype.unbind = function() {
-    fboUnbind(this.ptr);
+Fbo.prototype.unbind = function(bindParent) {
+    fboUnbind(this.ptr, bindParent === false ? 0 : 1);
+}
+
+Fbo.prototype.release = function() {
+    fboRelease(this.ptr);
+}
+
+Fbo.prototype.setUpdateInterval = function(updateInterval) {
+    fboSetUpdateInterval(this.ptr, updateInterval);
+}
+
+Fbo.prototype.isUpdateNeeded = function(time) {
+    return fboIsUpdateNeeded(this.ptr, time);
+}
+
+Fbo.prototype.setUpdated = function(time) {
+    fboSetUpdated(this.ptr, time);
+}
+
+Fbo.prototype.invalidate = function() {
+    fboInvalidate(this.ptr);
 }
 
 Fbo.prototype.updateViewport = function() {
@@ -100,6 +100,7 @@ Graphics.prototype.setColor = function(r,g,b,a) {
 }
 
 Graphics.prototype.clearDepthBuffer = function() {
+    renderQueueFlush();
     gl.clear(gl.DEPTH_BUFFER_BIT);
 }
 
@@ -0,0 +1,104 @@
+var INSTANCE_FLOAT_COUNT = 20;
+
+var InstanceBuffer = function(instanceCount) {
+    this.ptr = instanceBufferNew();
+    if (this.ptr === void null) {
+        loggerFatal("Could not initialize InstanceBuffer");
+    }
+
+    this.data = new Float32Array(0);
+    this.dirtyBegin = 0;
+    this.dirtyEnd = 0;
+    this.resized = false;
+    this.resize(instanceCount || 0);
+}
+
+InstanceBuffer.prototype.resize = function(instanceCount) {
+    var data = new Float32Array(instanceCount * INSTANCE_FLOAT_COUNT);
+    var copyCount = Math.min(data.length, this.data.length);
+    data.set(this.data.subarray(0, copyCount));
+    for (var i = this.data.length / INSTANCE_FLOAT_COUNT; i < instanceCount; i++) {
+        this._setDefaults(data, i);
+    }
+
+    this.data = data;
+    this.resized = true;
+}
+
+InstanceBuffer.prototype._setDefaults = function(data, index) {
+    var offset = index * INSTANCE_FLOAT_COUNT;
+    for (var i = 0; i < INSTANCE_FLOAT_COUNT; i++) {
+        data[offset + i] = 0.0;
+    }
+
+    // identity transformation and white color
+    data[offset + 0] = 1.0;
+    data[offset + 5] = 1.0;
+    data[offset + 10] = 1.0;
+    data[offset + 15] = 1.0;
+    data[offset + 16] = 1.0;
+    data[offset + 17] = 1.0;
+    data[offset + 18] = 1.0;
+    data[offset + 19] = 1.0;
+}
+
+InstanceBuffer.prototype.getInstanceCount = function() {
+    return this.data.length / INSTANCE_FLOAT_COUNT;
+}
+
+InstanceBuffer.prototype._markDirty = function(index, count) {
+    if (this.dirtyBegin === this.dirtyEnd) {
+        this.dirtyBegin = index;
+        this.dirtyEnd = index + count;
+    } else {
+        this.dirtyBegin = Math.min(this.dirtyBegin, index);
+        this.dirtyEnd = Math.max(this.dirtyEnd, index + count);
+    }
+}
+
+// column-major 4x4 matrix as an array of 16 numbers
+InstanceBuffer.prototype.setTransformation = function(index, matrix) {
+    this.data.set(matrix, index * INSTANCE_FLOAT_COUNT);
+    this._markDirty(index, 1);
+}
+
+InstanceBuffer.prototype.setPosition = function(index, x, y, z) {
+    var offset = index * INSTANCE_FLOAT_COUNT;
+    this.data[offset + 12] = x;
+    this.data[offset + 13] = y;
+    this.data[offset + 14] = z || 0.0;
+    this._markDirty(index, 1);
+}
+
+InstanceBuffer.prototype.setColor = function(index, r, g, b, a) {
+    var offset = index * INSTANCE_FLOAT_COUNT + 16;
+    this.data[offset + 0] = r/255;
+    this.data[offset + 1] = g/255;
+    this.data[offset + 2] = b/255;
+    this.data[offset + 3] = (a === void null ? 255 : a)/255;
+    this._markDirty(index, 1);
+}
+
+// mark a range of instances as changed after writing to the data array directly
+InstanceBuffer.prototype.update = function(index, count) {
+    this._markDirty(index, count === void null ? 1 : count);
+}
+
+InstanceBuffer.prototype.upload = function() {
+    if (this.resized) {
+        instanceBufferSetData(this.ptr, this.data);
+        this.resized = false;
+    } else if (this.dirtyBegin !== this.dirtyEnd) {
+        var begin = this.dirtyBegin * INSTANCE_FLOAT_COUNT;
+        var end = this.dirtyEnd * INSTANCE_FLOAT_COUNT;
+        instanceBufferUpdateData(this.ptr, this.data.subarray(begin, end), this.dirtyBegin);
+    }
+
+    this.dirtyBegin = 0;
+    this.dirtyEnd = 0;
+}
+
+InstanceBuffer.prototype.delete = function() {
+    instanceBufferDelete(this.ptr);
+    this.ptr = undefined;
+}
@@ -1,7 +1,7 @@
 var lights = {};
 
 var Light = function(index) {
-    if (typeof index != 'number' || index < 0 || index > 4) {
+    if (typeof index != 'number' || index < 0 || index >= lightGetMaxCount()) {
         loggerError("Light index is incorrect. index:" + index);
         return undefined;
     }
@@ -57,3 +57,7 @@ Light.prototype.setPosition = function(x, y, z) {
 Light.prototype.setDirection = function(x, y, z) {
     lightSetDirection(this.index, x, y, z);
 }
+
+Light.prototype.setRange = function(range) {
+    lightSetRange(this.index, range);
+}
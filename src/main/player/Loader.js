@@ -5,6 +5,8 @@ var Loader = function() {
 
     this.scenes = {};
     this.activeScene = void null;
+    // FBOs read outside the tracked render pass inputs, collected by Player
+    this.referencedRenderTargets = void null;
     
     this.timeline = {};
 }
@@ -118,6 +120,7 @@ Loader.prototype.setScene = function(name, settings) {
             }
 
             scene.initFunction = settings.initFunction;
+            scene.renderQueue = settings.renderQueue === true;
         }
 
         if (useFbo) {
@@ -174,6 +177,8 @@ Loader.prototype.processAnimation = function()
         scene.processAnimation();
     }
 
+    this.referencedRenderTargets = void null;
+
     //loggerWarning("Processed script output: " + JSON.stringify(this.activeScene.animationLayers, null, 2));
 }
 
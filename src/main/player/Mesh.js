@@ -34,6 +34,39 @@ Mesh.prototype.addTexCoord = function(uMin, vMin) {
     meshAddTexCoord(this.ptr, uMin, vMin);
 }
 
+Mesh.prototype._toFloat32Array = function(array) {
+    if (array instanceof Float32Array) {
+        return array;
+    }
+
+    return new Float32Array(array);
+}
+
+// Bulk setters replace the whole attribute array with a single native call
+Mesh.prototype.setVertices = function(array) {
+    return meshSetVertices(this.ptr, this._toFloat32Array(array));
+}
+
+Mesh.prototype.setNormals = function(array) {
+    return meshSetNormals(this.ptr, this._toFloat32Array(array));
+}
+
+Mesh.prototype.setTexCoords = function(array) {
+    return meshSetTexCoords(this.ptr, this._toFloat32Array(array));
+}
+
+Mesh.prototype.setColors = function(array) {
+    return meshSetColors(this.ptr, this._toFloat32Array(array));
+}
+
+Mesh.prototype.setIndices = function(array) {
+    if (!(array instanceof Uint16Array) && !(array instanceof Uint32Array)) {
+        array = new Uint32Array(array);
+    }
+
+    return meshSetIndices(this.ptr, array, array.BYTES_PER_ELEMENT);
+}
+
 Mesh.prototype.generate = function() {
     meshGenerate(this.ptr);
 }
@@ -51,3 +84,8 @@ Mesh.prototype.draw = function(begin, end) {
     }
     meshDraw(this.ptr, begin, end);
 }
+
+Mesh.prototype.drawInstanced = function(instanceBuffer) {
+    instanceBuffer.upload();
+    meshDrawInstanced(this.ptr, instanceBuffer.ptr);
+}
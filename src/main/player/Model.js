@@ -4,6 +4,8 @@ var Model = function() {
     this.camera = 'Camera 01';
     this.fps = 0;
     this.clearDepthBuffer = true;
+    this.loading = false;
+    this.loadCallbacks = [];
 }
 
 Model.prototype.load = function(filename) {
@@ -12,6 +14,45 @@ Model.prototype.load = function(filename) {
     this.ptr = legacy.ptr;
 }
 
+Model.prototype.loadAsync = function(filename) {
+    this.filename = filename;
+    this.ptr = undefined;
+    this.loading = loadObjectAsync(this, filename);
+    if (this.loading !== true) {
+        this._callFinalEvents();
+    }
+
+    return this;
+}
+
+Model.prototype.then = function(onLoad, onError) {
+    var callback = {'onLoad':onLoad, 'onError':onError};
+    if (this.loading === true) {
+        this.loadCallbacks.push(callback);
+    } else {
+        this._callLoadCallback(callback);
+    }
+
+    return this;
+}
+
+Model.prototype._callFinalEvents = function() {
+    this.loading = false;
+
+    var callbacks = this.loadCallbacks;
+    this.loadCallbacks = [];
+    for (var i = 0; i < callbacks.length; i++) {
+        this._callLoadCallback(callbacks[i]);
+    }
+}
+
+Model.prototype._callLoadCallback = function(callback) {
+    var func = this.ptr !== undefined ? callback.onLoad : callback.onError;
+    if (typeof(func) === 'function') {
+        func(this);
+    }
+}
+
 Model.prototype.setCameraName = function(cameraName) {
     this.cameraName = cameraName;
 }
@@ -72,5 +113,18 @@ Model.prototype.setColor = function(r, g, b, a) {
 }
 
 Model.prototype.draw = function() {
+    if (this.ptr === undefined) {
+        return;
+    }
+
     drawObject(this.ptr, this.cameraName, this.fps, this.clearDepthBuffer === true ? 1 : 0);
 }
+
+Model.prototype.drawInstanced = function(instanceBuffer) {
+    if (this.ptr === undefined) {
+        return;
+    }
+
+    instanceBuffer.upload();
+    drawObjectInstanced(this.ptr, instanceBuffer.ptr);
+}
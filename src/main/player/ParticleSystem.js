@@ -0,0 +1,70 @@
+var ParticleSystem = function(particleCount) {
+    this.ptr = particleSystemNew(particleCount);
+    if (this.ptr === void null) {
+        loggerFatal("Could not initialize ParticleSystem");
+    }
+}
+
+ParticleSystem.prototype.setEmitRate = function(particlesPerSecond) {
+    particleSystemSetEmitRate(this.ptr, particlesPerSecond);
+}
+
+ParticleSystem.prototype.setLifeTime = function(seconds, randomness) {
+    particleSystemSetLifeTime(this.ptr, seconds, randomness || 0.0);
+}
+
+ParticleSystem.prototype.setPosition = function(x, y, z) {
+    particleSystemSetPosition(this.ptr, x, y, z || 0.0);
+}
+
+ParticleSystem.prototype.setPositionRandomness = function(x, y, z) {
+    particleSystemSetPositionRandomness(this.ptr, x, y, z || 0.0);
+}
+
+ParticleSystem.prototype.setVelocity = function(x, y, z) {
+    particleSystemSetVelocity(this.ptr, x, y, z || 0.0);
+}
+
+ParticleSystem.prototype.setVelocityRandomness = function(x, y, z) {
+    particleSystemSetVelocityRandomness(this.ptr, x, y, z || 0.0);
+}
+
+ParticleSystem.prototype.setGravity = function(x, y, z) {
+    particleSystemSetGravity(this.ptr, x, y, z || 0.0);
+}
+
+ParticleSystem.prototype.setDrag = function(drag) {
+    particleSystemSetDrag(this.ptr, drag);
+}
+
+ParticleSystem.prototype.setStartColor = function(r, g, b, a) {
+    particleSystemSetStartColor(this.ptr, r/255, g/255, b/255, (a === void null ? 255 : a)/255);
+}
+
+ParticleSystem.prototype.setEndColor = function(r, g, b, a) {
+    particleSystemSetEndColor(this.ptr, r/255, g/255, b/255, (a === void null ? 255 : a)/255);
+}
+
+ParticleSystem.prototype.setSize = function(startSize, endSize) {
+    if (endSize === void null) {
+        endSize = startSize;
+    }
+    particleSystemSetSize(this.ptr, startSize, endSize);
+}
+
+ParticleSystem.prototype.setTexture = function(texture) {
+    particleSystemSetTexture(this.ptr, texture === void null ? null : texture.ptr);
+}
+
+ParticleSystem.prototype.reset = function() {
+    particleSystemReset(this.ptr);
+}
+
+ParticleSystem.prototype.draw = function() {
+    particleSystemDraw(this.ptr);
+}
+
+ParticleSystem.prototype.delete = function() {
+    particleSystemDelete(this.ptr);
+    this.ptr = undefined;
+}
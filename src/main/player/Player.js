@@ -1,6 +1,12 @@
 /** @constructor */
 var Player = function()
 {
+    // name of the FBO whose contents are still valid, its rendering is skipped
+    this.skipFboName = void null;
+    // culled state of the render passes of the current frame
+    this.culledRenderPasses = [];
+    // FBO unbound at the end of the previous pass, parent framebuffer is bound only if the next animation doesn't bind an FBO
+    this.pendingFboUnbind = void null;
 };
 
 Player.prototype.calculate3dCoordinateAnimation = function(time, animation, defaults)
@@ -330,6 +336,11 @@ Player.prototype.drawImageAnimation = function(time, animation)
                 multiTexRef.video.ref.setLength(Utils.evaluateVariable(animation, multiTexRef.video.length));
             }
 
+            if (multiTexRef.video.cacheSize !== void null)
+            {
+                multiTexRef.video.ref.setFrameCacheSize(Utils.evaluateVariable(animation, multiTexRef.video.cacheSize));
+            }
+
             if (multiTexRef.video.playing === void null)
             {
                 multiTexRef.video.ref.play();
@@ -397,6 +408,27 @@ Player.prototype.drawTextAnimation = function(time, animation)
         animation.ref.setFont(animation.text.name);
     }
 
+    animation.ref.setSdf(animation.text.sdf === true);
+    if (animation.text.sdf === true)
+    {
+        // widths are given in 64px glyph pixels, shader reads distance field values (0.5 at the glyph edge).
+        // SDF glyphs have 8px padding and edge value 128, so one pixel is 128 / 8 / 255 in distance units.
+        var sdfPixelDistance = 16 / 255;
+        var outline = animation.text.outline || {};
+        animation.ref.setOutline((outline.width || 0) * sdfPixelDistance,
+            outline.r !== void null ? outline.r : 0,
+            outline.g !== void null ? outline.g : 0,
+            outline.b !== void null ? outline.b : 0,
+            outline.a !== void null ? outline.a : 255);
+
+        var glow = animation.text.glow || {};
+        animation.ref.setGlow((glow.width || 0) * sdfPixelDistance,
+            glow.r !== void null ? glow.r : 255,
+            glow.g !== void null ? glow.g : 255,
+            glow.b !== void null ? glow.b : 255,
+            glow.a !== void null ? glow.a : 255);
+    }
+
     var color = this.calculateColorAnimation(time, animation, animation.color);
     animation.ref.setColor(color.r, color.g, color.b, color.a);
 
@@ -510,7 +542,14 @@ Player.prototype.drawObjectAnimation = function(time, animation)
             (new Graphics()).clearDepthBuffer();
         }
 
-        animation.ref.draw();
+        if (animation.instances !== void null)
+        {
+            animation.ref.drawInstanced(animation.instances);
+        }
+        else
+        {
+            animation.ref.draw();
+        }
     }
 
     if (animation.objectFunction !== void null)
@@ -541,6 +580,13 @@ Player.prototype.drawFboAnimation = function(time, animation)
 
     if (animation.fbo.action === 'begin')
     {
+        if (!animation.ref.isUpdateNeeded(time))
+        {
+            this.skipFboName = animation.fbo.name;
+            return;
+        }
+
+        animation.ref.setUpdated(time);
         //loggerInfo("begin: " + animation.ref.ptr);
         animation.ref.bind();
 
@@ -550,7 +596,14 @@ Player.prototype.drawFboAnimation = function(time, animation)
     else if (animation.fbo.action === 'end')
     {
         //loggerInfo("end: " + animation.ref.ptr);
-        animation.ref.unbind();
+        if (this.skipFboName === animation.fbo.name)
+        {
+            this.skipFboName = void null;
+        }
+        else
+        {
+            animation.ref.unbind();
+        }
         //loggerInfo("end: " + JSON.stringify(animation, null, 2));
         animation.ref.updateViewport();
         animation.ref.color.draw();
@@ -573,8 +626,21 @@ Player.prototype.drawFboAnimation = function(time, animation)
     }
     else if (animation.fbo.action === 'unbind')
     {
-        animation.ref.unbind();
-        animation.ref.updateViewport();
+        if (this.skipFboName === animation.fbo.name)
+        {
+            this.skipFboName = void null;
+            return;
+        }
+
+        this.pendingFboUnbind = animation.ref;
+    }
+    else if (animation.fbo.action === 'release')
+    {
+        animation.ref.release();
+    }
+    else if (animation.fbo.action === 'invalidate')
+    {
+        animation.ref.invalidate();
     }
     else if (animation.fbo.action === 'draw')
     {
@@ -646,6 +712,11 @@ Player.prototype.drawLightAnimation = function(time, animation)
         animation.ref.setDirection(direction.x, direction.y, direction.z);
     }
 
+    if (animation.range !== void null)
+    {
+        animation.ref.setRange(animation.range);
+    }
+
     /*
     // FIXME: Fix position handling
     lightSetPositionObject(animation.light.index);
@@ -715,6 +786,7 @@ Player.prototype.drawAnimation = function(loader)
 
     var time = (new Timer()).getTimeInSeconds();
 
+    var activeScenes = [];
     for (var key in timeline)
     {
         var timelineLayer = timeline[key];
@@ -733,11 +805,232 @@ Player.prototype.drawAnimation = function(loader)
                 if (timelineElement.time !== void null) {
                     relativeTime = Utils.evaluateVariable(timelineElement, timelineElement.time);
                 }
-                this.drawSceneAnimation(scenes[sceneName], relativeTime - start);
+                activeScenes.push({'scene': scenes[sceneName], 'time': relativeTime - start});
             }
 
         }
     }
+
+    this.buildRenderGraph(loader, activeScenes);
+
+    for (var i = 0; i < activeScenes.length; i++)
+    {
+        this.drawSceneAnimation(activeScenes[i].scene, activeScenes[i].time);
+    }
+}
+
+// FBOs sampled by the animation
+Player.prototype.getRenderInputs = function(animation)
+{
+    if (animation.renderInputs !== void null)
+    {
+        return animation.renderInputs;
+    }
+
+    var renderInputs = [];
+    if (animation.type === 'image')
+    {
+        var fboSuffixes = ['.color.fbo', '.depth.fbo'];
+        for (var imageI = 0; imageI < animation.image.length; imageI++)
+        {
+            var imageName = animation.image[imageI].name;
+            for (var suffixI = 0; suffixI < fboSuffixes.length; suffixI++)
+            {
+                var suffixIndex = imageName.length - fboSuffixes[suffixI].length;
+                if (suffixIndex > 0 && imageName.indexOf(fboSuffixes[suffixI], suffixIndex) === suffixIndex)
+                {
+                    renderInputs.push(imageName.substring(0, suffixIndex));
+                }
+            }
+        }
+    }
+    else if (animation.type === 'fbo' && (animation.fbo.action === 'draw' || animation.fbo.action === 'end'))
+    {
+        renderInputs.push(animation.fbo.name);
+    }
+
+    animation.renderInputs = renderInputs;
+    return renderInputs;
+}
+
+// strings of an animation definition, any of them may name an FBO
+Player.prototype.collectRenderReferences = function(value, depth, references)
+{
+    if (value === void null || value === null || depth > 8)
+    {
+        return;
+    }
+
+    if (typeof value === 'string')
+    {
+        references.push(value);
+        return;
+    }
+
+    if (typeof value !== 'object')
+    {
+        return;
+    }
+
+    for (var key in value)
+    {
+        // native references, the FBO pass declaration of an object and render graph state don't read FBOs
+        if (value.hasOwnProperty(key) && key !== 'ref' && key !== 'passToFbo' && key !== 'renderInputs' && key !== 'renderPass')
+        {
+            this.collectRenderReferences(value[key], depth + 1, references);
+        }
+    }
+}
+
+// FBOs named anywhere in the animation definitions, other than in the FBO actions and images tracked as pass inputs,
+// may be read by materials, shader variables or other scenes and are treated as read every frame
+Player.prototype.getReferencedRenderTargets = function(loader)
+{
+    if (loader.referencedRenderTargets !== void null)
+    {
+        return loader.referencedRenderTargets;
+    }
+
+    var fboNames = [];
+    var references = [];
+    for (var sceneName in loader.scenes)
+    {
+        var animationLayers = loader.scenes[sceneName].animationLayers;
+        for (var key in animationLayers)
+        {
+            if (animationLayers.hasOwnProperty(key))
+            {
+                for (var animationI = 0; animationI < animationLayers[key].length; animationI++)
+                {
+                    var animation = animationLayers[key][animationI];
+                    if (animation.type === 'fbo')
+                    {
+                        if (fboNames.indexOf(animation.fbo.name) === -1)
+                        {
+                            fboNames.push(animation.fbo.name);
+                        }
+                        continue;
+                    }
+
+                    var animationReferences = [];
+                    this.collectRenderReferences(animation, 0, animationReferences);
+
+                    if (animation.type === 'image' && this.getRenderInputs(animation).length > 0)
+                    {
+                        for (var imageI = 0; imageI < animation.image.length; imageI++)
+                        {
+                            var imageName = animation.image[imageI].name;
+                            var referenceIndex = animationReferences.indexOf(imageName);
+                            if (referenceIndex !== -1 && /\.(color|depth)\.fbo$/.test(imageName))
+                            {
+                                animationReferences.splice(referenceIndex, 1);
+                            }
+                        }
+                    }
+
+                    references = references.concat(animationReferences);
+                }
+            }
+        }
+    }
+
+    var referencedRenderTargets = [];
+    for (var fboI = 0; fboI < fboNames.length; fboI++)
+    {
+        for (var referenceI = 0; referenceI < references.length; referenceI++)
+        {
+            if (references[referenceI].indexOf(fboNames[fboI]) !== -1)
+            {
+                referencedRenderTargets.push(fboNames[fboI]);
+                break;
+            }
+        }
+    }
+
+    loader.referencedRenderTargets = referencedRenderTargets;
+    return referencedRenderTargets;
+}
+
+// declare FBO passes of the frame so that passes not reaching the screen can be culled
+Player.prototype.buildRenderGraph = function(loader, activeScenes)
+{
+    var renderGraph = new RenderGraph();
+    renderGraph.clear();
+
+    var passStack = [{'pass': renderGraph.addPass(''), 'name': ''}];
+
+    var referencedRenderTargets = this.getReferencedRenderTargets(loader);
+    for (var referenceI = 0; referenceI < referencedRenderTargets.length; referenceI++)
+    {
+        renderGraph.addInput(passStack[0].pass, referencedRenderTargets[referenceI]);
+    }
+
+    for (var sceneI = 0; sceneI < activeScenes.length; sceneI++)
+    {
+        var time = activeScenes[sceneI].time;
+        var animationLayers = activeScenes[sceneI].scene.animationLayers;
+        for (var key in animationLayers)
+        {
+            if (animationLayers.hasOwnProperty(key))
+            {
+                var animationLayersLength = animationLayers[key].length;
+                for (var animationI = 0; animationI < animationLayersLength; animationI++)
+                {
+                    var animation = animationLayers[key][animationI];
+                    if (!(time >= animation.start && (animation.end === void null || time < animation.end))
+                        || animation.error !== void null)
+                    {
+                        continue;
+                    }
+
+                    var current = passStack[passStack.length - 1];
+                    if (animation.type === 'fbo')
+                    {
+                        if (animation.fbo.action === 'begin')
+                        {
+                            current = {'pass': renderGraph.addPass(animation.fbo.name, animation.fbo.cull), 'name': animation.fbo.name};
+                            passStack.push(current);
+                        }
+                        else if ((animation.fbo.action === 'unbind' || animation.fbo.action === 'end')
+                            && current.name === animation.fbo.name && passStack.length > 1)
+                        {
+                            // unbind belongs to the FBO pass, drawing the FBO with "end" belongs to the parent pass
+                            passStack.pop();
+                            if (animation.fbo.action === 'end')
+                            {
+                                renderGraph.addInput(passStack[passStack.length - 1].pass, animation.fbo.name);
+                            }
+                            animation.renderPass = current.pass;
+                            continue;
+                        }
+                    }
+
+                    animation.renderPass = current.pass;
+
+                    var renderInputs = this.getRenderInputs(animation);
+                    for (var inputI = 0; inputI < renderInputs.length; inputI++)
+                    {
+                        renderGraph.addInput(current.pass, renderInputs[inputI]);
+                    }
+                }
+            }
+        }
+    }
+
+    this.culledRenderPasses = renderGraph.compile();
+}
+
+// when the next pass binds its FBO right away, switching to the parent framebuffer and clearing it is left to the next pass end
+Player.prototype.unbindPendingFbo = function(nextPassBinds)
+{
+    var fbo = this.pendingFboUnbind;
+    this.pendingFboUnbind = void null;
+
+    fbo.unbind(!nextPassBinds);
+    if (!nextPassBinds)
+    {
+        fbo.updateViewport();
+    }
 }
 
 Player.prototype.drawSceneAnimation = function(scene, time)
@@ -748,6 +1041,13 @@ Player.prototype.drawSceneAnimation = function(scene, time)
     transformationMatrix.push();
     graphics.pushState();
 
+    var renderQueue = void null;
+    if (scene.renderQueue === true)
+    {
+        renderQueue = new RenderQueue();
+        renderQueue.begin();
+    }
+
     var animationLayers = scene.animationLayers;
     for (var key in animationLayers)
     {
@@ -764,6 +1064,36 @@ Player.prototype.drawSceneAnimation = function(scene, time)
                         continue;
                     }
 
+                    // lights and cameras change state that is used by the following passes
+                    if (this.culledRenderPasses[animation.renderPass] === true
+                        && animation.type !== 'light' && animation.type !== 'camera')
+                    {
+                        continue;
+                    }
+
+                    // FBO contents are still valid, skip everything drawn to it
+                    if (this.skipFboName !== void null && !(animation.type === 'fbo' && animation.fbo.name === this.skipFboName
+                        && (animation.fbo.action === 'unbind' || animation.fbo.action === 'end')))
+                    {
+                        continue;
+                    }
+
+                    if (this.pendingFboUnbind !== void null)
+                    {
+                        this.unbindPendingFbo(animation.type === 'fbo' && animation.fbo.action === 'begin'
+                            && animation.ref.isUpdateNeeded(time));
+                    }
+
+                    if (renderQueue !== void null)
+                    {
+                        // only consecutive object draws are reordered, other animations change state the queued draws depend on
+                        if (animation.type !== 'object')
+                        {
+                            renderQueue.flush();
+                        }
+                        renderQueue.setTransparent(animation.transparent === true);
+                    }
+
                     graphics.setColor(1,1,1,1);
                     Sync.calculateAnimationSync(time, animation);
 
@@ -826,6 +1156,18 @@ Player.prototype.drawSceneAnimation = function(scene, time)
         }
     }
 
+    if (this.pendingFboUnbind !== void null)
+    {
+        this.unbindPendingFbo(false);
+    }
+
+    this.skipFboName = void null;
+
+    if (renderQueue !== void null)
+    {
+        renderQueue.end();
+    }
+
     graphics.popState();
     transformationMatrix.pop();
 }
@@ -0,0 +1,19 @@
+var RenderGraph = function() {
+}
+
+RenderGraph.prototype.clear = function() {
+    renderGraphClear();
+}
+
+RenderGraph.prototype.addPass = function(output, cullable) {
+    return renderGraphAddPass(output, cullable === false ? 0 : 1);
+}
+
+RenderGraph.prototype.addInput = function(pass, input) {
+    renderGraphAddInput(pass, input);
+}
+
+// returns culled state of each pass
+RenderGraph.prototype.compile = function() {
+    return renderGraphCompile();
+}
@@ -0,0 +1,21 @@
+var RenderQueue = function() {
+}
+
+// mesh draws are deferred and submitted sorted by shader program, material, texture and depth
+RenderQueue.prototype.begin = function() {
+    renderQueueBegin();
+}
+
+RenderQueue.prototype.end = function() {
+    renderQueueEnd();
+}
+
+// submit queued draws, needed before changing GL state directly through gl.* functions
+RenderQueue.prototype.flush = function() {
+    renderQueueFlush();
+}
+
+// transparent draws are submitted after opaque draws in the recorded order
+RenderQueue.prototype.setTransparent = function(transparent) {
+    renderQueueSetTransparent(transparent === true ? 1 : 0);
+}
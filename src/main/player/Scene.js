@@ -22,6 +22,19 @@ Scene.prototype.validateResourceLoaded = function(animationDefinition, animation
     return true;
 };
 
+Scene.prototype.modelLoaded = function(animationDefinition)
+{
+    if (this.validateResourceLoaded(animationDefinition, animationDefinition.ref,
+        'Could not load ' + animationDefinition.object))
+    {
+        animationDefinition.ref.setLighting(animationDefinition.objectLighting);
+        animationDefinition.ref.setSimpleColors(animationDefinition.simpleColors);
+        animationDefinition.ref.setCamera(animationDefinition.objectCamera);
+    }
+
+    this.loader.notifyResourceLoaded(animationDefinition.object);
+};
+
 Scene.prototype.setAnimationError = function(animationDefinition, errorType, errorMessage)
 {
     windowSetTitle(errorType + ' ERROR');
@@ -339,6 +352,9 @@ Scene.prototype.addAnimation = function(animationDefinitions)
             animationLayers[animationDefinition.layer] = new Array();
         }
 
+        // transient intermediate FBO that can be released after this animation has been drawn
+        var releaseFboName = void null;
+
         if (animationDefinition.shader !== void null)
         {
             /*
@@ -392,8 +408,14 @@ Scene.prototype.addAnimation = function(animationDefinitions)
 
                     if (i < animationDefinition.shader.length - 1)
                     {
+                        // intermediate passes only live until the next pass has been drawn
                         animationDefinitionDuplicate.passToFbo.name += '_pass_' + i;
+                        animationDefinitionDuplicate.passToFbo.transient = true;
                         this.addAnimation([animationDefinitionDuplicate]);
+                        if (previousFboName !== void null)
+                        {
+                            this.addFboReleaseAnimation(animationDefinition, previousFboName);
+                        }
                     }
                     else
                     {
@@ -406,6 +428,8 @@ Scene.prototype.addAnimation = function(animationDefinitions)
                         {
                             animationDefinition.image = animationDefinitionDuplicate.image;
                         }
+
+                        releaseFboName = previousFboName;
                     }
 
                     previousFboName = animationDefinitionDuplicate.passToFbo.name;
@@ -449,6 +473,12 @@ Scene.prototype.addAnimation = function(animationDefinitions)
                 fboAnimationDefinition.layer = animationDefinition.passToFbo.beginLayer;
             }
             fboAnimationDefinition.fbo.name = animationDefinition.passToFbo.name;
+            fboAnimationDefinition.fbo.transient = animationDefinition.passToFbo.transient;
+            fboAnimationDefinition.fbo.scale = animationDefinition.passToFbo.scale;
+            fboAnimationDefinition.fbo.mipmap = animationDefinition.passToFbo.mipmap;
+            fboAnimationDefinition.fbo.updateInterval = animationDefinition.passToFbo.updateInterval;
+            fboAnimationDefinition.fbo.static = animationDefinition.passToFbo.static;
+            fboAnimationDefinition.fbo.cull = animationDefinition.passToFbo.cull;
             fboAnimationDefinition.fbo.action = 'begin';
             if (animationDefinition.passToFbo.beginAction !== void null)
             {
@@ -504,6 +534,9 @@ Scene.prototype.addAnimation = function(animationDefinitions)
                 fboAnimationDefinition.layer = animationDefinition.passToFbo.endLayer;
             }
             fboAnimationDefinition.fbo.name = animationDefinition.passToFbo.name;
+            fboAnimationDefinition.fbo.transient = animationDefinition.passToFbo.transient;
+            fboAnimationDefinition.fbo.scale = animationDefinition.passToFbo.scale;
+            fboAnimationDefinition.fbo.mipmap = animationDefinition.passToFbo.mipmap;
             fboAnimationDefinition.fbo.action = 'unbind';
             if (animationDefinition.passToFbo.endAction !== void null)
             {
@@ -512,11 +545,41 @@ Scene.prototype.addAnimation = function(animationDefinitions)
 
             this.addAnimation([fboAnimationDefinition]);
         }
+
+        if (releaseFboName !== void null)
+        {
+            this.addFboReleaseAnimation(animationDefinition, releaseFboName);
+        }
     }
 
     this.animationLayers = this.loader.sortArray(animationLayers);
 };
 
+Scene.prototype.addFboReleaseAnimation = function(animationDefinition, fboName)
+{
+    var fboAnimationDefinition = {'fbo': {}};
+
+    if (animationDefinition.start !== void null)
+    {
+        fboAnimationDefinition.start = animationDefinition.start;
+    }
+    if (animationDefinition.end !== void null)
+    {
+        fboAnimationDefinition.end = animationDefinition.end;
+    }
+    if (animationDefinition.duration !== void null)
+    {
+        fboAnimationDefinition.duration = animationDefinition.duration;
+    }
+
+    fboAnimationDefinition.layer = animationDefinition.layer;
+    fboAnimationDefinition.fbo.name = fboName;
+    fboAnimationDefinition.fbo.transient = true;
+    fboAnimationDefinition.fbo.action = 'release';
+
+    this.addAnimation([fboAnimationDefinition]);
+};
+
 Scene.prototype.processAnimation = function()
 {
     var graphics = new Graphics();
@@ -671,15 +734,14 @@ Scene.prototype.processAnimation = function()
                         }
                         else
                         {
-                            animationDefinition.ref.load(animationDefinition.object);
+                            // model is imported in background, loading finishes in processFutures()
+                            var modelLoaded = this.modelLoaded.bind(this, animationDefinition);
+                            animationDefinition.ref.loadAsync(animationDefinition.object).then(modelLoaded, modelLoaded);
                         }
 
-                        if (this.validateResourceLoaded(animationDefinition, animationDefinition.ref,
-                            'Could not load ' + animationDefinition.object))
+                        if (animationDefinition.shape !== void null)
                         {
-                            animationDefinition.ref.setLighting(animationDefinition.objectLighting);
-                            animationDefinition.ref.setSimpleColors(animationDefinition.simpleColors);
-                            animationDefinition.ref.setCamera(animationDefinition.objectCamera);
+                            this.modelLoaded(animationDefinition);
                         }
                     }
 
@@ -712,7 +774,6 @@ Scene.prototype.processAnimation = function()
                         }
                     }
 
-                    this.loader.notifyResourceLoaded(animationDefinition.object);
                 }
                 else if (animationDefinition.image !== void null)
                 {
@@ -828,11 +889,20 @@ Scene.prototype.processAnimation = function()
                     }
 
                     animationDefinition.ref = new Fbo();
-                    animationDefinition.ref.init(animationDefinition.fbo.name);
+                    animationDefinition.ref.init(animationDefinition.fbo.name, animationDefinition.fbo.transient, animationDefinition.fbo.scale, animationDefinition.fbo.mipmap);
 
                     if (this.validateResourceLoaded(animationDefinition, animationDefinition.ref,
                         'Could not load ' + animationDefinition.fbo.name))
                     {
+                        if (animationDefinition.fbo.static === true)
+                        {
+                            animationDefinition.ref.setUpdateInterval(-1.0);
+                        }
+                        else if (animationDefinition.fbo.updateInterval !== void null)
+                        {
+                            animationDefinition.ref.setUpdateInterval(animationDefinition.fbo.updateInterval);
+                        }
+
                         if (animationDefinition.ref.id === 0)
                         {
                             animationDefinition.ref.setStoreDepth(animationDefinition.fbo.storeDepth);
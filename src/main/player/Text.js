@@ -41,6 +41,18 @@ Text.prototype.setPerspective2d = function(perspective2d) {
     setTextPerspective3d(perspective2d === true ? 0 : 1);
 }
 
+Text.prototype.setSdf = function(sdf) {
+    setTextSdf(sdf === true ? 1 : 0);
+}
+
+Text.prototype.setOutline = function(width, r, g, b, a) {
+    setTextOutline(width, r, g, b, a);
+}
+
+Text.prototype.setGlow = function(width, r, g, b, a) {
+    setTextGlow(width, r, g, b, a);
+}
+
 Text.prototype.draw = function() {
     drawText();
 }
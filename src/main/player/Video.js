@@ -31,6 +31,10 @@ Video.prototype.setLength = function(length) {
     videoSetLength(this.ptr, length);
 }
 
+Video.prototype.setFrameCacheSize = function(frameCacheSize) {
+    videoSetFrameCacheSize(this.ptr, frameCacheSize);
+}
+
 Video.prototype.play = function() {
     videoPlay(this.ptr);
 }
@@ -24,8 +24,13 @@
 #include "graphics/Image.h"
 #include "graphics/video/VideoFile.h"
 #include "graphics/model/Model.h"
+#include "graphics/model/ModelLoader.h"
+#include "graphics/model/InstanceBuffer.h"
 #include "graphics/Fbo.h"
+#include "graphics/RenderGraph.h"
+#include "graphics/RenderQueue.h"
 #include "graphics/model/TexturedQuad.h"
+#include "graphics/ParticleSystem.h"
 #include "graphics/Shader.h"
 #include "graphics/ShaderProgram.h"
 #include "graphics/ShaderProgramOpenGl.h"
@@ -49,6 +54,7 @@
 #include <memory>
 #include <future>
 #include <chrono>
+#include <cstdint>
 
 static std::vector<std::unique_ptr<TexturedQuad>> texturedQuads; // FIXME: Don't like this...
 
@@ -302,6 +308,41 @@ static int duk_setTextColor(duk_context *ctx)
     return 0;
 }
 
+static int duk_setTextSdf(duk_context *ctx)
+{
+    unsigned int sdf = (unsigned int)duk_get_uint(ctx, 0);
+
+    text.setSdf(sdf == 1 ? true : false);
+
+    return 0;
+}
+
+static int duk_setTextOutline(duk_context *ctx)
+{
+    double width = (double)duk_get_number(ctx, 0);
+    double r = (double)duk_get_number(ctx, 1)/255.0;
+    double g = (double)duk_get_number(ctx, 2)/255.0;
+    double b = (double)duk_get_number(ctx, 3)/255.0;
+    double a = (double)duk_get_number(ctx, 4)/255.0;
+
+    text.setOutline(width, r, g, b, a);
+
+    return 0;
+}
+
+static int duk_setTextGlow(duk_context *ctx)
+{
+    double width = (double)duk_get_number(ctx, 0);
+    double r = (double)duk_get_number(ctx, 1)/255.0;
+    double g = (double)duk_get_number(ctx, 2)/255.0;
+    double b = (double)duk_get_number(ctx, 3)/255.0;
+    double a = (double)duk_get_number(ctx, 4)/255.0;
+
+    text.setGlow(width, r, g, b, a);
+
+    return 0;
+}
+
 static int duk_setTextSize(duk_context *ctx)
 {
     double x = (double)duk_get_number(ctx, 0);
@@ -570,6 +611,302 @@ static int duk_meshAddNormal(duk_context *ctx)
     return 0;  // no return value
 }
 
+static int duk_meshSetFloatArray(duk_context *ctx, bool (Mesh::*setter)(const float*, size_t))
+{
+    Mesh *mesh = (Mesh*)duk_get_pointer(ctx, 0);
+    duk_size_t arraySize = 0;
+    const float *array = (const float*)duk_get_buffer_data(ctx, 1, &arraySize);
+    if (array == NULL && arraySize > 0) {
+        loggerError("Expected Float32Array for mesh data. mesh:'%s'", mesh->getName().c_str());
+        duk_push_boolean(ctx, 0);
+        return 1;
+    }
+
+    bool ret = (mesh->*setter)(array, arraySize / sizeof(float));
+
+    duk_push_boolean(ctx, ret ? 1 : 0);
+    return 1;
+}
+
+static int duk_meshSetVertices(duk_context *ctx)
+{
+    return duk_meshSetFloatArray(ctx, &Mesh::setVertices);
+}
+
+static int duk_meshSetNormals(duk_context *ctx)
+{
+    return duk_meshSetFloatArray(ctx, &Mesh::setNormals);
+}
+
+static int duk_meshSetTexCoords(duk_context *ctx)
+{
+    return duk_meshSetFloatArray(ctx, &Mesh::setTexCoords);
+}
+
+static int duk_meshSetColors(duk_context *ctx)
+{
+    return duk_meshSetFloatArray(ctx, &Mesh::setColors);
+}
+
+static int duk_meshSetIndices(duk_context *ctx)
+{
+    Mesh *mesh = (Mesh*)duk_get_pointer(ctx, 0);
+    duk_size_t arraySize = 0;
+    void *array = duk_get_buffer_data(ctx, 1, &arraySize);
+    unsigned int bytesPerIndex = duk_get_uint(ctx, 2);
+
+    if (bytesPerIndex == sizeof(unsigned short)) {
+        mesh->setIndices((const unsigned short*)array, arraySize / sizeof(unsigned short));
+    } else if (bytesPerIndex == sizeof(unsigned int)) {
+        mesh->setIndices((const unsigned int*)array, arraySize / sizeof(unsigned int));
+    } else {
+        loggerError("Expected Uint16Array or Uint32Array for mesh indices. mesh:'%s', bytesPerIndex:%u", mesh->getName().c_str(), bytesPerIndex);
+        duk_push_boolean(ctx, 0);
+        return 1;
+    }
+
+    duk_push_boolean(ctx, 1);
+    return 1;
+}
+
+static int duk_meshDrawInstanced(duk_context *ctx)
+{
+    Mesh *mesh = (Mesh*)duk_get_pointer(ctx, 0);
+    InstanceBuffer *instanceBuffer = (InstanceBuffer*)duk_get_pointer(ctx, 1);
+
+    mesh->drawInstanced(instanceBuffer);
+
+    return 0;
+}
+
+static int duk_instanceBufferNew(duk_context *ctx)
+{
+    InstanceBuffer *instanceBuffer = new InstanceBuffer();
+
+    duk_push_pointer(ctx, (void*)instanceBuffer);
+    return 1;
+}
+
+static int duk_instanceBufferDelete(duk_context *ctx)
+{
+    InstanceBuffer *instanceBuffer = (InstanceBuffer*)duk_get_pointer(ctx, 0);
+
+    delete instanceBuffer;
+
+    return 0;
+}
+
+static int duk_instanceBufferSetData(duk_context *ctx)
+{
+    InstanceBuffer *instanceBuffer = (InstanceBuffer*)duk_get_pointer(ctx, 0);
+    duk_size_t arraySize = 0;
+    const float *array = (const float*)duk_get_buffer_data(ctx, 1, &arraySize);
+    unsigned int instanceCount = arraySize / (INSTANCE_FLOAT_COUNT * sizeof(float));
+
+    bool ret = instanceBuffer->setData(array, instanceCount);
+
+    duk_push_boolean(ctx, ret ? 1 : 0);
+    return 1;
+}
+
+static int duk_instanceBufferUpdateData(duk_context *ctx)
+{
+    InstanceBuffer *instanceBuffer = (InstanceBuffer*)duk_get_pointer(ctx, 0);
+    duk_size_t arraySize = 0;
+    const float *array = (const float*)duk_get_buffer_data(ctx, 1, &arraySize);
+    unsigned int firstInstance = duk_get_uint(ctx, 2);
+    unsigned int instanceCount = arraySize / (INSTANCE_FLOAT_COUNT * sizeof(float));
+
+    bool ret = instanceBuffer->updateData(array, firstInstance, instanceCount);
+
+    duk_push_boolean(ctx, ret ? 1 : 0);
+    return 1;
+}
+
+static int duk_instanceBufferGetInstanceCount(duk_context *ctx)
+{
+    InstanceBuffer *instanceBuffer = (InstanceBuffer*)duk_get_pointer(ctx, 0);
+
+    duk_push_uint(ctx, instanceBuffer->getInstanceCount());
+    return 1;
+}
+
+static int duk_particleSystemNew(duk_context *ctx)
+{
+    unsigned int particleCount = duk_get_uint(ctx, 0);
+    ParticleSystem *particleSystem = new ParticleSystem(particleCount);
+
+    duk_push_pointer(ctx, (void*)particleSystem);
+    return 1;
+}
+
+static int duk_particleSystemDelete(duk_context *ctx)
+{
+    ParticleSystem *particleSystem = (ParticleSystem*)duk_get_pointer(ctx, 0);
+
+    delete particleSystem;
+
+    return 0;
+}
+
+static int duk_particleSystemDraw(duk_context *ctx)
+{
+    ParticleSystem *particleSystem = (ParticleSystem*)duk_get_pointer(ctx, 0);
+
+    Timer &timer = EnginePlayer::getInstance().getTimer();
+    particleSystem->update(timer.getTimeInSeconds());
+    particleSystem->draw();
+
+    return 0;
+}
+
+static int duk_particleSystemReset(duk_context *ctx)
+{
+    ParticleSystem *particleSystem = (ParticleSystem*)duk_get_pointer(ctx, 0);
+
+    particleSystem->reset();
+
+    return 0;
+}
+
+static int duk_particleSystemSetEmitRate(duk_context *ctx)
+{
+    ParticleSystem *particleSystem = (ParticleSystem*)duk_get_pointer(ctx, 0);
+    double particlesPerSecond = duk_get_number(ctx, 1);
+
+    particleSystem->setEmitRate(particlesPerSecond);
+
+    return 0;
+}
+
+static int duk_particleSystemSetLifeTime(duk_context *ctx)
+{
+    ParticleSystem *particleSystem = (ParticleSystem*)duk_get_pointer(ctx, 0);
+    double seconds = duk_get_number(ctx, 1);
+    double randomness = duk_get_number(ctx, 2);
+
+    particleSystem->setLifeTime(seconds, randomness);
+
+    return 0;
+}
+
+static int duk_particleSystemSetPosition(duk_context *ctx)
+{
+    ParticleSystem *particleSystem = (ParticleSystem*)duk_get_pointer(ctx, 0);
+    double x = duk_get_number(ctx, 1);
+    double y = duk_get_number(ctx, 2);
+    double z = duk_get_number(ctx, 3);
+
+    particleSystem->setPosition(x, y, z);
+
+    return 0;
+}
+
+static int duk_particleSystemSetPositionRandomness(duk_context *ctx)
+{
+    ParticleSystem *particleSystem = (ParticleSystem*)duk_get_pointer(ctx, 0);
+    double x = duk_get_number(ctx, 1);
+    double y = duk_get_number(ctx, 2);
+    double z = duk_get_number(ctx, 3);
+
+    particleSystem->setPositionRandomness(x, y, z);
+
+    return 0;
+}
+
+static int duk_particleSystemSetVelocity(duk_context *ctx)
+{
+    ParticleSystem *particleSystem = (ParticleSystem*)duk_get_pointer(ctx, 0);
+    double x = duk_get_number(ctx, 1);
+    double y = duk_get_number(ctx, 2);
+    double z = duk_get_number(ctx, 3);
+
+    particleSystem->setVelocity(x, y, z);
+
+    return 0;
+}
+
+static int duk_particleSystemSetVelocityRandomness(duk_context *ctx)
+{
+    ParticleSystem *particleSystem = (ParticleSystem*)duk_get_pointer(ctx, 0);
+    double x = duk_get_number(ctx, 1);
+    double y = duk_get_number(ctx, 2);
+    double z = duk_get_number(ctx, 3);
+
+    particleSystem->setVelocityRandomness(x, y, z);
+
+    return 0;
+}
+
+static int duk_particleSystemSetGravity(duk_context *ctx)
+{
+    ParticleSystem *particleSystem = (ParticleSystem*)duk_get_pointer(ctx, 0);
+    double x = duk_get_number(ctx, 1);
+    double y = duk_get_number(ctx, 2);
+    double z = duk_get_number(ctx, 3);
+
+    particleSystem->setGravity(x, y, z);
+
+    return 0;
+}
+
+static int duk_particleSystemSetDrag(duk_context *ctx)
+{
+    ParticleSystem *particleSystem = (ParticleSystem*)duk_get_pointer(ctx, 0);
+    double drag = duk_get_number(ctx, 1);
+
+    particleSystem->setDrag(drag);
+
+    return 0;
+}
+
+static int duk_particleSystemSetStartColor(duk_context *ctx)
+{
+    ParticleSystem *particleSystem = (ParticleSystem*)duk_get_pointer(ctx, 0);
+    double r = duk_get_number(ctx, 1);
+    double g = duk_get_number(ctx, 2);
+    double b = duk_get_number(ctx, 3);
+    double a = duk_get_number(ctx, 4);
+
+    particleSystem->setStartColor(r, g, b, a);
+
+    return 0;
+}
+
+static int duk_particleSystemSetEndColor(duk_context *ctx)
+{
+    ParticleSystem *particleSystem = (ParticleSystem*)duk_get_pointer(ctx, 0);
+    double r = duk_get_number(ctx, 1);
+    double g = duk_get_number(ctx, 2);
+    double b = duk_get_number(ctx, 3);
+    double a = duk_get_number(ctx, 4);
+
+    particleSystem->setEndColor(r, g, b, a);
+
+    return 0;
+}
+
+static int duk_particleSystemSetSize(duk_context *ctx)
+{
+    ParticleSystem *particleSystem = (ParticleSystem*)duk_get_pointer(ctx, 0);
+    double startSize = duk_get_number(ctx, 1);
+    double endSize = duk_get_number(ctx, 2);
+
+    particleSystem->setSize(startSize, endSize);
+
+    return 0;
+}
+
+static int duk_particleSystemSetTexture(duk_context *ctx)
+{
+    ParticleSystem *particleSystem = (ParticleSystem*)duk_get_pointer(ctx, 0);
+    TexturedQuad *tex = (TexturedQuad*)duk_get_pointer(ctx, 1);
+
+    particleSystem->setTexture(tex ? tex->getTexture() : NULL);
+
+    return 0;
+}
+
 static duk_idx_t duk_push_shader_program_object(duk_context *ctx, ShaderProgram *shaderProgram)
 {
     assert(ctx != NULL);
@@ -753,6 +1090,9 @@ static int duk_glUniformf(duk_context *ctx)
         return 0;
     }
 
+    // queued draws must be submitted with the previous uniform values
+    RenderQueue::getInstance().flush();
+
     unsigned int uniformLocation = (unsigned int)duk_get_uint(ctx, 0);
     float value1 = 0.0f;
     float value2 = 0.0f;
@@ -803,6 +1143,9 @@ static int duk_glUniformi(duk_context *ctx)
         return 0;
     }
 
+    // queued draws must be submitted with the previous uniform values
+    RenderQueue::getInstance().flush();
+
     unsigned int uniformLocation = (unsigned int)duk_get_uint(ctx, 0);
     int value1 = 0;
     int value2 = 0;
@@ -1074,6 +1417,72 @@ static int duk_loadObject(duk_context *ctx)
     return 1;
 }
 
+struct ModelLoadCall {
+    void *jsHeapAddress;
+    Model *model;
+};
+
+static std::vector<ModelLoadCall> modelLoadCalls = std::vector<ModelLoadCall>();
+static int duk_loadObjectAsync(duk_context *ctx)
+{
+    void *ptr = duk_get_heapptr(ctx, 0);
+    const char *filename = duk_get_string(ctx, 1);
+
+    MemoryManager<Model>& memory = MemoryManager<Model>::getInstance();
+    Model *model = memory.getResource(std::string(filename));
+
+    if (model == NULL || model->getError() || !ModelLoader::getInstance().load(model)) {
+        duk_push_boolean(ctx, 0);
+        return 1;
+    }
+
+    // keep the JS object reachable until the load has been processed
+    duk_push_heap_stash(ctx);
+    duk_dup(ctx, 0);
+    duk_put_prop_string(ctx, -2, ("_modelLoad" + std::to_string(reinterpret_cast<uintptr_t>(ptr))).c_str());
+    duk_pop(ctx);
+
+    ModelLoadCall modelLoadCall;
+    modelLoadCall.jsHeapAddress = ptr;
+    modelLoadCall.model = model;
+    modelLoadCalls.push_back(modelLoadCall);
+
+    duk_push_boolean(ctx, 1);
+    return 1;
+}
+
+static void processModelLoadCalls(duk_context *ctx)
+{
+    auto it = modelLoadCalls.begin();
+    while (it != modelLoadCalls.end())
+    {
+        ModelLoadCall modelLoadCall = *it;
+        if (ModelLoader::getInstance().isLoading(modelLoadCall.model)) {
+            ++it;
+            continue;
+        }
+
+        it = modelLoadCalls.erase(it);
+
+        duk_push_heapptr(ctx, modelLoadCall.jsHeapAddress);
+
+        if (modelLoadCall.model->isLoaded() && !modelLoadCall.model->getError()) {
+            duk_push_pointer(ctx, (void*)modelLoadCall.model);
+            duk_put_prop_string(ctx, -2, "ptr");
+            duk_push_string(ctx, modelLoadCall.model->getFilePath().c_str());
+            duk_put_prop_string(ctx, -2, "filename");
+        }
+
+        duk_push_string(ctx, "_callFinalEvents");
+        duk_call_prop(ctx, -2, 0);
+        duk_pop_2(ctx);
+
+        duk_push_heap_stash(ctx);
+        duk_del_prop_string(ctx, -1, ("_modelLoad" + std::to_string(reinterpret_cast<uintptr_t>(modelLoadCall.jsHeapAddress))).c_str());
+        duk_pop(ctx);
+    }
+}
+
 static int duk_drawObject(duk_context *ctx)
 {
     int argc = duk_get_top(ctx);
@@ -1104,6 +1513,16 @@ static int duk_drawObject(duk_context *ctx)
     return 0;
 }
 
+static int duk_drawObjectInstanced(duk_context *ctx)
+{
+    Model *model = (Model*)duk_get_pointer(ctx, 0);
+    InstanceBuffer *instanceBuffer = (InstanceBuffer*)duk_get_pointer(ctx, 1);
+
+    model->drawInstanced(instanceBuffer);
+
+    return 0;
+}
+
 //getWindowScreenAreaAspectRatio
 static int duk_getCameraAspectRatio(duk_context *ctx)
 {
@@ -1234,6 +1653,24 @@ static int duk_lightSetDirection(duk_context *ctx)
     return 0;
 }
 
+static int duk_lightSetRange(duk_context *ctx)
+{
+    unsigned int lightIndex = (unsigned int)duk_get_uint(ctx, 0);
+    double range = (double)duk_get_number(ctx, 1);
+
+    Light& light = LightManager::getInstance().getLight(lightIndex);
+    light.setRange(range);
+
+    return 0;
+}
+
+static int duk_lightGetMaxCount(duk_context *ctx)
+{
+    duk_push_uint(ctx, Settings::demo.graphics.maxActiveLightCount);
+
+    return 1;
+}
+
 static int duk_lightSetOn(duk_context *ctx)
 {
     unsigned int lightIndex = (unsigned int)duk_get_uint(ctx, 0);
@@ -1390,6 +1827,17 @@ loggerInfo("tried to set length %.2f", length);
     return 0;
 }
 
+static int duk_videoSetFrameCacheSize(duk_context *ctx)
+{
+    TexturedQuad *tex = (TexturedQuad*)duk_get_pointer(ctx, 0);
+    unsigned int frameCacheSize = static_cast<unsigned int>(duk_get_uint(ctx, 1));
+
+    VideoFile* video = reinterpret_cast<VideoFile*>(tex->getParent());
+    video->setFrameCacheSize(frameCacheSize);
+
+    return 0;
+}
+
 static int duk_videoPlay(duk_context *ctx)
 {
     TexturedQuad *tex = (TexturedQuad*)duk_get_pointer(ctx, 0);
@@ -1658,10 +2106,17 @@ static std::map<std::string, TexturedQuad*> texturedQuadMap;
 static int duk_fboInit(duk_context *ctx)
 {
     const char *name = duk_get_string(ctx, 0);
+    unsigned int transient = (unsigned int)duk_get_uint(ctx, 1);
+    double scale = duk_is_number(ctx, 2) ? (double)duk_get_number(ctx, 2) : 1.0;
+    unsigned int mipmap = (unsigned int)duk_get_uint(ctx, 3);
 
     MemoryManager<Fbo>& fboMemory = MemoryManager<Fbo>::getInstance();
     Fbo *fbo = fboMemory.getResource(std::string(name));
     if (fbo->getColorTexture() == NULL) {
+        fbo->setTransient(transient == 1 ? true : false);
+        fbo->setScale(scale);
+        fbo->setMipmap(mipmap == 1 ? true : false);
+        fbo->setDynamicScale(true);
         fbo->generate();
         //fboTexturedQuad = std::unique_ptr<TexturedQuad>(TexturedQuad::newInstance(fbo));
         //fboTexturedQuad->init();
@@ -1700,8 +2155,130 @@ static int duk_fboBind(duk_context *ctx)
 }
 static int duk_fboUnbind(duk_context *ctx)
 {
+    int argc = duk_get_top(ctx);
     Fbo* fbo = (Fbo*)duk_get_pointer(ctx, 0);
-    fbo->unbind();
+    bool bindParent = true;
+    if (argc > 1) {
+        bindParent = duk_get_int(ctx, 1) == 1 ? true : false;
+    }
+    fbo->unbind(bindParent);
+
+    return 0;
+}
+
+static int duk_fboRelease(duk_context *ctx)
+{
+    Fbo* fbo = (Fbo*)duk_get_pointer(ctx, 0);
+    fbo->release();
+
+    return 0;
+}
+
+static int duk_renderGraphClear(duk_context *ctx)
+{
+    RenderGraph::getInstance().clear();
+
+    return 0;
+}
+
+static int duk_renderGraphAddPass(duk_context *ctx)
+{
+    const char *output = duk_get_string(ctx, 0);
+    unsigned int cullable = (unsigned int)duk_get_uint(ctx, 1);
+
+    duk_push_uint(ctx, RenderGraph::getInstance().addPass(std::string(output ? output : ""), cullable == 1 ? true : false));
+
+    return 1;
+}
+
+static int duk_renderGraphAddInput(duk_context *ctx)
+{
+    unsigned int pass = (unsigned int)duk_get_uint(ctx, 0);
+    const char *input = duk_get_string(ctx, 1);
+
+    RenderGraph::getInstance().addInput(pass, std::string(input ? input : ""));
+
+    return 0;
+}
+
+static int duk_renderGraphCompile(duk_context *ctx)
+{
+    RenderGraph& renderGraph = RenderGraph::getInstance();
+    renderGraph.compile();
+
+    duk_idx_t arr_idx = duk_push_array(ctx);
+    for (unsigned int i = 0; i < renderGraph.getPassCount(); i++) {
+        duk_push_boolean(ctx, renderGraph.isCulled(i) ? 1 : 0);
+        duk_put_prop_index(ctx, arr_idx, i);
+    }
+
+    return 1;
+}
+
+static int duk_renderQueueBegin(duk_context *ctx)
+{
+    RenderQueue::getInstance().begin();
+
+    return 0;
+}
+
+static int duk_renderQueueEnd(duk_context *ctx)
+{
+    RenderQueue::getInstance().end();
+
+    return 0;
+}
+
+static int duk_renderQueueFlush(duk_context *ctx)
+{
+    RenderQueue::getInstance().flush();
+
+    return 0;
+}
+
+static int duk_renderQueueSetTransparent(duk_context *ctx)
+{
+    unsigned int transparent = (unsigned int)duk_get_uint(ctx, 0);
+
+    RenderQueue::getInstance().setTransparent(transparent == 1 ? true : false);
+
+    return 0;
+}
+
+static int duk_fboSetUpdateInterval(duk_context *ctx)
+{
+    Fbo* fbo = (Fbo*)duk_get_pointer(ctx, 0);
+    double updateInterval = (double)duk_get_number(ctx, 1);
+
+    fbo->setUpdateInterval(updateInterval);
+
+    return 0;
+}
+
+static int duk_fboIsUpdateNeeded(duk_context *ctx)
+{
+    Fbo* fbo = (Fbo*)duk_get_pointer(ctx, 0);
+    double time = (double)duk_get_number(ctx, 1);
+
+    duk_push_boolean(ctx, fbo->isUpdateNeeded(time) ? 1 : 0);
+
+    return 1;
+}
+
+static int duk_fboSetUpdated(duk_context *ctx)
+{
+    Fbo* fbo = (Fbo*)duk_get_pointer(ctx, 0);
+    double time = (double)duk_get_number(ctx, 1);
+
+    fbo->setUpdated(time);
+
+    return 0;
+}
+
+static int duk_fboInvalidate(duk_context *ctx)
+{
+    Fbo* fbo = (Fbo*)duk_get_pointer(ctx, 0);
+    fbo->invalidate();
 
     return 0;
 }
@@ -2500,6 +3077,8 @@ CurlCall::CurlCall() {
 static std::vector<std::future<CurlCall*>> curlFutures = std::vector<std::future<CurlCall*>>();
 static int duk_processFutures(duk_context *ctx)
 {
+    processModelLoadCalls(ctx);
+
     auto it = curlFutures.begin();
     while (it != curlFutures.end())
     {
@@ -3365,6 +3944,33 @@ void ScriptEngineDuktape::bindFunctions()
     bindCFunctionToJs(meshAddVertex, 4);
     bindCFunctionToJs(meshAddTexCoord, 3);
     bindCFunctionToJs(meshAddNormal, 4);
+    bindCFunctionToJs(meshSetVertices, 2);
+    bindCFunctionToJs(meshSetNormals, 2);
+    bindCFunctionToJs(meshSetTexCoords, 2);
+    bindCFunctionToJs(meshSetColors, 2);
+    bindCFunctionToJs(meshSetIndices, 3);
+    bindCFunctionToJs(meshDrawInstanced, 2);
+    bindCFunctionToJs(instanceBufferNew, 0);
+    bindCFunctionToJs(instanceBufferDelete, 1);
+    bindCFunctionToJs(instanceBufferSetData, 2);
+    bindCFunctionToJs(instanceBufferUpdateData, 3);
+    bindCFunctionToJs(instanceBufferGetInstanceCount, 1);
+    bindCFunctionToJs(particleSystemNew, 1);
+    bindCFunctionToJs(particleSystemDelete, 1);
+    bindCFunctionToJs(particleSystemDraw, 1);
+    bindCFunctionToJs(particleSystemReset, 1);
+    bindCFunctionToJs(particleSystemSetEmitRate, 2);
+    bindCFunctionToJs(particleSystemSetLifeTime, 3);
+    bindCFunctionToJs(particleSystemSetPosition, 4);
+    bindCFunctionToJs(particleSystemSetPositionRandomness, 4);
+    bindCFunctionToJs(particleSystemSetVelocity, 4);
+    bindCFunctionToJs(particleSystemSetVelocityRandomness, 4);
+    bindCFunctionToJs(particleSystemSetGravity, 4);
+    bindCFunctionToJs(particleSystemSetDrag, 2);
+    bindCFunctionToJs(particleSystemSetStartColor, 5);
+    bindCFunctionToJs(particleSystemSetEndColor, 5);
+    bindCFunctionToJs(particleSystemSetSize, 3);
+    bindCFunctionToJs(particleSystemSetTexture, 2);
 
     bindCFunctionToJs(perspective2dBegin, 2);
     bindCFunctionToJs(perspective2dEnd, 0);
@@ -3419,6 +4025,9 @@ void ScriptEngineDuktape::bindFunctions()
     bindCFunctionToJs(setTextSize, 3);
     bindCFunctionToJs(setTextDefaults, 0);
     bindCFunctionToJs(setTextFont, 1);
+    bindCFunctionToJs(setTextSdf, 1);
+    bindCFunctionToJs(setTextOutline, 5);
+    bindCFunctionToJs(setTextGlow, 5);
     bindCFunctionToJs(setTextPosition, 3);
     bindCFunctionToJs(setTextCenterAlignment, 1);
     bindCFunctionToJs(setDrawTextString, 1);
@@ -3454,7 +4063,9 @@ void ScriptEngineDuktape::bindFunctions()
     bindCFunctionToJs(setPerspective3d, 1);
 
     bindCFunctionToJs(loadObject, 1);
+    bindCFunctionToJs(loadObjectAsync, 2);
     bindCFunctionToJs(drawObject, DUK_VARARGS);
+    bindCFunctionToJs(drawObjectInstanced, 2);
     bindCFunctionToJs(setObjectScale, 4);
     bindCFunctionToJs(setObjectPosition, 4);
     bindCFunctionToJs(setObjectPivot, 4);
@@ -3477,6 +4088,8 @@ void ScriptEngineDuktape::bindFunctions()
 
     bindCFunctionToJs(lightSetPosition, 4);
     bindCFunctionToJs(lightSetDirection, 4);
+    bindCFunctionToJs(lightSetRange, 2);
+    bindCFunctionToJs(lightGetMaxCount, 0);
     bindCFunctionToJs(lightSetOn, 1);
     bindCFunctionToJs(lightSetOff, 1);
     bindCFunctionToJs(lightSetGenerateShadowMap, 2);
@@ -3493,6 +4106,7 @@ void ScriptEngineDuktape::bindFunctions()
     bindCFunctionToJs(videoSetFps, 2);
     bindCFunctionToJs(videoSetLoop, 2);
     bindCFunctionToJs(videoSetLength, 2);
+    bindCFunctionToJs(videoSetFrameCacheSize, 2);
     bindCFunctionToJs(videoPlay, 1);
     bindCFunctionToJs(videoDraw, 1);
 
@@ -3515,9 +4129,22 @@ void ScriptEngineDuktape::bindFunctions()
     bindCFunctionToJs(setTextureColor, 5);
     bindCFunctionToJs(drawTexture, 1);
 
-    bindCFunctionToJs(fboInit, 1);
+    bindCFunctionToJs(fboInit, 4);
     bindCFunctionToJs(fboBind, DUK_VARARGS);
-    bindCFunctionToJs(fboUnbind, 1);
+    bindCFunctionToJs(fboUnbind, DUK_VARARGS);
+    bindCFunctionToJs(fboRelease, 1);
+    bindCFunctionToJs(fboSetUpdateInterval, 2);
+    bindCFunctionToJs(fboIsUpdateNeeded, 2);
+    bindCFunctionToJs(fboSetUpdated, 2);
+    bindCFunctionToJs(fboInvalidate, 1);
+    bindCFunctionToJs(renderGraphClear, 0);
+    bindCFunctionToJs(renderGraphAddPass, 2);
+    bindCFunctionToJs(renderGraphAddInput, 2);
+    bindCFunctionToJs(renderGraphCompile, 0);
+    bindCFunctionToJs(renderQueueBegin, 0);
+    bindCFunctionToJs(renderQueueEnd, 0);
+    bindCFunctionToJs(renderQueueFlush, 0);
+    bindCFunctionToJs(renderQueueSetTransparent, 1);
     //bindCFunctionToJs(fboDeinit, 1);
     //bindCFunctionToJs(fboStoreDepth, 2);
     //bindCFunctionToJs(fboSetDimensions, 3);
@@ -55,6 +55,10 @@ bool WindowSdl::open() {
     setOpenGlAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
     setOpenGlAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, Settings::demo.graphics.requestedMajorVersion);
     setOpenGlAttribute(SDL_GL_CONTEXT_MINOR_VERSION, Settings::demo.graphics.requestedMinorVersion);
+#ifdef ENGINE_GL_DEBUG_OUTPUT
+    // drivers are not required to report errors through KHR_debug without a debug context
+    setOpenGlAttribute(SDL_GL_CONTEXT_FLAGS, SDL_GL_CONTEXT_DEBUG_FLAG);
+#endif
     //setOpenGlAttribute(SDL_GL_SHARE_WITH_CURRENT_CONTEXT, windows > 1 ? 1 : 0);
 
     // Settings